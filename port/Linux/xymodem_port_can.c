@@ -0,0 +1,638 @@
+/**
+ *******************************************************************************************************************************************
+ * @file        xymodem_port_can.c
+ * @brief       X / Y modem transport protocol port [Linux SocketCAN / CAN FD, ISO-TP(ISO 15765-2) segmentation]
+ * @since       Change Logs:
+ * Date         Author       Notes
+ * 2026-10-18   lzh          the first version
+ * @copyright (c) 2023 lzh <lzhoran@163.com>
+ *                https://github.com/ZeHHHHH/Flexible-XYmodem.git
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *******************************************************************************************************************************************
+ */
+#define _DEFAULT_SOURCE
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <net/if.h>
+#include <sys/socket.h>
+#include <linux/can.h>
+#include <linux/can/raw.h>
+#include "xymodem_port_can.h"
+
+/*******************************************************************************************************************************************
+ * Private Define
+ *******************************************************************************************************************************************/
+#define CAN_MSG_MAX             (4095) /* max ISO-TP message(12 bits length) / Bytes, > 2 max X/Y modem frames */
+#define CAN_RX_BUFF_SIZE        (8192) /* reassembled messages / Bytes, >= 2 max messages */
+#define CAN_FC_TIMEOUT_MS       (1000) /* N_Bs: wait for the Flow Control of the receiver / ms */
+#define CAN_FC_WAIT_MAX         (16)   /* Flow Control WAIT accepted in a row */
+#define CAN_FC_BS               (0)    /* block size asked of the sender, 0: no more Flow Control in the message */
+#define CAN_FC_STMIN            (0)    /* separation time asked of the sender, 0: back to back */
+#define CAN_BUSY_US             (100)  /* retry period while the queue of the interface is full / us */
+#define CAN_PAD                 (0xCC) /* padding of the frames up to a valid length */
+
+/* ISO-TP protocol control information */
+#define PCI_SF                  (0x00) /* Single Frame */
+#define PCI_FF                  (0x10) /* First Frame */
+#define PCI_CF                  (0x20) /* Consecutive Frame */
+#define PCI_FC                  (0x30) /* Flow Control */
+#define FC_CTS                  (0)    /* continue to send */
+#define FC_WAIT                 (1)    /* wait for the next Flow Control */
+#define FC_OVFLW                (2)    /* overflow, the message is refused */
+#define FC_NONE                 (0xFF) /* no Flow Control received */
+
+/*******************************************************************************************************************************************
+ * Private Variable
+ *******************************************************************************************************************************************/
+static int can_sock = -1;              /* CAN_RAW socket */
+static uint8_t can_fdf = 0;            /* frame format : 0-classic CAN; 1-CAN FD */
+static canid_t can_tx_id = 0;          /* CAN ID of the sent frames, with CAN_EFF_FLAG */
+static canid_t can_rx_id = 0;          /* CAN ID of the received frames, with CAN_EFF_FLAG */
+static int abort_pipe[2] = {-1, -1};   /* self-pipe of [xymodem_port_can_abort] */
+static uint8_t rx_buff[CAN_RX_BUFF_SIZE];
+static uint32_t rx_head = 0;           /* next Bytes to take */
+static uint32_t rx_tail = 0;           /* end of the complete messages */
+static uint32_t rx_msg_len = 0;        /* length of the message being reassembled at [rx_tail], 0: none */
+static uint32_t rx_msg_got = 0;        /* Bytes of the message being reassembled */
+static uint8_t rx_sn = 0;              /* next sequence number expected */
+static uint8_t tx_buff[CAN_MSG_MAX];
+static uint32_t tx_len = 0;            /* gathered data, sent as one message before the next receive */
+static uint8_t fc_sta = FC_NONE;       /* Flow Control received : FC_CTS / FC_WAIT / FC_OVFLW / FC_NONE */
+static uint8_t fc_bs = 0;              /* block size of the Flow Control */
+static uint8_t fc_st = 0;              /* separation time of the Flow Control */
+
+/*******************************************************************************************************************************************
+ * Private Function
+ *******************************************************************************************************************************************/
+/**
+ * @brief  wait for the socket or the abort request
+ * @param  events : POLLIN / POLLOUT
+ * @param  tick   : timeout / tick
+ * @retval enum xym_sta
+ */
+static xym_sta_t can_wait(const short events, const uint32_t tick)
+{
+    struct pollfd pfd[2] = {{can_sock, events, 0}, {abort_pipe[0], POLLIN, 0}};
+    uint8_t drain[16];
+    int res = 0;
+
+    do
+    {
+        res = poll(pfd, (events == POLLIN) ? 2 : 1, (int)tick);
+    } while (res < 0 && errno == EINTR);
+    if (res < 0)
+    {
+        return XYM_ERROR_HW;
+    }
+    if (res == 0)
+    {
+        return XYM_ERROR_TIMEOUT;
+    }
+    if (events == POLLIN && (pfd[1].revents & POLLIN) != 0)
+    {
+        while (read(abort_pipe[0], drain, sizeof(drain)) > 0)
+        {
+        }
+        return XYM_CANCEL_ACTIVE;
+    }
+    return ((pfd[0].revents & (POLLERR | POLLNVAL)) != 0) ? XYM_ERROR_HW : XYM_OK;
+}
+
+/* sleep / us */
+static void can_delay(const uint32_t us)
+{
+    struct timespec ts = {(time_t)(us / 1000000u), (long)(us % 1000000u) * 1000};
+    while (nanosleep(&ts, &ts) != 0 && errno == EINTR)
+    {
+    }
+}
+
+/* separation time of a Flow Control => us (reserved values: the max 127 ms) */
+static uint32_t can_stmin_us(const uint8_t st)
+{
+    if (st <= 0x7F)
+    {
+        return (uint32_t)st * 1000u;
+    }
+    return (st >= 0xF1 && st <= 0xF9) ? (uint32_t)(st - 0xF0) * 100u : 127000u;
+}
+
+/* frame length >= [n] allowed by the format: classic CAN 8, CAN FD 8, 12, 16, 20, 24, 32, 48, 64 */
+static uint8_t can_frame_len(const uint32_t n)
+{
+    static const uint8_t len[] = {8, 12, 16, 20, 24, 32, 48, 64};
+    uint8_t i = 0;
+
+    while (i < sizeof(len) - 1 && len[i] < n)
+    {
+        ++i;
+    }
+    return len[i];
+}
+
+/**
+ * @brief  write one frame: PCI, data, padding
+ * @param  pci     : protocol control information
+ * @param  pci_len : PCI size / Bytes
+ * @param  data    : data
+ * @param  cnt     : data size / Bytes
+ * @param  tick    : timeout while the queue of the interface is full / tick
+ * @retval enum xym_sta
+ */
+static xym_sta_t can_put_frame(const uint8_t *pci, const uint8_t pci_len, const uint8_t *data, const uint32_t cnt, const uint32_t tick)
+{
+    const size_t mtu = (can_fdf != 0) ? CANFD_MTU : CAN_MTU;
+    struct canfd_frame f;
+    xym_sta_t res = XYM_OK;
+    uint32_t busy = 0;
+    ssize_t n = 0;
+
+    memset(&f, 0, sizeof(f));
+    f.can_id = can_tx_id;
+    f.len = can_frame_len(pci_len + cnt);
+    f.flags = (can_fdf != 0) ? CANFD_BRS : 0;
+    memcpy(f.data, pci, pci_len);
+    memcpy(&f.data[pci_len], data, cnt);
+    memset(&f.data[pci_len + cnt], CAN_PAD, f.len - pci_len - cnt);
+    for (;;)
+    {
+        if ((n = write(can_sock, &f, mtu)) == (ssize_t)mtu)
+        {
+            return XYM_OK;
+        }
+        if (n < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (n < 0 && errno == EAGAIN)
+        {
+            if ((res = can_wait(POLLOUT, tick)) != XYM_OK)
+            {
+                return res;
+            }
+            continue;
+        }
+        /* the queue of the interface is full(txqueuelen): the bus is saturated, retry until it drains */
+        if (n < 0 && errno == ENOBUFS && busy * CAN_BUSY_US < tick * 1000u)
+        {
+            can_delay(CAN_BUSY_US);
+            ++busy;
+            continue;
+        }
+        return (n < 0 && errno == ENOBUFS) ? XYM_ERROR_TIMEOUT : XYM_ERROR_HW;
+    }
+}
+
+/* answer a First Frame */
+static void can_flow(const uint8_t sta)
+{
+    const uint8_t pci[3] = {(uint8_t)(PCI_FC | sta), CAN_FC_BS, CAN_FC_STMIN};
+    (void)can_put_frame(pci, 1, &pci[1], 2, CAN_FC_TIMEOUT_MS);
+}
+
+/* room for a new message of [len] Bytes at [rx_tail] */
+static int can_rx_room(const uint32_t len)
+{
+    if (rx_head == rx_tail)
+    {
+        rx_head = rx_tail = 0;
+    }
+    else if (rx_tail + len > CAN_RX_BUFF_SIZE && rx_head > 0)
+    {
+        memmove(rx_buff, &rx_buff[rx_head], rx_tail - rx_head);
+        rx_tail -= rx_head;
+        rx_head = 0;
+    }
+    return (rx_tail + len <= CAN_RX_BUFF_SIZE);
+}
+
+/**
+ * @brief  reassemble a received frame
+ * @param  f : frame
+ * @retval \
+ * @note   A lost or invalid frame drops the message being reassembled, the X/Y modem timeout and retry recover it
+ */
+static void can_input(const struct canfd_frame *f)
+{
+    const uint8_t *d = f->data;
+    uint32_t len = 0, off = 1;
+
+    if (f->len < 1)
+    {
+        return;
+    }
+    switch (d[0] & 0xF0)
+    {
+    case PCI_SF:
+        len = d[0] & 0x0F;
+        if (len == 0 && f->len > 8)
+        {
+            len = d[1]; /* CAN FD escape: length in the second Bytes */
+            off = 2;
+        }
+        rx_msg_len = 0; /* a new message ends the one being reassembled */
+        if (len > 0 && off + len <= f->len && can_rx_room(len))
+        {
+            memcpy(&rx_buff[rx_tail], &d[off], len);
+            rx_tail += len;
+        }
+        break;
+    case PCI_FF:
+        len = ((uint32_t)(d[0] & 0x0F) << 8) | d[1];
+        rx_msg_len = 0;
+        if (f->len < 8 || len <= f->len - 2u || !can_rx_room(len))
+        {
+            can_flow(FC_OVFLW); /* also a 32 bits length(> 4095 Bytes) */
+            break;
+        }
+        rx_msg_len = len;
+        rx_msg_got = f->len - 2u;
+        rx_sn = 1;
+        memcpy(&rx_buff[rx_tail], &d[2], rx_msg_got);
+        can_flow(FC_CTS);
+        break;
+    case PCI_CF:
+        if (rx_msg_len == 0)
+        {
+            break;
+        }
+        if ((d[0] & 0x0F) != rx_sn)
+        {
+            rx_msg_len = 0;
+            break;
+        }
+        rx_sn = (rx_sn + 1) & 0x0F;
+        len = (f->len - 1u < rx_msg_len - rx_msg_got) ? f->len - 1u : rx_msg_len - rx_msg_got;
+        memcpy(&rx_buff[rx_tail + rx_msg_got], &d[1], len);
+        rx_msg_got += len;
+        if (rx_msg_got == rx_msg_len)
+        {
+            rx_tail += rx_msg_len;
+            rx_msg_len = 0;
+        }
+        break;
+    case PCI_FC:
+        if (f->len >= 3)
+        {
+            fc_sta = d[0] & 0x0F;
+            fc_bs = d[1];
+            fc_st = d[2];
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+/**
+ * @brief  receive the frames that have arrived
+ * @param  tick : wait for the first frame / tick
+ * @retval enum xym_sta
+ */
+static xym_sta_t can_fill(const uint32_t tick)
+{
+    struct canfd_frame f;
+    xym_sta_t res = XYM_OK;
+    uint32_t cnt = 0;
+    ssize_t n = 0;
+
+    if ((res = can_wait(POLLIN, tick)) != XYM_OK)
+    {
+        return res;
+    }
+    while ((n = read(can_sock, &f, sizeof(f))) > 0 || (n < 0 && errno == EINTR))
+    {
+        if (n >= (ssize_t)CAN_MTU && f.can_id == can_rx_id)
+        {
+            can_input(&f);
+        }
+        cnt += (n > 0) ? 1 : 0;
+    }
+    /* an error after some frames: they are delivered first, the error comes again on the next call */
+    return ((n < 0 && errno == EAGAIN) || cnt > 0) ? XYM_OK : XYM_ERROR_HW;
+}
+
+/**
+ * @brief  wait for the Flow Control of the receiver
+ * @param  left : returned frames allowed before the next Flow Control
+ * @param  st   : returned separation time / us
+ * @retval enum xym_sta
+ */
+static xym_sta_t can_wait_flow(uint32_t *left, uint32_t *st)
+{
+    xym_sta_t res = XYM_OK;
+    uint8_t wait = 0;
+
+    for (;;)
+    {
+        while (fc_sta == FC_NONE)
+        {
+            if ((res = can_fill(CAN_FC_TIMEOUT_MS)) != XYM_OK)
+            {
+                return res;
+            }
+        }
+        if (fc_sta == FC_CTS)
+        {
+            fc_sta = FC_NONE;
+            *left = (fc_bs > 0) ? fc_bs : UINT32_MAX;
+            *st = can_stmin_us(fc_st);
+            return XYM_OK;
+        }
+        if (fc_sta != FC_WAIT || ++wait >= CAN_FC_WAIT_MAX)
+        {
+            fc_sta = FC_NONE;
+            return XYM_ERROR_HW; /* overflow or reserved: refused by the receiver */
+        }
+        fc_sta = FC_NONE;
+    }
+}
+
+/**
+ * @brief  send the gathered data as one message
+ * @param  tick : timeout while the queue of the interface is full / tick
+ * @retval enum xym_sta
+ */
+static xym_sta_t can_flush(const uint32_t tick)
+{
+    const uint32_t sf = (can_fdf != 0) ? 62 : 7, ff = (can_fdf != 0) ? 62 : 6, cf = (can_fdf != 0) ? 63 : 7;
+    const uint32_t len = tx_len;
+    xym_sta_t res = XYM_OK;
+    uint32_t i = 0, n = 0, left = 0, st = 0;
+    uint8_t pci[2], sn = 1;
+
+    tx_len = 0;
+    if (len == 0)
+    {
+        return XYM_OK;
+    }
+    if (len <= sf)
+    {
+        pci[0] = (len <= 7) ? (uint8_t)(PCI_SF | len) : PCI_SF;
+        pci[1] = (uint8_t)len;
+        return can_put_frame(pci, (len <= 7) ? 1 : 2, tx_buff, len, tick);
+    }
+    pci[0] = (uint8_t)(PCI_FF | (len >> 8));
+    pci[1] = (uint8_t)len;
+    fc_sta = FC_NONE;
+    if ((res = can_put_frame(pci, 2, tx_buff, ff, tick)) != XYM_OK)
+    {
+        return res;
+    }
+    for (i = ff; i < len; i += n)
+    {
+        if (left == 0 && (res = can_wait_flow(&left, &st)) != XYM_OK)
+        {
+            return res;
+        }
+        if (st > 0)
+        {
+            can_delay(st);
+        }
+        n = (len - i < cf) ? len - i : cf;
+        pci[0] = (uint8_t)(PCI_CF | sn);
+        sn = (sn + 1) & 0x0F;
+        if ((res = can_put_frame(pci, 1, &tx_buff[i], n, tick)) != XYM_OK)
+        {
+            return res;
+        }
+        --left;
+    }
+    return XYM_OK;
+}
+
+/**
+ * @brief  gather data into the message
+ * @param  data : data
+ * @param  cnt  : data size / Bytes
+ * @param  tick : send 1 Bytes timeout / tick, when the message is full
+ * @retval enum xym_sta
+ */
+static xym_sta_t can_put(const uint8_t *data, const uint32_t cnt, const uint32_t tick)
+{
+    xym_sta_t res = XYM_OK;
+    uint32_t i = 0, n = 0;
+
+    for (i = 0; i < cnt; i += n)
+    {
+        if (tx_len == CAN_MSG_MAX && (res = can_flush(tick)) != XYM_OK)
+        {
+            return res;
+        }
+        n = (cnt - i < CAN_MSG_MAX - tx_len) ? cnt - i : CAN_MSG_MAX - tx_len;
+        memcpy(&tx_buff[tx_len], &data[i], n);
+        tx_len += n;
+    }
+    return XYM_OK;
+}
+
+/**
+ * @brief  create the self-pipe of [xymodem_port_can_abort], drop the requests left by the last session
+ * @param  \
+ * @retval enum xym_sta
+ */
+static xym_sta_t can_abort_init(void)
+{
+    uint8_t drain[16];
+
+    if (abort_pipe[0] < 0)
+    {
+        if (pipe(abort_pipe) != 0)
+        {
+            return XYM_ERROR_HW;
+        }
+        fcntl(abort_pipe[0], F_SETFL, O_NONBLOCK);
+        fcntl(abort_pipe[1], F_SETFL, O_NONBLOCK);
+    }
+    /* an abort after the last blocked receive would end the new session at once */
+    while (read(abort_pipe[0], drain, sizeof(drain)) > 0)
+    {
+    }
+    return XYM_OK;
+}
+
+/*******************************************************************************************************************************************
+ * Public Function
+ *******************************************************************************************************************************************/
+/**
+ * @brief  open a CAN interface
+ * @param  ifname : interface, eg: "can0", "vcan0"
+ * @param  tx_id  : CAN ID of the sent frames, > 0x7FF: 29 bits extended ID
+ * @param  rx_id  : CAN ID of the received frames, > 0x7FF: 29 bits extended ID
+ * @param  fd     : frame format : 0-classic CAN(8 Bytes); 1-CAN FD(64 Bytes, bit rate switch)
+ * @retval enum xym_sta
+ */
+xym_sta_t xymodem_port_can_open(const char *ifname, const uint32_t tx_id, const uint32_t rx_id, const uint8_t fd)
+{
+    struct sockaddr_can addr;
+    struct can_filter filter;
+    const int on = 1;
+    int sock = -1;
+
+    if (tx_id > CAN_EFF_MASK || rx_id > CAN_EFF_MASK)
+    {
+        return XYM_ERROR_INVALID_DATA;
+    }
+    memset(&addr, 0, sizeof(addr));
+    addr.can_family = AF_CAN;
+    addr.can_ifindex = (int)if_nametoindex(ifname);
+    if (addr.can_ifindex == 0 || can_abort_init() != XYM_OK)
+    {
+        return XYM_ERROR_HW;
+    }
+    if ((sock = socket(PF_CAN, SOCK_RAW | SOCK_CLOEXEC, CAN_RAW)) < 0)
+    {
+        return XYM_ERROR_HW;
+    }
+    can_tx_id = (tx_id > CAN_SFF_MASK) ? (tx_id | CAN_EFF_FLAG) : tx_id;
+    can_rx_id = (rx_id > CAN_SFF_MASK) ? (rx_id | CAN_EFF_FLAG) : rx_id;
+    /* only the frames of the peer reach the socket, the rest of the bus traffic stays in the kernel */
+    filter.can_id = can_rx_id;
+    filter.can_mask = CAN_EFF_FLAG | CAN_RTR_FLAG | ((rx_id > CAN_SFF_MASK) ? CAN_EFF_MASK : CAN_SFF_MASK);
+    if (setsockopt(sock, SOL_CAN_RAW, CAN_RAW_FILTER, &filter, sizeof(filter)) != 0 ||
+        (fd != 0 && setsockopt(sock, SOL_CAN_RAW, CAN_RAW_FD_FRAMES, &on, sizeof(on)) != 0) ||
+        bind(sock, (struct sockaddr *)&addr, sizeof(addr)) != 0)
+    {
+        close(sock);
+        return XYM_ERROR_HW;
+    }
+    fcntl(sock, F_SETFL, O_NONBLOCK);
+
+    can_sock = sock;
+    can_fdf = (fd != 0) ? 1 : 0;
+    rx_head = rx_tail = rx_msg_len = tx_len = 0;
+    fc_sta = FC_NONE;
+    return XYM_OK;
+}
+
+/**
+ * @brief  flush the pending data and close the interface
+ * @param  \
+ * @retval \
+ */
+void xymodem_port_can_close(void)
+{
+    if (can_sock >= 0)
+    {
+        (void)can_flush(CAN_FC_TIMEOUT_MS); /* the last CAN / ACK */
+        close(can_sock);
+    }
+    can_sock = -1;
+    rx_head = rx_tail = rx_msg_len = tx_len = 0;
+}
+
+/**
+ * @brief  send data within the set time
+ * @param  data  : data
+ * @param  cnt   : data size / Bytes
+ * @param  tick  : send 1 Bytes timeout / tick
+ * @retval enum xym_sta
+ * @note   Gathered until the next receive: a frame sent in parts still leaves as one ISO-TP message
+ */
+xym_sta_t xymodem_port_can_send(const uint8_t *data, const uint32_t cnt, const uint32_t tick)
+{
+    return can_put(data, cnt, tick);
+}
+
+/**
+ * @brief  receive data within the set time
+ * @param  data  : data
+ * @param  cnt   : data size / Bytes
+ * @param  tick  : receive 1 Bytes timeout / tick
+ * @retval enum xym_sta
+ */
+xym_sta_t xymodem_port_can_recv(uint8_t *data, const uint32_t cnt, const uint32_t tick)
+{
+    xym_sta_t res = XYM_OK;
+    uint32_t i = 0, got = 0;
+
+    for (i = 0; i < cnt; i += got)
+    {
+        if ((res = xymodem_port_can_read(&data[i], cnt - i, &got, tick)) != XYM_OK)
+        {
+            return res;
+        }
+    }
+    return XYM_OK;
+}
+
+/**
+ * @brief  receive up to [cnt] data, return as soon as at least 1 Byte is received
+ * @param  data  : data
+ * @param  cnt   : max data size / Bytes
+ * @param  got   : received data size / Bytes
+ * @param  tick  : receive the first Bytes timeout / tick
+ * @retval enum xym_sta
+ */
+xym_sta_t xymodem_port_can_read(uint8_t *data, const uint32_t cnt, uint32_t *got, const uint32_t tick)
+{
+    xym_sta_t res = XYM_OK;
+    uint32_t n = 0;
+
+    *got = 0;
+    /* a reply is only waited for after the whole frame: it leaves now as one message */
+    if (tx_len > 0 && (res = can_flush((tick > 0) ? tick : 1)) != XYM_OK)
+    {
+        return res;
+    }
+    while (rx_head == rx_tail)
+    {
+        if ((res = can_fill(tick)) != XYM_OK)
+        {
+            return res;
+        }
+    }
+    n = rx_tail - rx_head;
+    n = (n < cnt) ? n : cnt;
+    memcpy(data, &rx_buff[rx_head], n);
+    rx_head += n;
+    *got = n;
+    return XYM_OK;
+}
+
+/**
+ * @brief  wake up the blocked receive(async-signal-safe)
+ * @param  \
+ * @retval \
+ */
+void xymodem_port_can_abort(void)
+{
+    const uint8_t msg = 0;
+    if (abort_pipe[1] >= 0)
+    {
+        (void)!write(abort_pipe[1], &msg, 1);
+    }
+}
+
+/**
+ * @brief  hand data to the interface, best-effort within the deadline
+ * @param  data  : data
+ * @param  cnt   : data size / Bytes
+ * @param  tick  : deadline of the whole data / tick
+ * @retval enum xym_sta
+ * @note   Blocks up to [tick] for the frame queue, and up to CAN_FC_TIMEOUT_MS for the Flow Control of a sequence
+ *         longer than a Single Frame; does not wait for a reply
+ */
+xym_sta_t xymodem_port_can_post(const uint8_t *data, const uint32_t cnt, const uint32_t tick)
+{
+    xym_sta_t res = can_put(data, cnt, tick);
+
+    /* a teardown sequence is short: a Single Frame or a few frames after the Flow Control */
+    return (res == XYM_OK) ? can_flush(tick) : res;
+}
@@ -0,0 +1,104 @@
+/**
+ *******************************************************************************************************************************************
+ * @file        xymodem_port_can.h
+ * @brief       X / Y modem transport protocol port [Linux SocketCAN / CAN FD, ISO-TP(ISO 15765-2) segmentation]
+ * @since       Change Logs:
+ * Date         Author       Notes
+ * 2026-10-18   lzh          the first version
+ * @copyright (c) 2023 lzh <lzhoran@163.com>
+ *                https://github.com/ZeHHHHH/Flexible-XYmodem.git
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *******************************************************************************************************************************************
+ */
+#ifndef __XYMODEM_PORT_CAN_H__
+#define __XYMODEM_PORT_CAN_H__
+
+#include "xymodem.h"
+
+/* Note: 1 tick == 1 ms, one link per process (same as the MCU ports) */
+
+/*
+ * The data gathered between two receives is one ISO-TP message(<= 4095 Bytes):
+ *   Single Frame      [0x0L] data                 classic CAN, L <= 7
+ *                     [0x00] [L] data             CAN FD, L <= 62
+ *   First Frame       [0x1L L] data               L: 12 bits message length
+ *   Consecutive Frame [0x2N] data                 N: sequence number 1, 2 ... 15, 0, 1 ...
+ *   Flow Control      [0x3S] [BS] [STmin]         S: 0-continue; 1-wait; 2-overflow
+ * The receiver answers the First Frame with BS = 0 and STmin = 0: the whole message then goes back to back on the bus.
+ */
+
+/**
+ * @brief  open a CAN interface
+ * @param  ifname : interface, eg: "can0", "vcan0"
+ * @param  tx_id  : CAN ID of the sent frames, > 0x7FF: 29 bits extended ID
+ * @param  rx_id  : CAN ID of the received frames, > 0x7FF: 29 bits extended ID
+ * @param  fd     : frame format : 0-classic CAN(8 Bytes); 1-CAN FD(64 Bytes, bit rate switch)
+ * @retval enum xym_sta
+ */
+xym_sta_t xymodem_port_can_open(const char *ifname, const uint32_t tx_id, const uint32_t rx_id, const uint8_t fd);
+
+/**
+ * @brief  flush the pending data and close the interface
+ * @param  \
+ * @retval \
+ */
+void xymodem_port_can_close(void);
+
+/**
+ * @brief  send data within the set time
+ * @param  data  : data
+ * @param  cnt   : data size / Bytes
+ * @param  tick  : send 1 Bytes timeout / tick
+ * @retval enum xym_sta
+ * @note   Gathered until the next receive: a frame sent in parts still leaves as one ISO-TP message
+ */
+xym_sta_t xymodem_port_can_send(const uint8_t *data, const uint32_t cnt, const uint32_t tick);
+
+/**
+ * @brief  receive data within the set time
+ * @param  data  : data
+ * @param  cnt   : data size / Bytes
+ * @param  tick  : receive 1 Bytes timeout / tick
+ * @retval enum xym_sta
+ */
+xym_sta_t xymodem_port_can_recv(uint8_t *data, const uint32_t cnt, const uint32_t tick);
+
+/**
+ * @brief  receive up to [cnt] data, return as soon as at least 1 Byte is received
+ * @param  data  : data
+ * @param  cnt   : max data size / Bytes
+ * @param  got   : received data size / Bytes
+ * @param  tick  : receive the first Bytes timeout / tick
+ * @retval enum xym_sta
+ */
+xym_sta_t xymodem_port_can_read(uint8_t *data, const uint32_t cnt, uint32_t *got, const uint32_t tick);
+
+/**
+ * @brief  wake up the blocked receive(async-signal-safe)
+ * @param  \
+ * @retval \
+ */
+void xymodem_port_can_abort(void);
+
+/**
+ * @brief  queue data on the interface and return without waiting for the reply
+ * @param  data  : data
+ * @param  cnt   : data size / Bytes
+ * @param  tick  : deadline of the whole data / tick
+ * @retval enum xym_sta
+ */
+xym_sta_t xymodem_port_can_post(const uint8_t *data, const uint32_t cnt, const uint32_t tick);
+
+#endif /* __XYMODEM_PORT_CAN_H__ */
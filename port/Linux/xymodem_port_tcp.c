@@ -0,0 +1,669 @@
+/**
+ *******************************************************************************************************************************************
+ * @file        xymodem_port_tcp.c
+ * @brief       X / Y modem transport protocol port [Linux TCP / RFC 2217 network serial]
+ * @since       Change Logs:
+ * Date         Author       Notes
+ * 2026-10-18   lzh          the first version
+ * @copyright (c) 2023 lzh <lzhoran@163.com>
+ *                https://github.com/ZeHHHHH/Flexible-XYmodem.git
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *******************************************************************************************************************************************
+ */
+#define _DEFAULT_SOURCE
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <poll.h>
+#include <string.h>
+#include <unistd.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include "xymodem_port_tcp.h"
+
+/*******************************************************************************************************************************************
+ * Private Define
+ *******************************************************************************************************************************************/
+#define TCP_RX_BUFF_SIZE        (4096) /* coalesced receive buffer / Bytes */
+#define TCP_TX_BUFF_SIZE        (4096) /* gathered send buffer / Bytes, > 2 max frames(IAC doubled) */
+#define TCP_NEGOTIATE_MS        (3000) /* RFC 2217 reply timeout / ms */
+#define TCP_LINGER_MS           (200)  /* wait for the last data of the server before close / ms */
+
+/* Telnet(RFC 854) commands and options */
+#define TN_SE                   (240)
+#define TN_SB                   (250)
+#define TN_WILL                 (251)
+#define TN_WONT                 (252)
+#define TN_DO                   (253)
+#define TN_DONT                 (254)
+#define TN_IAC                  (255)
+#define TN_OPT_BINARY           (0)
+#define TN_OPT_SGA              (3)
+#define TN_OPT_COMPORT          (44)   /* RFC 2217 COM-PORT-OPTION */
+
+/* RFC 2217 client commands, the server replies with the command + 100 */
+#define CPO_SET_BAUDRATE        (1)
+#define CPO_SET_DATASIZE        (2)
+#define CPO_SET_PARITY          (3)
+#define CPO_SET_STOPSIZE        (4)
+#define CPO_SET_CONTROL         (5)
+#define CPO_SERVER_BASE         (100)
+
+/* Telnet receive parser state */
+typedef enum tn_state
+{
+    TN_STATE_DATA = 0, /* data */
+    TN_STATE_CMD,      /* after IAC */
+    TN_STATE_OPT,      /* after IAC WILL / WONT / DO / DONT */
+    TN_STATE_SUB,      /* inside IAC SB ... */
+    TN_STATE_SUB_IAC,  /* IAC inside IAC SB ... */
+} tn_state_t;
+
+/*******************************************************************************************************************************************
+ * Private Variable
+ *******************************************************************************************************************************************/
+static int tcp_fd = -1;                /* socket */
+static uint8_t tcp_telnet = 0;         /* protocol : 0-raw TCP; 1-Telnet / RFC 2217 */
+static int abort_pipe[2] = {-1, -1};   /* self-pipe of [xymodem_port_tcp_abort] */
+static uint8_t rx_buff[TCP_RX_BUFF_SIZE];
+static uint32_t rx_head = 0;           /* next Bytes to take */
+static uint32_t rx_tail = 0;           /* end of the received data */
+static uint8_t tx_buff[TCP_TX_BUFF_SIZE];
+static uint32_t tx_len = 0;            /* gathered data, sent before the next receive */
+static tn_state_t tn_state = TN_STATE_DATA;
+static uint8_t tn_verb = 0;            /* WILL / WONT / DO / DONT being parsed */
+static uint8_t tn_sub[16];             /* subnegotiation being parsed */
+static uint8_t tn_sub_len = 0;
+static uint64_t tn_will = 0;           /* options enabled on this side, bit: option < 64 */
+static uint64_t tn_do = 0;             /* options enabled on the server side, bit: option < 64 */
+static uint8_t cpo_ack = 0;            /* bit n: reply of the COM-PORT-OPTION command n received */
+static uint8_t cpo_refused = 0;        /* COM-PORT-OPTION refused : 0-No; 1-Yes */
+
+/*******************************************************************************************************************************************
+ * Private Function
+ *******************************************************************************************************************************************/
+/**
+ * @brief  wait for the socket or the abort request
+ * @param  events : POLLIN / POLLOUT
+ * @param  tick   : timeout / tick
+ * @retval enum xym_sta
+ */
+static xym_sta_t tcp_wait(const short events, const uint32_t tick)
+{
+    struct pollfd pfd[2] = {{tcp_fd, events, 0}, {abort_pipe[0], POLLIN, 0}};
+    uint8_t drain[16];
+    int res = 0;
+
+    do
+    {
+        res = poll(pfd, (events == POLLIN) ? 2 : 1, (int)tick);
+    } while (res < 0 && errno == EINTR);
+    if (res < 0)
+    {
+        return XYM_ERROR_HW;
+    }
+    if (res == 0)
+    {
+        return XYM_ERROR_TIMEOUT;
+    }
+    if (events == POLLIN && (pfd[1].revents & POLLIN) != 0)
+    {
+        while (read(abort_pipe[0], drain, sizeof(drain)) > 0)
+        {
+        }
+        return XYM_CANCEL_ACTIVE;
+    }
+    return ((pfd[0].revents & (POLLERR | POLLNVAL)) != 0) ? XYM_ERROR_HW : XYM_OK;
+}
+
+/**
+ * @brief  send the gathered data in one write
+ * @param  tick : send 1 Bytes timeout / tick
+ * @retval enum xym_sta
+ */
+static xym_sta_t tcp_flush(const uint32_t tick)
+{
+    xym_sta_t res = XYM_OK;
+    ssize_t n = 0;
+    uint32_t i = 0;
+
+    for (i = 0; i < tx_len; i += n)
+    {
+        n = send(tcp_fd, &tx_buff[i], tx_len - i, MSG_NOSIGNAL);
+        if (n < 0)
+        {
+            n = 0;
+            if (errno == EAGAIN || errno == EINTR)
+            {
+                if ((res = tcp_wait(POLLOUT, tick)) == XYM_OK)
+                {
+                    continue;
+                }
+            }
+            tx_len = 0;
+            return (res != XYM_OK) ? res : XYM_ERROR_HW;
+        }
+    }
+    tx_len = 0;
+    return XYM_OK;
+}
+
+/**
+ * @brief  gather data, IAC doubled on a Telnet link
+ * @param  data : data
+ * @param  cnt  : data size / Bytes
+ * @param  tick : send 1 Bytes timeout / tick, when the buffer is full
+ * @retval enum xym_sta
+ */
+static xym_sta_t tcp_put(const uint8_t *data, const uint32_t cnt, const uint32_t tick)
+{
+    xym_sta_t res = XYM_OK;
+    uint32_t i = 0, n = 0;
+
+    for (i = 0; i < cnt; i += n)
+    {
+        if (tx_len + 2 > TCP_TX_BUFF_SIZE && (res = tcp_flush(tick)) != XYM_OK)
+        {
+            return res;
+        }
+        if (tcp_telnet == 0)
+        {
+            n = (cnt - i < TCP_TX_BUFF_SIZE - tx_len) ? cnt - i : TCP_TX_BUFF_SIZE - tx_len;
+            memcpy(&tx_buff[tx_len], &data[i], n);
+            tx_len += n;
+            continue;
+        }
+        n = 1;
+        tx_buff[tx_len++] = data[i];
+        if (data[i] == TN_IAC)
+        {
+            tx_buff[tx_len++] = TN_IAC;
+        }
+    }
+    return XYM_OK;
+}
+
+/**
+ * @brief  gather a Telnet command
+ * @param  verb : WILL / WONT / DO / DONT
+ * @param  opt  : option
+ * @retval \
+ */
+static void tcp_command(const uint8_t verb, const uint8_t opt)
+{
+    if (tx_len + 3 > TCP_TX_BUFF_SIZE)
+    {
+        (void)tcp_flush(TCP_NEGOTIATE_MS);
+    }
+    tx_buff[tx_len++] = TN_IAC;
+    tx_buff[tx_len++] = verb;
+    tx_buff[tx_len++] = opt;
+}
+
+/**
+ * @brief  gather a RFC 2217 COM-PORT-OPTION command
+ * @param  cmd   : command
+ * @param  value : value, MSB first
+ * @param  size  : value size / Bytes
+ * @retval \
+ */
+static void tcp_comport(const uint8_t cmd, const uint32_t value, const uint8_t size)
+{
+    uint8_t v[4];
+    uint8_t i = 0;
+
+    if (tx_len + 16 > TCP_TX_BUFF_SIZE)
+    {
+        (void)tcp_flush(TCP_NEGOTIATE_MS);
+    }
+    for (i = 0; i < size; ++i)
+    {
+        v[i] = (uint8_t)(value >> (8 * (size - 1 - i)));
+    }
+    tcp_command(TN_SB, TN_OPT_COMPORT);
+    tx_buff[tx_len++] = cmd;
+    (void)tcp_put(v, size, TCP_NEGOTIATE_MS);
+    tx_buff[tx_len++] = TN_IAC;
+    tx_buff[tx_len++] = TN_SE;
+}
+
+/**
+ * @brief  answer a Telnet option request of the server: BINARY and SGA both ways, COM-PORT-OPTION on this side only
+ * @param  verb : WILL / WONT / DO / DONT
+ * @param  opt  : option
+ * @retval \
+ */
+static void tcp_option(const uint8_t verb, const uint8_t opt)
+{
+    const uint64_t bit = (opt < 64) ? ((uint64_t)1 << opt) : 0;
+    const uint8_t ok = (opt == TN_OPT_BINARY || opt == TN_OPT_SGA || (opt == TN_OPT_COMPORT && verb >= TN_DO));
+
+    /* reply only on a change of state, an acknowledgement is never acknowledged(RFC 854) */
+    switch (verb)
+    {
+    case TN_DO:
+        if (ok == 0)
+        {
+            tcp_command(TN_WONT, opt);
+        }
+        else if ((tn_will & bit) == 0)
+        {
+            tn_will |= bit;
+            tcp_command(TN_WILL, opt);
+        }
+        break;
+    case TN_DONT:
+        cpo_refused = (opt == TN_OPT_COMPORT) ? 1 : cpo_refused;
+        if ((tn_will & bit) != 0)
+        {
+            tn_will &= ~bit;
+            tcp_command(TN_WONT, opt);
+        }
+        break;
+    case TN_WILL:
+        if (ok == 0)
+        {
+            tcp_command(TN_DONT, opt);
+        }
+        else if ((tn_do & bit) == 0)
+        {
+            tn_do |= bit;
+            tcp_command(TN_DO, opt);
+        }
+        break;
+    default: /* TN_WONT */
+        if ((tn_do & bit) != 0)
+        {
+            tn_do &= ~bit;
+            tcp_command(TN_DONT, opt);
+        }
+        break;
+    }
+}
+
+/**
+ * @brief  strip the Telnet commands in place
+ * @param  buf : received Bytes
+ * @param  cnt : received size / Bytes
+ * @retval data size / Bytes
+ */
+static uint32_t tcp_decode(uint8_t *buf, const uint32_t cnt)
+{
+    uint32_t i = 0, k = 0;
+    uint8_t c = 0;
+
+    for (i = 0; i < cnt; ++i)
+    {
+        c = buf[i];
+        switch (tn_state)
+        {
+        case TN_STATE_DATA:
+            if (c == TN_IAC)
+            {
+                tn_state = TN_STATE_CMD;
+            }
+            else
+            {
+                buf[k++] = c;
+            }
+            break;
+        case TN_STATE_CMD:
+            tn_verb = c;
+            tn_sub_len = 0;
+            tn_state = (c >= TN_WILL && c <= TN_DONT) ? TN_STATE_OPT : (c == TN_SB) ? TN_STATE_SUB : TN_STATE_DATA;
+            if (c == TN_IAC)
+            {
+                buf[k++] = c; /* escaped 0xFF */
+            }
+            break;
+        case TN_STATE_OPT:
+            tcp_option(tn_verb, c);
+            tn_state = TN_STATE_DATA;
+            break;
+        case TN_STATE_SUB:
+        case TN_STATE_SUB_IAC:
+            if (tn_state == TN_STATE_SUB && c == TN_IAC)
+            {
+                tn_state = TN_STATE_SUB_IAC;
+                break;
+            }
+            if (tn_state == TN_STATE_SUB_IAC && c != TN_IAC)
+            {
+                /* IAC SE: the reply of a COM-PORT-OPTION command, notifications(line / modem state) are ignored */
+                if (c == TN_SE && tn_sub_len >= 2 && tn_sub[0] == TN_OPT_COMPORT && tn_sub[1] > CPO_SERVER_BASE &&
+                    tn_sub[1] <= CPO_SERVER_BASE + CPO_SET_CONTROL)
+                {
+                    cpo_ack |= (uint8_t)(1u << (tn_sub[1] - CPO_SERVER_BASE));
+                }
+                tn_state = TN_STATE_DATA;
+                break;
+            }
+            if (tn_sub_len < sizeof(tn_sub))
+            {
+                tn_sub[tn_sub_len++] = c;
+            }
+            tn_state = TN_STATE_SUB;
+            break;
+        }
+    }
+    return k;
+}
+
+/**
+ * @brief  receive what has arrived into the receive buffer, one system call for all of it
+ * @param  tick : receive timeout / tick
+ * @retval enum xym_sta
+ */
+static xym_sta_t tcp_fill(const uint32_t tick)
+{
+    xym_sta_t res = XYM_OK;
+    ssize_t n = 0;
+
+    if (rx_head == rx_tail)
+    {
+        rx_head = rx_tail = 0;
+    }
+    do
+    {
+        if ((res = tcp_wait(POLLIN, tick)) != XYM_OK)
+        {
+            return res;
+        }
+        n = recv(tcp_fd, &rx_buff[rx_tail], TCP_RX_BUFF_SIZE - rx_tail, 0);
+    } while (n < 0 && (errno == EINTR || errno == EAGAIN));
+    if (n <= 0)
+    {
+        return XYM_ERROR_HW; /* closed by the server */
+    }
+#ifdef TCP_QUICKACK
+    /* cleared by the kernel after use: acknowledge the next frame at once, not after the delayed ACK timer */
+    setsockopt(tcp_fd, IPPROTO_TCP, TCP_QUICKACK, &(int){1}, sizeof(int));
+#endif
+    rx_tail += (tcp_telnet != 0) ? tcp_decode(&rx_buff[rx_tail], (uint32_t)n) : (uint32_t)n;
+    /* answers to the option requests of the server */
+    return (tx_len > 0) ? tcp_flush((tick > 0) ? tick : 1) : XYM_OK;
+}
+
+/**
+ * @brief  RFC 2217 negotiation: Telnet BINARY / SGA, then baudrate, data size, parity, stop size and flow control
+ * @param  baud : baudrate, 0: keep
+ * @param  mode : data bits, parity and stop bits, NULL: keep
+ * @param  flow : hardware flow control(RTS/CTS) : 0-disable; 1-enable
+ * @retval enum xym_sta
+ */
+static xym_sta_t tcp_negotiate(const uint32_t baud, const char *mode, const uint8_t flow)
+{
+    xym_sta_t res = XYM_OK;
+    uint8_t want = 1u << CPO_SET_CONTROL;
+
+    if (mode != NULL && (!(mode[0] >= '5' && mode[0] <= '8') || mode[1] == 0 || strchr("NnOoEe", mode[1]) == NULL ||
+                         !(mode[2] == '1' || mode[2] == '2')))
+    {
+        return XYM_ERROR_INVALID_DATA;
+    }
+    tn_will = tn_do = ((uint64_t)1 << TN_OPT_BINARY) | ((uint64_t)1 << TN_OPT_SGA);
+    tn_will |= (uint64_t)1 << TN_OPT_COMPORT;
+    tcp_command(TN_WILL, TN_OPT_BINARY);
+    tcp_command(TN_DO, TN_OPT_BINARY);
+    tcp_command(TN_WILL, TN_OPT_SGA);
+    tcp_command(TN_DO, TN_OPT_SGA);
+    tcp_command(TN_WILL, TN_OPT_COMPORT);
+    if (baud > 0)
+    {
+        tcp_comport(CPO_SET_BAUDRATE, baud, 4);
+        want |= 1u << CPO_SET_BAUDRATE;
+    }
+    if (mode != NULL)
+    {
+        tcp_comport(CPO_SET_DATASIZE, (uint32_t)(mode[0] - '0'), 1);
+        tcp_comport(CPO_SET_PARITY, (mode[1] == 'O' || mode[1] == 'o') ? 2 : (mode[1] == 'E' || mode[1] == 'e') ? 3 : 1, 1);
+        tcp_comport(CPO_SET_STOPSIZE, (uint32_t)(mode[2] - '0'), 1);
+        want |= (1u << CPO_SET_DATASIZE) | (1u << CPO_SET_PARITY) | (1u << CPO_SET_STOPSIZE);
+    }
+    tcp_comport(CPO_SET_CONTROL, (flow != 0) ? 3 : 1, 1);
+    if ((res = tcp_flush(TCP_NEGOTIATE_MS)) != XYM_OK)
+    {
+        return res;
+    }
+    while ((cpo_ack & want) != want)
+    {
+        if (cpo_refused != 0)
+        {
+            return XYM_ERROR_HW; /* not a RFC 2217 server */
+        }
+        /* the data of the device is kept(eg: the first 'C' of a receiver already running), unless it is a flood */
+        if (rx_tail == TCP_RX_BUFF_SIZE)
+        {
+            rx_head = rx_tail = 0;
+        }
+        if ((res = tcp_fill(TCP_NEGOTIATE_MS)) != XYM_OK)
+        {
+            return res;
+        }
+    }
+    return XYM_OK;
+}
+
+/**
+ * @brief  create the self-pipe of [xymodem_port_tcp_abort], drop the requests left by the last session
+ * @param  \
+ * @retval enum xym_sta
+ */
+static xym_sta_t tcp_abort_init(void)
+{
+    uint8_t drain[16];
+
+    if (abort_pipe[0] < 0)
+    {
+        if (pipe(abort_pipe) != 0)
+        {
+            return XYM_ERROR_HW;
+        }
+        fcntl(abort_pipe[0], F_SETFL, O_NONBLOCK);
+        fcntl(abort_pipe[1], F_SETFL, O_NONBLOCK);
+    }
+    /* an abort after the last blocked receive would end the new session at once */
+    while (read(abort_pipe[0], drain, sizeof(drain)) > 0)
+    {
+    }
+    return XYM_OK;
+}
+
+/*******************************************************************************************************************************************
+ * Public Function
+ *******************************************************************************************************************************************/
+/**
+ * @brief  connect to a terminal server(eg: ser2net) and configure the serial port behind it
+ * @param  host    : host name or address, eg: "192.168.1.10"
+ * @param  port    : TCP port, eg: "2217"
+ * @param  rfc2217 : protocol : 0-raw TCP; 1-Telnet with RFC 2217 COM-PORT-OPTION
+ * @param  baud    : baudrate, eg: 115200 (RFC 2217 only, 0: keep)
+ * @param  mode    : data bits, parity and stop bits, eg: "8N1" (RFC 2217 only, NULL: keep)
+ * @param  flow    : hardware flow control(RTS/CTS) : 0-disable; 1-enable (RFC 2217 only)
+ * @retval enum xym_sta
+ */
+xym_sta_t xymodem_port_tcp_open(const char *host, const char *port, const uint8_t rfc2217, const uint32_t baud, const char *mode,
+                                const uint8_t flow)
+{
+    struct addrinfo hints, *list = NULL, *ai = NULL;
+    xym_sta_t res = XYM_OK;
+    int fd = -1, on = 1;
+
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    if (getaddrinfo(host, port, &hints, &list) != 0)
+    {
+        return XYM_ERROR_HW;
+    }
+    for (ai = list; ai != NULL && fd < 0; ai = ai->ai_next)
+    {
+        fd = socket(ai->ai_family, ai->ai_socktype | SOCK_CLOEXEC, ai->ai_protocol);
+        if (fd >= 0 && connect(fd, ai->ai_addr, ai->ai_addrlen) != 0)
+        {
+            close(fd);
+            fd = -1;
+        }
+    }
+    freeaddrinfo(list);
+    if (fd < 0)
+    {
+        return XYM_ERROR_HW;
+    }
+    /* stop-and-wait: a frame or a reply leaves at once(no Nagle), the rest is left to [tcp_flush] and [tcp_fill] */
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+    fcntl(fd, F_SETFL, O_NONBLOCK);
+
+    tcp_fd = fd;
+    tcp_telnet = (rfc2217 != 0) ? 1 : 0;
+    rx_head = rx_tail = tx_len = 0;
+    tn_state = TN_STATE_DATA;
+    tn_will = tn_do = 0;
+    cpo_ack = cpo_refused = 0;
+    res = tcp_abort_init();
+    if (res == XYM_OK && rfc2217 != 0)
+    {
+        res = tcp_negotiate(baud, mode, flow);
+    }
+    if (res != XYM_OK)
+    {
+        close(fd);
+        tcp_fd = -1;
+    }
+    return res;
+}
+
+/**
+ * @brief  flush the pending data and close the connection
+ * @param  \
+ * @retval \
+ */
+void xymodem_port_tcp_close(void)
+{
+    uint8_t drain[256];
+
+    if (tcp_fd >= 0)
+    {
+        /* the last CAN / ACK goes out before the FIN, unread data at close() would reset the connection instead */
+        (void)tcp_flush(TCP_LINGER_MS);
+        shutdown(tcp_fd, SHUT_WR);
+        while (tcp_wait(POLLIN, TCP_LINGER_MS) == XYM_OK && recv(tcp_fd, drain, sizeof(drain), 0) > 0)
+        {
+        }
+        close(tcp_fd);
+    }
+    tcp_fd = -1;
+    rx_head = rx_tail = tx_len = 0;
+}
+
+/**
+ * @brief  send data within the set time
+ * @param  data  : data
+ * @param  cnt   : data size / Bytes
+ * @param  tick  : send 1 Bytes timeout / tick
+ * @retval enum xym_sta
+ * @note   Gathered until the next receive: a frame sent in parts still leaves in one segment
+ */
+xym_sta_t xymodem_port_tcp_send(const uint8_t *data, const uint32_t cnt, const uint32_t tick)
+{
+    return tcp_put(data, cnt, tick);
+}
+
+/**
+ * @brief  receive data within the set time
+ * @param  data  : data
+ * @param  cnt   : data size / Bytes
+ * @param  tick  : receive 1 Bytes timeout / tick
+ * @retval enum xym_sta
+ */
+xym_sta_t xymodem_port_tcp_recv(uint8_t *data, const uint32_t cnt, const uint32_t tick)
+{
+    xym_sta_t res = XYM_OK;
+    uint32_t i = 0, got = 0;
+
+    for (i = 0; i < cnt; i += got)
+    {
+        if ((res = xymodem_port_tcp_read(&data[i], cnt - i, &got, tick)) != XYM_OK)
+        {
+            return res;
+        }
+    }
+    return XYM_OK;
+}
+
+/**
+ * @brief  receive up to [cnt] data, return as soon as at least 1 Byte is received
+ * @param  data  : data
+ * @param  cnt   : max data size / Bytes
+ * @param  got   : received data size / Bytes
+ * @param  tick  : receive the first Bytes timeout / tick
+ * @retval enum xym_sta
+ */
+xym_sta_t xymodem_port_tcp_read(uint8_t *data, const uint32_t cnt, uint32_t *got, const uint32_t tick)
+{
+    xym_sta_t res = XYM_OK;
+    uint32_t n = 0;
+
+    *got = 0;
+    /* a reply is only waited for after the whole frame: it leaves now in one write */
+    if (tx_len > 0 && (res = tcp_flush((tick > 0) ? tick : 1)) != XYM_OK)
+    {
+        return res;
+    }
+    while (rx_head == rx_tail)
+    {
+        if ((res = tcp_fill(tick)) != XYM_OK)
+        {
+            return res;
+        }
+    }
+    n = rx_tail - rx_head;
+    n = (n < cnt) ? n : cnt;
+    memcpy(data, &rx_buff[rx_head], n);
+    rx_head += n;
+    *got = n;
+    return XYM_OK;
+}
+
+/**
+ * @brief  wake up the blocked receive(async-signal-safe)
+ * @param  \
+ * @retval \
+ */
+void xymodem_port_tcp_abort(void)
+{
+    const uint8_t msg = 0;
+    if (abort_pipe[1] >= 0)
+    {
+        (void)!write(abort_pipe[1], &msg, 1);
+    }
+}
+
+/**
+ * @brief  hand data to the socket, best-effort within the deadline
+ * @param  data  : data
+ * @param  cnt   : data size / Bytes
+ * @param  tick  : deadline of the whole data / tick
+ * @retval enum xym_sta
+ * @note   Blocks until the socket send buffer takes the data or [tick] expires, does not wait for the transmission
+ */
+xym_sta_t xymodem_port_tcp_post(const uint8_t *data, const uint32_t cnt, const uint32_t tick)
+{
+    xym_sta_t res = tcp_put(data, cnt, tick);
+
+    /* the socket send buffer normally takes a teardown sequence at once */
+    return (res == XYM_OK) ? tcp_flush(tick) : res;
+}
@@ -0,0 +1,97 @@
+/**
+ *******************************************************************************************************************************************
+ * @file        xymodem_port_tcp.h
+ * @brief       X / Y modem transport protocol port [Linux TCP / RFC 2217 network serial]
+ * @since       Change Logs:
+ * Date         Author       Notes
+ * 2026-10-18   lzh          the first version
+ * @copyright (c) 2023 lzh <lzhoran@163.com>
+ *                https://github.com/ZeHHHHH/Flexible-XYmodem.git
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *******************************************************************************************************************************************
+ */
+#ifndef __XYMODEM_PORT_TCP_H__
+#define __XYMODEM_PORT_TCP_H__
+
+#include "xymodem.h"
+
+/* Note: 1 tick == 1 ms, one link per process (same as the MCU ports) */
+
+/**
+ * @brief  connect to a terminal server(eg: ser2net) and configure the serial port behind it
+ * @param  host    : host name or address, eg: "192.168.1.10"
+ * @param  port    : TCP port, eg: "2217"
+ * @param  rfc2217 : protocol : 0-raw TCP; 1-Telnet with RFC 2217 COM-PORT-OPTION
+ * @param  baud    : baudrate, eg: 115200 (RFC 2217 only, 0: keep)
+ * @param  mode    : data bits, parity and stop bits, eg: "8N1" (RFC 2217 only, NULL: keep)
+ * @param  flow    : hardware flow control(RTS/CTS) : 0-disable; 1-enable (RFC 2217 only)
+ * @retval enum xym_sta
+ */
+xym_sta_t xymodem_port_tcp_open(const char *host, const char *port, const uint8_t rfc2217, const uint32_t baud, const char *mode,
+                                const uint8_t flow);
+
+/**
+ * @brief  flush the pending data and close the connection
+ * @param  \
+ * @retval \
+ */
+void xymodem_port_tcp_close(void);
+
+/**
+ * @brief  send data within the set time
+ * @param  data  : data
+ * @param  cnt   : data size / Bytes
+ * @param  tick  : send 1 Bytes timeout / tick
+ * @retval enum xym_sta
+ * @note   Gathered until the next receive: a frame sent in parts still leaves in one segment
+ */
+xym_sta_t xymodem_port_tcp_send(const uint8_t *data, const uint32_t cnt, const uint32_t tick);
+
+/**
+ * @brief  receive data within the set time
+ * @param  data  : data
+ * @param  cnt   : data size / Bytes
+ * @param  tick  : receive 1 Bytes timeout / tick
+ * @retval enum xym_sta
+ */
+xym_sta_t xymodem_port_tcp_recv(uint8_t *data, const uint32_t cnt, const uint32_t tick);
+
+/**
+ * @brief  receive up to [cnt] data, return as soon as at least 1 Byte is received
+ * @param  data  : data
+ * @param  cnt   : max data size / Bytes
+ * @param  got   : received data size / Bytes
+ * @param  tick  : receive the first Bytes timeout / tick
+ * @retval enum xym_sta
+ */
+xym_sta_t xymodem_port_tcp_read(uint8_t *data, const uint32_t cnt, uint32_t *got, const uint32_t tick);
+
+/**
+ * @brief  wake up the blocked receive(async-signal-safe)
+ * @param  \
+ * @retval \
+ */
+void xymodem_port_tcp_abort(void);
+
+/**
+ * @brief  queue data into the socket and return without waiting for the transmission
+ * @param  data  : data
+ * @param  cnt   : data size / Bytes
+ * @param  tick  : deadline of the whole data / tick
+ * @retval enum xym_sta
+ */
+xym_sta_t xymodem_port_tcp_post(const uint8_t *data, const uint32_t cnt, const uint32_t tick);
+
+#endif /* __XYMODEM_PORT_TCP_H__ */
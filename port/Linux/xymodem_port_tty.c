@@ -0,0 +1,393 @@
+/**
+ *******************************************************************************************************************************************
+ * @file        xymodem_port_tty.c
+ * @brief       X / Y modem transport protocol port [Linux tty / stdio]
+ * @since       Change Logs:
+ * Date         Author       Notes
+ * 2026-10-18   lzh          the first version
+ * 2026-10-18   lzh          add [xymodem_port_tty_read] for the read-ahead buffer
+ * @copyright (c) 2023 lzh <lzhoran@163.com>
+ *                https://github.com/ZeHHHHH/Flexible-XYmodem.git
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *******************************************************************************************************************************************
+ */
+#define _DEFAULT_SOURCE
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+#include "xymodem_port_tty.h"
+
+/*******************************************************************************************************************************************
+ * Private Variable
+ *******************************************************************************************************************************************/
+static int tty_rfd = -1;             /* receive file descriptor */
+static int tty_wfd = -1;             /* send file descriptor */
+static uint8_t tty_owned = 0;        /* opened by [xymodem_port_tty_open] : 0-No; 1-Yes */
+static uint8_t tty_restore = 0;      /* termios must be restored : 0-No; 1-Yes */
+static struct termios tty_saved;     /* termios before raw mode */
+static int abort_pipe[2] = {-1, -1}; /* self-pipe of [xymodem_port_tty_abort] */
+
+/* baudrate map */
+static const struct
+{
+    uint32_t baud;
+    speed_t speed;
+} baud_map[] = {
+    {1200, B1200}, {2400, B2400}, {4800, B4800}, {9600, B9600}, {19200, B19200}, {38400, B38400}, {57600, B57600},
+    {115200, B115200}, {230400, B230400}, {460800, B460800}, {500000, B500000}, {576000, B576000}, {921600, B921600},
+    {1000000, B1000000}, {1152000, B1152000}, {1500000, B1500000}, {2000000, B2000000}, {2500000, B2500000},
+    {3000000, B3000000}, {3500000, B3500000}, {4000000, B4000000},
+};
+
+/*******************************************************************************************************************************************
+ * Private Function
+ *******************************************************************************************************************************************/
+/**
+ * @brief  switch a tty to raw mode
+ * @param  fd   : file descriptor
+ * @param  baud : baudrate, 0: keep
+ * @param  mode : data bits, parity and stop bits, NULL: keep
+ * @param  flow : hardware flow control(RTS/CTS) : 0-disable; 1-enable
+ * @param  flush : discard the stale data : 0-No; 1-Yes
+ * @retval enum xym_sta
+ */
+static xym_sta_t tty_raw(const int fd, const uint32_t baud, const char *mode, const uint8_t flow, const uint8_t flush)
+{
+    struct termios tio;
+    uint32_t i = 0;
+
+    if (tcgetattr(fd, &tio) != 0)
+    {
+        return XYM_OK; /* not a tty(pipe / socket / file), nothing to configure */
+    }
+    tty_saved = tio;
+    tty_restore = 1;
+    cfmakeraw(&tio);
+    tio.c_cflag |= CLOCAL | CREAD;
+    tio.c_cc[VMIN] = 0;
+    tio.c_cc[VTIME] = 0;
+    if (baud > 0)
+    {
+        for (i = 0; i < sizeof(baud_map) / sizeof(baud_map[0]) && baud_map[i].baud != baud; ++i)
+        {
+        }
+        if (i >= sizeof(baud_map) / sizeof(baud_map[0]))
+        {
+            return XYM_ERROR_INVALID_DATA;
+        }
+        cfsetispeed(&tio, baud_map[i].speed);
+        cfsetospeed(&tio, baud_map[i].speed);
+    }
+    if (mode != NULL)
+    {
+        if (!(mode[0] >= '5' && mode[0] <= '8') || !(mode[2] == '1' || mode[2] == '2'))
+        {
+            return XYM_ERROR_INVALID_DATA;
+        }
+        tio.c_cflag &= ~(CSIZE | PARENB | PARODD | CSTOPB);
+        tio.c_cflag |= (mode[0] == '5') ? CS5 : (mode[0] == '6') ? CS6 : (mode[0] == '7') ? CS7 : CS8;
+        switch (mode[1])
+        {
+        case 'N': case 'n':
+            break;
+        case 'E': case 'e':
+            tio.c_cflag |= PARENB;
+            break;
+        case 'O': case 'o':
+            tio.c_cflag |= PARENB | PARODD;
+            break;
+        default:
+            return XYM_ERROR_INVALID_DATA;
+        }
+        tio.c_cflag |= (mode[2] == '2') ? CSTOPB : 0;
+    }
+    tio.c_cflag = (flow != 0) ? (tio.c_cflag | CRTSCTS) : (tio.c_cflag & ~CRTSCTS);
+    if (tcsetattr(fd, TCSANOW, &tio) != 0)
+    {
+        return XYM_ERROR_HW;
+    }
+    if (flush != 0)
+    {
+        tcflush(fd, TCIOFLUSH);
+    }
+    return XYM_OK;
+}
+
+/**
+ * @brief  wait for a file descriptor or the abort request
+ * @param  fd     : file descriptor
+ * @param  events : POLLIN / POLLOUT
+ * @param  tick   : timeout / tick
+ * @retval enum xym_sta
+ */
+static xym_sta_t tty_wait(const int fd, const short events, const uint32_t tick)
+{
+    struct pollfd pfd[2] = {{fd, events, 0}, {abort_pipe[0], POLLIN, 0}};
+    uint8_t drain[16];
+    int res = 0;
+
+    do
+    {
+        res = poll(pfd, (events == POLLIN) ? 2 : 1, (int)tick);
+    } while (res < 0 && errno == EINTR);
+    if (res < 0)
+    {
+        return XYM_ERROR_HW;
+    }
+    if (res == 0)
+    {
+        return XYM_ERROR_TIMEOUT;
+    }
+    if (events == POLLIN && (pfd[1].revents & POLLIN) != 0)
+    {
+        while (read(abort_pipe[0], drain, sizeof(drain)) > 0)
+        {
+        }
+        return XYM_CANCEL_ACTIVE;
+    }
+    return ((pfd[0].revents & (POLLERR | POLLNVAL)) != 0) ? XYM_ERROR_HW : XYM_OK;
+}
+
+/**
+ * @brief  create the self-pipe of [xymodem_port_tty_abort], drop the requests left by the last session
+ * @param  \
+ * @retval enum xym_sta
+ */
+static xym_sta_t tty_abort_init(void)
+{
+    uint8_t drain[16];
+
+    if (abort_pipe[0] < 0)
+    {
+        if (pipe(abort_pipe) != 0)
+        {
+            return XYM_ERROR_HW;
+        }
+        fcntl(abort_pipe[0], F_SETFL, O_NONBLOCK);
+        fcntl(abort_pipe[1], F_SETFL, O_NONBLOCK);
+    }
+    /* an abort after the last blocked receive would end the new session at once */
+    while (read(abort_pipe[0], drain, sizeof(drain)) > 0)
+    {
+    }
+    return XYM_OK;
+}
+
+/*******************************************************************************************************************************************
+ * Public Function
+ *******************************************************************************************************************************************/
+/**
+ * @brief  open and configure a serial device
+ * @param  dev  : device path, eg: "/dev/ttyUSB0"
+ * @param  baud : baudrate, eg: 115200
+ * @param  mode : data bits, parity and stop bits, eg: "8N1", "7E1", "8O2"
+ * @param  flow : hardware flow control(RTS/CTS) : 0-disable; 1-enable
+ * @retval enum xym_sta
+ */
+xym_sta_t xymodem_port_tty_open(const char *dev, const uint32_t baud, const char *mode, const uint8_t flow)
+{
+    xym_sta_t res = XYM_OK;
+    int fd = open(dev, O_RDWR | O_NOCTTY | O_CLOEXEC);
+
+    if (fd < 0)
+    {
+        return XYM_ERROR_HW;
+    }
+    res = tty_raw(fd, baud, mode, flow, 1);
+    if (res == XYM_OK)
+    {
+        res = tty_abort_init();
+    }
+    if (res != XYM_OK)
+    {
+        close(fd);
+        return res;
+    }
+    tty_rfd = tty_wfd = fd;
+    tty_owned = 1;
+    return XYM_OK;
+}
+
+/**
+ * @brief  use already opened file descriptors as the link(eg: stdin / stdout of a terminal program)
+ * @param  rfd : file descriptor to receive from
+ * @param  wfd : file descriptor to send to
+ * @retval enum xym_sta
+ * @note   A tty is switched to raw mode and restored by [xymodem_port_tty_close]
+ */
+xym_sta_t xymodem_port_tty_attach(const int rfd, const int wfd)
+{
+    xym_sta_t res = tty_raw(rfd, 0, NULL, 0, 0); /* the peer may have started already */
+
+    if (res != XYM_OK || (res = tty_abort_init()) != XYM_OK)
+    {
+        return res;
+    }
+    tty_rfd = rfd;
+    tty_wfd = wfd;
+    tty_owned = 0;
+    return XYM_OK;
+}
+
+/**
+ * @brief  restore and close the link
+ * @param  \
+ * @retval \
+ */
+void xymodem_port_tty_close(void)
+{
+    if (tty_rfd >= 0)
+    {
+        /* let the last CAN / ACK leave before restoring */
+        tcdrain(tty_wfd);
+        if (tty_restore != 0)
+        {
+            tcsetattr(tty_rfd, TCSANOW, &tty_saved);
+        }
+        if (tty_owned != 0)
+        {
+            close(tty_rfd);
+        }
+    }
+    tty_rfd = tty_wfd = -1;
+    tty_owned = tty_restore = 0;
+}
+
+/**
+ * @brief  send data within the set time
+ * @param  data  : data
+ * @param  cnt   : data size / Bytes
+ * @param  tick  : send 1 Bytes timeout / tick
+ * @retval enum xym_sta
+ */
+xym_sta_t xymodem_port_tty_send(const uint8_t *data, const uint32_t cnt, const uint32_t tick)
+{
+    xym_sta_t res = XYM_OK;
+    ssize_t n = 0;
+    uint32_t i = 0;
+
+    for (i = 0; i < cnt; i += n)
+    {
+        if ((res = tty_wait(tty_wfd, POLLOUT, tick)) != XYM_OK)
+        {
+            return res;
+        }
+        n = write(tty_wfd, &data[i], cnt - i);
+        if (n < 0)
+        {
+            if (errno == EINTR || errno == EAGAIN)
+            {
+                n = 0;
+                continue;
+            }
+            return XYM_ERROR_HW;
+        }
+    }
+    return XYM_OK;
+}
+
+/**
+ * @brief  receive data within the set time
+ * @param  data  : data
+ * @param  cnt   : data size / Bytes
+ * @param  tick  : receive 1 Bytes timeout / tick
+ * @retval enum xym_sta
+ */
+xym_sta_t xymodem_port_tty_recv(uint8_t *data, const uint32_t cnt, const uint32_t tick)
+{
+    xym_sta_t res = XYM_OK;
+    ssize_t n = 0;
+    uint32_t i = 0;
+
+    for (i = 0; i < cnt; i += n)
+    {
+        if ((res = tty_wait(tty_rfd, POLLIN, tick)) != XYM_OK)
+        {
+            return res;
+        }
+        n = read(tty_rfd, &data[i], cnt - i);
+        if (n <= 0)
+        {
+            if (n < 0 && (errno == EINTR || errno == EAGAIN))
+            {
+                n = 0;
+                continue;
+            }
+            return XYM_ERROR_HW; /* hang-up / EOF */
+        }
+    }
+    return XYM_OK;
+}
+
+/**
+ * @brief  receive up to [cnt] data, return as soon as at least 1 Byte is received
+ * @param  data  : data
+ * @param  cnt   : max data size / Bytes
+ * @param  got   : received data size / Bytes
+ * @param  tick  : receive the first Bytes timeout / tick
+ * @retval enum xym_sta
+ */
+xym_sta_t xymodem_port_tty_read(uint8_t *data, const uint32_t cnt, uint32_t *got, const uint32_t tick)
+{
+    xym_sta_t res = XYM_OK;
+    ssize_t n = 0;
+
+    *got = 0;
+    do
+    {
+        if ((res = tty_wait(tty_rfd, POLLIN, tick)) != XYM_OK)
+        {
+            return res;
+        }
+        n = read(tty_rfd, data, cnt);
+    } while (n < 0 && (errno == EINTR || errno == EAGAIN));
+    if (n <= 0)
+    {
+        return XYM_ERROR_HW; /* hang-up / EOF */
+    }
+    *got = (uint32_t)n;
+    return XYM_OK;
+}
+
+/**
+ * @brief  wake up the blocked receive(async-signal-safe)
+ * @param  \
+ * @retval \
+ */
+void xymodem_port_tty_abort(void)
+{
+    const uint8_t msg = 0;
+    if (abort_pipe[1] >= 0)
+    {
+        (void)!write(abort_pipe[1], &msg, 1);
+    }
+}
+
+/**
+ * @brief  hand data to the tty, best-effort within the deadline
+ * @param  data  : data
+ * @param  cnt   : data size / Bytes
+ * @param  tick  : deadline of the whole data / tick
+ * @retval enum xym_sta
+ * @note   Same as [xymodem_port_tty_send]: blocks until the kernel output queue takes the data or [tick] expires,
+ *         does not wait for the transmission
+ */
+xym_sta_t xymodem_port_tty_post(const uint8_t *data, const uint32_t cnt, const uint32_t tick)
+{
+    /* the kernel output queue normally takes a teardown sequence at once */
+    return xymodem_port_tty_send(data, cnt, tick);
+}
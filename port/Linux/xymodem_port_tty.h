@@ -0,0 +1,103 @@
+/**
+ *******************************************************************************************************************************************
+ * @file        xymodem_port_tty.h
+ * @brief       X / Y modem transport protocol port [Linux tty / stdio]
+ * @since       Change Logs:
+ * Date         Author       Notes
+ * 2026-10-18   lzh          the first version
+ * 2026-10-18   lzh          add [xymodem_port_tty_read] for the read-ahead buffer
+ * @copyright (c) 2023 lzh <lzhoran@163.com>
+ *                https://github.com/ZeHHHHH/Flexible-XYmodem.git
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *******************************************************************************************************************************************
+ */
+#ifndef __XYMODEM_PORT_TTY_H__
+#define __XYMODEM_PORT_TTY_H__
+
+#include "xymodem.h"
+
+/* Note: 1 tick == 1 ms, one link per process (same as the MCU ports) */
+
+/**
+ * @brief  open and configure a serial device
+ * @param  dev  : device path, eg: "/dev/ttyUSB0"
+ * @param  baud : baudrate, eg: 115200
+ * @param  mode : data bits, parity and stop bits, eg: "8N1", "7E1", "8O2"
+ * @param  flow : hardware flow control(RTS/CTS) : 0-disable; 1-enable
+ * @retval enum xym_sta
+ */
+xym_sta_t xymodem_port_tty_open(const char *dev, const uint32_t baud, const char *mode, const uint8_t flow);
+
+/**
+ * @brief  use already opened file descriptors as the link(eg: stdin / stdout of a terminal program)
+ * @param  rfd : file descriptor to receive from
+ * @param  wfd : file descriptor to send to
+ * @retval enum xym_sta
+ * @note   A tty is switched to raw mode and restored by [xymodem_port_tty_close]
+ */
+xym_sta_t xymodem_port_tty_attach(const int rfd, const int wfd);
+
+/**
+ * @brief  restore and close the link
+ * @param  \
+ * @retval \
+ */
+void xymodem_port_tty_close(void);
+
+/**
+ * @brief  send data within the set time
+ * @param  data  : data
+ * @param  cnt   : data size / Bytes
+ * @param  tick  : send 1 Bytes timeout / tick
+ * @retval enum xym_sta
+ */
+xym_sta_t xymodem_port_tty_send(const uint8_t *data, const uint32_t cnt, const uint32_t tick);
+
+/**
+ * @brief  receive data within the set time
+ * @param  data  : data
+ * @param  cnt   : data size / Bytes
+ * @param  tick  : receive 1 Bytes timeout / tick
+ * @retval enum xym_sta
+ */
+xym_sta_t xymodem_port_tty_recv(uint8_t *data, const uint32_t cnt, const uint32_t tick);
+
+/**
+ * @brief  receive up to [cnt] data, return as soon as at least 1 Byte is received
+ * @param  data  : data
+ * @param  cnt   : max data size / Bytes
+ * @param  got   : received data size / Bytes
+ * @param  tick  : receive the first Bytes timeout / tick
+ * @retval enum xym_sta
+ */
+xym_sta_t xymodem_port_tty_read(uint8_t *data, const uint32_t cnt, uint32_t *got, const uint32_t tick);
+
+/**
+ * @brief  wake up the blocked receive(async-signal-safe)
+ * @param  \
+ * @retval \
+ */
+void xymodem_port_tty_abort(void);
+
+/**
+ * @brief  queue data into the tty and return without waiting for the transmission
+ * @param  data  : data
+ * @param  cnt   : data size / Bytes
+ * @param  tick  : deadline of the whole data / tick
+ * @retval enum xym_sta
+ */
+xym_sta_t xymodem_port_tty_post(const uint8_t *data, const uint32_t cnt, const uint32_t tick);
+
+#endif /* __XYMODEM_PORT_TTY_H__ */
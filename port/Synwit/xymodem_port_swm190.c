@@ -5,6 +5,10 @@
  * @since       Change Logs:
  * Date         Author       Notes
  * 2023-11-30   lzh          the first version
+ * 2026-10-18   lzh          add [xymodem_port_abort] to wake up the blocked receive
+ * 2026-10-18   lzh          add [xymodem_port_read_data] for the read-ahead buffer
+ * 2026-10-18   lzh          MODE_ISR: frame assembler in the ISR, the task is signalled once per frame, CRC16 computed on arrival
+ * 2026-10-18   agent        MODE_ISR: the tail is verified in the ISR, the cached CRC16 is keyed to the ring position of the frame
  * @copyright (c) 2023 lzh <lzhoran@163.com>
  *                https://github.com/ZeHHHHH/Flexible-XYmodem.git
  * All rights reserved.
@@ -49,6 +53,7 @@
 /* UART Group X Attribute */
 #define UART_GROUP_X             UART1
 #define UART_GROUP_X_ISR_FUN     UART1_Handler
+#define UART_GROUP_X_IRQN        UART1_IRQn
 #define UART_BAUDRATE            115200
 
 /* UART1 TX - E7 */
@@ -63,6 +68,143 @@
 /* if a timeout occurs, it will return [True]; otherwise, it will return [False]. */
 #define IS_TIME_OUT(ticks, timestamp)            ((get_ticks() - (timestamp)) >= (ticks))
 
+/* abort request of the blocked receive, set by [xymodem_port_abort] from ISR or other threads */
+static volatile uint8_t port_abort_flag = 0;
+
+#if (DEV_MODE == MODE_ISR)
+/* Frame assembler: the ISR collects a whole frame before the task sees any of it
+ *   SOH / STX + sequence + ~sequence + data + CRC16 : committed at once when complete, CRC16 of the data computed on arrival
+ *                                                     and compared with the tail, the verdict is kept with the frame
+ *   any other byte(EOT / CAN / ACK / NAK / 'C' ...) : committed at once
+ *   invalid sequence, or the line idle in a frame(eg: Xmodem checksum frame, 1 Bytes shorter) : committed as it is
+ * The task is signalled once per frame instead of per Bytes / FIFO threshold, and only takes what is committed.
+ */
+#define PORT_RX_RING_SIZE  (4096)  /* power of 2, >= 2 max frames: one being assembled, one being taken */
+#define PORT_RX_RING_MASK  (PORT_RX_RING_SIZE - 1)
+#define PORT_SOH           (0x01)
+#define PORT_STX           (0x02)
+
+/* committed data signal / wait, eg: osSemaphoreRelease(rx_sem) / osSemaphoreAcquire(rx_sem, 1), or nothing / __WFI() */
+#define PORT_RX_SIGNAL()
+#define PORT_RX_WAIT()
+
+static uint8_t rx_ring[PORT_RX_RING_SIZE];
+static volatile uint32_t rx_wr = 0;        /* committed by the ISR */
+static volatile uint32_t rx_rd = 0;        /* taken by the task */
+static uint32_t asm_wr = 0;                /* ISR: end of the frame being assembled */
+static uint16_t asm_left = 0;              /* ISR: Bytes left of the frame being assembled, 0: none */
+static uint16_t asm_pos = 0;               /* ISR: Bytes of the frame after the special byte */
+static uint16_t asm_size = 0;              /* ISR: data size of the frame */
+static uint16_t asm_crc = 0;               /* ISR: CRC16 of the data received so far */
+static uint8_t asm_seq = 0;                /* ISR: packet sequence */
+static volatile uint32_t frame_end = 0;    /* ring position behind the tail of the last complete frame */
+static volatile uint16_t frame_crc = 0;    /* CRC16 of the data of the last complete frame */
+static volatile uint16_t frame_size = 0;   /* data size of the last complete frame */
+static volatile uint8_t frame_ok = 0;      /* the CRC16 of the last complete frame matches its tail */
+static uint8_t taken_ok = 0;               /* task: the last Bytes taken is the tail of a frame verified by the ISR */
+static uint16_t taken_crc = 0;             /* task: CRC16 of that frame */
+static uint16_t taken_size = 0;            /* task: data size of that frame */
+
+/* CRC16 (POLY 1021, INIT 0) by 4 bits: 32 Bytes of table, a few cycles per Bytes in the ISR */
+static const uint16_t crc16_nibble[16] = {
+    0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+    0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF,
+};
+
+static inline uint16_t crc16_update(uint16_t crc, const uint8_t c)
+{
+    crc = (uint16_t)((crc << 4) ^ crc16_nibble[(crc >> 12) ^ (c >> 4)]);
+    return (uint16_t)((crc << 4) ^ crc16_nibble[(crc >> 12) ^ (c & 0x0F)]);
+}
+
+/* ISR: commit the assembled Bytes to the task */
+static inline void port_rx_commit(void)
+{
+    asm_left = 0;
+    rx_wr = asm_wr;
+    PORT_RX_SIGNAL();
+}
+
+/* ISR: one received Bytes into the frame assembler */
+static inline void port_rx_input(const uint8_t c)
+{
+    if (asm_wr - rx_rd >= PORT_RX_RING_SIZE)
+    {
+        return; /* the task is too late: dropped, the X/Y modem retry recovers it */
+    }
+    rx_ring[asm_wr++ & PORT_RX_RING_MASK] = c;
+    if (asm_left == 0)
+    {
+        if (c == PORT_SOH || c == PORT_STX)
+        {
+            asm_size = (c == PORT_SOH) ? 128 : 1024;
+            asm_left = 2 + asm_size + 2;
+            asm_pos = 0;
+            asm_crc = 0;
+            return;
+        }
+        port_rx_commit();
+        return;
+    }
+    ++asm_pos;
+    --asm_left;
+    if (asm_pos == 1)
+    {
+        asm_seq = c;
+    }
+    else if (asm_pos == 2)
+    {
+        if ((uint8_t)(asm_seq ^ c) != 0xFF)
+        {
+            port_rx_commit(); /* not a frame header */
+            return;
+        }
+    }
+    else if (asm_pos <= 2 + asm_size)
+    {
+        asm_crc = crc16_update(asm_crc, c);
+    }
+    if (asm_left == 0)
+    {
+        /* tail: CRC16[MSB], the last 2 Bytes of the frame */
+        frame_ok = (asm_crc == ((rx_ring[(asm_wr - 2) & PORT_RX_RING_MASK] << 8) | rx_ring[(asm_wr - 1) & PORT_RX_RING_MASK])) ? 1 : 0;
+        frame_crc = asm_crc;
+        frame_size = asm_size;
+        frame_end = asm_wr;
+        port_rx_commit();
+    }
+}
+
+/* task: take 1 committed Bytes, 0: success */
+static inline int port_rx_take(uint32_t *c)
+{
+    uint32_t end = 0;
+
+    if (rx_rd == rx_wr)
+    {
+        return -1;
+    }
+    *c = rx_ring[rx_rd & PORT_RX_RING_MASK];
+    ++rx_rd;
+    /* copy the verdict of the frame ending here, unless the ISR has completed another one meanwhile */
+    end = frame_end;
+    taken_ok = (rx_rd == end) ? frame_ok : 0;
+    taken_crc = frame_crc;
+    taken_size = frame_size;
+    if (end != frame_end)
+    {
+        taken_ok = 0;
+    }
+    return 0;
+}
+
+#define PORT_RX_BYTE(c)    (0 == port_rx_take(c))
+#define PORT_RX_IDLE()     PORT_RX_WAIT()
+#else
+#define PORT_RX_BYTE(c)    (0 == UART_IsRXFIFOEmpty(UART_GROUP_X) && 0 == UART_ReadByte(UART_GROUP_X, (c)))
+#define PORT_RX_IDLE()
+#endif
+
 /**
  * @brief  get the elapsed tick since the session is initialised
  * @param  \
@@ -82,7 +224,7 @@ static size_t get_ticks(void)
 #endif
 }
 
-#ifdef CRC16_HW_ENABLE
+#if defined(CRC16_HW_ENABLE) || (DEV_MODE == MODE_ISR)
 /**
  * @brief  CRC16 verify data
  * @remark Provide more efficient CRC16, eg: Hardware-CRC16
@@ -92,6 +234,16 @@ static size_t get_ticks(void)
  */
 uint16_t xymodem_port_crc16(const uint8_t *data, const uint32_t cnt)
 {
+#if (DEV_MODE == MODE_ISR)
+    /* the data of the frame whose tail was just taken: already verified by the ISR on arrival.
+     * Only a match is taken from the ISR, a mismatch is computed again over [data] */
+    if (taken_ok != 0 && cnt == taken_size)
+    {
+        taken_ok = 0;
+        return taken_crc;
+    }
+#endif
+#ifdef CRC16_HW_ENABLE
     /* CRC Configuration:
      * WIDTH  : 16 bit
      * POLY   : 1021 (x16 + x12 + x5 + 1)
@@ -100,6 +252,14 @@ uint16_t xymodem_port_crc16(const uint8_t *data, const uint32_t cnt)
      * REFOUT : false
      * XOROUT : 0
      */
+#else
+    uint16_t crc = 0;
+    for (uint32_t i = 0; i < cnt; ++i)
+    {
+        crc = crc16_update(crc, data[i]);
+    }
+    return crc;
+#endif
 }
 #endif
 
@@ -126,6 +286,10 @@ xym_sta_t xymodem_port_init(void)
     UART_initStruct.TimeoutIEn = (DEV_MODE == MODE_ISR) ? 1 : 0;
     UART_Init(UART_GROUP_X, &UART_initStruct);
     UART_Open(UART_GROUP_X);
+#if (DEV_MODE == MODE_ISR)
+    NVIC_EnableIRQ(UART_GROUP_X_IRQN);
+#endif
+    port_abort_flag = 0;
 
 #ifdef CRC16_HW_ENABLE
     /* CRC16 hardware init */
@@ -134,6 +298,16 @@ xym_sta_t xymodem_port_init(void)
     return XYM_OK;
 }
 
+/**
+ * @brief  wake up the blocked receive(register as [ops.abort])
+ * @param  \
+ * @retval \
+ */
+void xymodem_port_abort(void)
+{
+    port_abort_flag = 1;
+}
+
 /**
  * @brief  send data within the set time
  * @param  data  : data
@@ -143,6 +317,11 @@ xym_sta_t xymodem_port_init(void)
  */
 xym_sta_t xymodem_port_send_data(const uint8_t *data, const uint32_t cnt, const uint32_t tick)
 {
+    /* a request that found no blocked receive: the session has seen it already(the cancel ends with a send) */
+    port_abort_flag = 0;
+#if (DEV_MODE == MODE_ISR)
+    taken_ok = 0; /* the reply is out: the CRC16 of the ISR is never taken for other data */
+#endif
     for (uint32_t i = 0; i < cnt; ++i)
     {
         /* wait for UART_TX-FIFO not full */
@@ -180,8 +359,8 @@ xym_sta_t xymodem_port_recv_data(uint8_t *data, const uint32_t cnt, const uint32
         size_t timestamp = get_ticks();
         for (uint32_t c = 0; ; ) /* set timeout and polling UART_RX-FIFO */
         {
-            /* UART_RX-FIFO not empty && read / verify data */
-            if (0 == UART_IsRXFIFOEmpty(UART_GROUP_X) && 0 == UART_ReadByte(UART_GROUP_X, &c))
+            /* UART_RX-FIFO not empty(frame assembler: committed data) && read / verify data */
+            if (PORT_RX_BYTE(&c))
             {
                 data[i++] = c & 0xFF;
                 break;
@@ -190,47 +369,62 @@ xym_sta_t xymodem_port_recv_data(uint8_t *data, const uint32_t cnt, const uint32
             {
                 return XYM_ERROR_TIMEOUT;
             }
+            if (port_abort_flag != 0)
+            {
+                port_abort_flag = 0;
+                return XYM_CANCEL_ACTIVE;
+            }
+            PORT_RX_IDLE();
         }
     }
     return XYM_OK;
 }
 
-#if (DEV_MODE == MODE_ISR)
+/**
+ * @brief  receive up to [cnt] data, return as soon as at least 1 Byte is received
+ * @param  data  : data
+ * @param  cnt   : max data size / Bytes
+ * @param  got   : received data size / Bytes
+ * @param  tick  : receive the first Bytes timeout / tick
+ * @retval enum xym_sta
+ */
+xym_sta_t xymodem_port_read_data(uint8_t *data, const uint32_t cnt, uint32_t *got, const uint32_t tick)
+{
+    uint32_t c = 0;
 
-#define UART_RX_SIZE       (1024)
-#define UART_RX_COUNT      (2)
-static uint8_t UART_RX_Buffer[UART_RX_COUNT][UART_RX_SIZE];
-static volatile uint32_t UART_Count_Index = 0;
-static volatile uint32_t UART_Size_Index = 0;
-static volatile uint8_t UART_TimeOut_Flag = 0;
+    /* wait for the first Byte */
+    xym_sta_t res = xymodem_port_recv_data(data, 1, tick);
+    *got = (res == XYM_OK) ? 1 : 0;
+    /* drain UART_RX-FIFO(frame assembler: the rest of the committed frame) without waiting */
+    while (res == XYM_OK && *got < cnt && PORT_RX_BYTE(&c))
+    {
+        data[(*got)++] = c & 0xFF;
+    }
+    return res;
+}
 
+#if (DEV_MODE == MODE_ISR)
 void UART_GROUP_X_ISR_FUN(void)
 {
     uint32_t chr = 0;
 
-    if(UART_INTStat(UART_GROUP_X, UART_IT_RX_THR | UART_IT_RX_TOUT))
+    if (UART_INTStat(UART_GROUP_X, UART_IT_RX_THR | UART_IT_RX_TOUT))
     {
-        if(UART_INTStat(UART_GROUP_X, UART_IT_RX_TOUT))
+        while (UART_IsRXFIFOEmpty(UART_GROUP_X) == 0)
         {
-            UART_INTClr(UART_GROUP_X, UART_IT_RX_TOUT);
-
-            /* IDLE Timeout */
-            UART_TimeOut_Flag = 1;
+            if (UART_ReadByte(UART_GROUP_X, &chr) == 0)
+            {
+                port_rx_input(chr & 0xFF);
+            }
         }
-        while(UART_IsRXFIFOEmpty(UART_GROUP_X) == 0)
+        if (UART_INTStat(UART_GROUP_X, UART_IT_RX_TOUT))
         {
-            if(UART_ReadByte(UART_GROUP_X, &chr) == 0)
+            UART_INTClr(UART_GROUP_X, UART_IT_RX_TOUT);
+
+            /* IDLE Timeout: the rest of a frame will not come */
+            if (asm_left != 0)
             {
-                /* Circular-Queue */
-                UART_RX_Buffer[UART_Count_Index][UART_Size_Index] = chr;
-                if (++UART_Size_Index >= UART_RX_SIZE)
-                {
-                    UART_Size_Index = 0;
-                    if (++UART_Count_Index >= UART_RX_COUNT)
-                    {
-                        UART_Count_Index = 0;
-                    }
-                }
+                port_rx_commit();
             }
         }
     }
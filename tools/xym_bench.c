@@ -0,0 +1,466 @@
+/**
+ *******************************************************************************************************************************************
+ * @file        xym_bench.c
+ * @brief       X / Y modem interop and throughput benchmark against lrzsz over pseudo-terminals [xym-bench]
+ * @since       Change Logs:
+ * Date         Author       Notes
+ * 2026-10-18   lzh          the first version
+ * @copyright (c) 2023 lzh <lzhoran@163.com>
+ *                https://github.com/ZeHHHHH/Flexible-XYmodem.git
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *******************************************************************************************************************************************
+ */
+#define _DEFAULT_SOURCE
+#include <errno.h>
+#include <fcntl.h>
+#include <pty.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+/*******************************************************************************************************************************************
+ * Private Define
+ *******************************************************************************************************************************************/
+#define BENCH_ARGS_MAX          (16)     /* max arguments of a peer command */
+#define BENCH_SIZES_MAX         (16)     /* max file sizes of a sweep */
+#define BENCH_START_DELAY_US    (100000) /* the receiver starts after the sender */
+#define BENCH_POLL_US           (1000)   /* child state poll period */
+
+/* implementation of one side */
+typedef enum bench_impl
+{
+    IMPL_XYM = 0, /* xym-send / xym-recv of this library */
+    IMPL_LRZSZ,   /* sx / rx / sb / rb */
+} bench_impl_t;
+
+/* result of one run */
+typedef struct bench_result
+{
+    int ok;          /* 1: exit 0 on both sides and the data matches */
+    int missing;     /* 1: a command could not be started */
+    double ms;       /* wall time / ms */
+    double cpu_tx;   /* sender user + system time / ms */
+    double cpu_rx;   /* receiver user + system time / ms */
+    const char *why; /* reason of a failure */
+} bench_result_t;
+
+/*******************************************************************************************************************************************
+ * Private Variable
+ *******************************************************************************************************************************************/
+static const char usage[] =
+    "usage: xym-bench [options]\n"
+    "  pairs xym-send / xym-recv with lrzsz (sx / rx / sb / rb) over pty pairs, sweeps protocol,\n"
+    "  file size, packet size and check mode, prints throughput, CPU time and failures side by side\n"
+    "  -B DIR    directory of xym-send / xym-recv (default \".\")\n"
+    "  -l PFX    prefix of the lrzsz commands, eg: \"l\" for lsx / lrx / lsb / lrb (default none)\n"
+    "  -L        skip lrzsz, this library only\n"
+    "  -z LIST   file sizes / Bytes, comma separated (default 1024,65536,1048576)\n"
+    "  -n N      runs of each case, the best is reported (default 3)\n"
+    "  -t SEC    timeout of a run (default 60)\n"
+    "  -w DIR    work directory (default /tmp/xym-bench)\n";
+
+static const char *bin_dir = ".";
+static const char *lrzsz_prefix = "";
+static const char *work_dir = "/tmp/xym-bench";
+static int no_lrzsz = 0;
+static int lrzsz_missing = 0;
+static uint32_t timeout_sec = 60;
+
+/*******************************************************************************************************************************************
+ * Private Function
+ *******************************************************************************************************************************************/
+/* monotonic time / us */
+static uint64_t now_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000u + (uint64_t)ts.tv_nsec / 1000u;
+}
+
+/* user + system time / ms */
+static double cpu_ms(const struct rusage *ru)
+{
+    return (ru->ru_utime.tv_sec + ru->ru_stime.tv_sec) * 1e3 + (ru->ru_utime.tv_usec + ru->ru_stime.tv_usec) / 1e3;
+}
+
+/**
+ * @brief  write a random test file, the last byte is never ^Z(trimmed by Xmodem receivers)
+ * @param  path : file
+ * @param  size : size / Bytes
+ * @retval 0: success, other: failed
+ */
+static int make_file(const char *path, const uint32_t size)
+{
+    FILE *fp = fopen(path, "wb");
+    uint32_t i = 0;
+    int c = 0;
+
+    if (fp == NULL)
+    {
+        return -1;
+    }
+    for (i = 0; i < size; ++i)
+    {
+        c = rand() & 0xFF;
+        fputc((i + 1 == size && c == 0x1A) ? 0x55 : c, fp);
+    }
+    return fclose(fp);
+}
+
+/**
+ * @brief  compare the received file with the source, trailing ^Z padding(Xmodem) is accepted
+ * @param  src : source file
+ * @param  dst : received file
+ * @retval 1: match, 0: mismatch
+ */
+static int same_file(const char *src, const char *dst)
+{
+    FILE *a = fopen(src, "rb");
+    FILE *b = fopen(dst, "rb");
+    int ca = 0, cb = 0, ok = (a != NULL && b != NULL);
+
+    while (ok)
+    {
+        ca = fgetc(a);
+        cb = fgetc(b);
+        if (ca == EOF)
+        {
+            for (; cb == 0x1A; cb = fgetc(b))
+            {
+            }
+            ok = (cb == EOF);
+            break;
+        }
+        ok = (ca == cb);
+    }
+    if (a != NULL)
+    {
+        fclose(a);
+    }
+    if (b != NULL)
+    {
+        fclose(b);
+    }
+    return ok;
+}
+
+/**
+ * @brief  start a peer on one end of the pty pair
+ * @param  fd   : pty end, stdin / stdout of the peer
+ * @param  dir  : working directory of the peer, NULL: unchanged
+ * @param  argv : command
+ * @retval pid, < 0: failed
+ */
+static pid_t spawn(const int fd, const char *dir, char *const argv[])
+{
+    pid_t pid = fork();
+    int null = -1;
+
+    if (pid != 0)
+    {
+        return pid;
+    }
+    null = open("/dev/null", O_WRONLY);
+    dup2(fd, STDIN_FILENO);
+    dup2(fd, STDOUT_FILENO);
+    dup2(null, STDERR_FILENO);
+    if (dir != NULL && chdir(dir) != 0)
+    {
+        _exit(126);
+    }
+    execvp(argv[0], argv);
+    _exit(127);
+}
+
+/**
+ * @brief  run one sender / receiver pair over a fresh pty pair
+ * @param  tx  : sender command
+ * @param  rx  : receiver command
+ * @param  dir : working directory of the receiver
+ * @param  res : returned result(without the data check)
+ * @retval \
+ */
+static void run_pair(char *const tx[], char *const rx[], const char *dir, bench_result_t *res)
+{
+    struct termios tio;
+    struct rusage ru;
+    int master = -1, slave = -1, status = 0, left = 2;
+    pid_t tx_pid = -1, rx_pid = -1, pid = 0;
+    uint64_t start = 0;
+
+    memset(res, 0, sizeof(*res));
+    if (openpty(&master, &slave, NULL, NULL, NULL) != 0)
+    {
+        res->why = "openpty";
+        return;
+    }
+    /* raw on both ends up front: the pair shares one termios, a peer restoring it at exit must not cook pending data */
+    tcgetattr(slave, &tio);
+    cfmakeraw(&tio);
+    tcsetattr(slave, TCSANOW, &tio);
+
+    start = now_us();
+    tx_pid = spawn(master, NULL, tx);
+    usleep(BENCH_START_DELAY_US);
+    rx_pid = spawn(slave, dir, rx);
+    res->ok = 1;
+    while (left > 0)
+    {
+        pid = wait4(-1, &status, WNOHANG, &ru);
+        if (pid == 0)
+        {
+            if (now_us() - start > (uint64_t)timeout_sec * 1000000u)
+            {
+                kill(tx_pid, SIGKILL);
+                kill(rx_pid, SIGKILL);
+                res->ok = 0;
+                res->why = "timeout";
+            }
+            usleep(BENCH_POLL_US);
+            continue;
+        }
+        if (pid < 0)
+        {
+            break;
+        }
+        --left;
+        if (pid == tx_pid)
+        {
+            res->cpu_tx = cpu_ms(&ru);
+            res->ms = (now_us() - start) / 1e3; /* the receiver may still be draining, taken again below */
+        }
+        else
+        {
+            res->cpu_rx = cpu_ms(&ru);
+        }
+        if (WIFEXITED(status) && WEXITSTATUS(status) == 127)
+        {
+            res->missing = 1;
+        }
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+        {
+            res->ok = 0;
+            res->why = (res->why != NULL) ? res->why : (pid == tx_pid) ? "sender failed" : "receiver failed";
+        }
+    }
+    res->ms = (now_us() - start) / 1e3 - BENCH_START_DELAY_US / 1e3;
+    close(master);
+    close(slave);
+}
+
+/**
+ * @brief  build the command of one side
+ * @param  argv   : returned command
+ * @param  buf    : storage of the strings
+ * @param  impl   : implementation
+ * @param  send   : 1-sender; 0-receiver
+ * @param  ymodem : 1-Ymodem; 0-Xmodem
+ * @param  pkt    : sender packet size
+ * @param  crc    : Xmodem receiver requests CRC16(lrzsz rx defaults to checksum)
+ * @param  file   : source file / received file(Xmodem receiver)
+ * @retval \
+ */
+static void build_cmd(char *argv[], char buf[][256], const bench_impl_t impl, const int send, const int ymodem,
+                      const uint16_t pkt, const int crc, const char *file)
+{
+    int n = 0;
+
+    if (impl == IMPL_XYM)
+    {
+        snprintf(buf[0], 256, "%s/%s", bin_dir, send ? "xym-send" : "xym-recv");
+        argv[n++] = buf[0];
+        argv[n++] = "-q";
+        argv[n++] = "-d";
+        argv[n++] = "-";
+        argv[n++] = ymodem ? "-y" : "-x";
+        if (send)
+        {
+            snprintf(buf[1], 256, "%u", pkt);
+            argv[n++] = "-k";
+            argv[n++] = buf[1];
+        }
+        argv[n++] = (char *)((send || !ymodem) ? file : ".");
+    }
+    else
+    {
+        snprintf(buf[0], 256, "%s%s", lrzsz_prefix, send ? (ymodem ? "sb" : "sx") : (ymodem ? "rb" : "rx"));
+        argv[n++] = buf[0];
+        argv[n++] = "-q";
+        if (send && pkt == 1024)
+        {
+            argv[n++] = "-k";
+        }
+        if (!send && !ymodem && crc)
+        {
+            argv[n++] = "-c";
+        }
+        if (send || !ymodem)
+        {
+            argv[n++] = (char *)file;
+        }
+    }
+    argv[n] = NULL;
+}
+
+/**
+ * @brief  run one case(best of [runs]) and print its row
+ * @param  ymodem : 1-Ymodem; 0-Xmodem
+ * @param  tx     : sender implementation
+ * @param  rx     : receiver implementation
+ * @param  size   : file size / Bytes
+ * @param  pkt    : sender packet size
+ * @param  crc    : 1-CRC16; 0-checksum
+ * @param  runs   : runs
+ * @retval 0: pass, 1: fail, -1: skipped
+ */
+static int run_case(const int ymodem, const bench_impl_t tx, const bench_impl_t rx, const uint32_t size,
+                    const uint16_t pkt, const int crc, const int runs)
+{
+    static const char *impl_name[] = {"xym", "lrzsz"};
+    char src[512], dir[512], dst[1024], tx_buf[2][256], rx_buf[2][256];
+    char *tx_argv[BENCH_ARGS_MAX], *rx_argv[BENCH_ARGS_MAX];
+    bench_result_t res, best;
+    int i = 0;
+
+    if ((tx == IMPL_LRZSZ || rx == IMPL_LRZSZ) && (no_lrzsz || lrzsz_missing))
+    {
+        return -1;
+    }
+    snprintf(src, sizeof(src), "%s/src_%u.bin", work_dir, size);
+    snprintf(dir, sizeof(dir), "%s/out", work_dir);
+    snprintf(dst, sizeof(dst), "%s/%s", dir, ymodem ? strrchr(src, '/') + 1 : "x.bin");
+    build_cmd(tx_argv, tx_buf, tx, 1, ymodem, pkt, crc, src);
+    build_cmd(rx_argv, rx_buf, rx, 0, ymodem, pkt, crc, dst);
+    memset(&best, 0, sizeof(best));
+    for (i = 0; i < runs; ++i)
+    {
+        unlink(dst);
+        mkdir(dir, 0755);
+        run_pair(tx_argv, rx_argv, dir, &res);
+        if (res.missing && (tx == IMPL_LRZSZ || rx == IMPL_LRZSZ))
+        {
+            fprintf(stderr, "lrzsz not found(prefix \"%s\"), lrzsz cases are skipped\n", lrzsz_prefix);
+            lrzsz_missing = 1;
+            return -1;
+        }
+        if (res.ok && !same_file(src, dst))
+        {
+            res.ok = 0;
+            res.why = "data mismatch";
+        }
+        if (!res.ok)
+        {
+            best = res;
+            break;
+        }
+        if (i == 0 || res.ms < best.ms)
+        {
+            best = res;
+        }
+    }
+    printf("%-7s %-6s %-6s %9u %5u %-5s %10.1f %10.1f %9.1f %9.1f  %s\n", ymodem ? "ymodem" : "xmodem", impl_name[tx], impl_name[rx],
+           size, pkt, crc ? "crc" : "sum", best.ms, best.ok ? size / 1024.0 / (best.ms / 1e3) : 0.0, best.cpu_tx, best.cpu_rx,
+           best.ok ? "ok" : best.why);
+    fflush(stdout);
+    return best.ok ? 0 : 1;
+}
+
+/*******************************************************************************************************************************************
+ * Public Function
+ *******************************************************************************************************************************************/
+int main(int argc, char **argv)
+{
+    static const uint16_t pkts[] = {128, 1024};
+    uint32_t sizes[BENCH_SIZES_MAX] = {1024, 65536, 1048576};
+    uint32_t size_num = 3, s = 0;
+    char path[512], *tok = NULL;
+    int runs = 3, opt = 0, ymodem = 0, tx = 0, rx = 0, crc = 0, k = 0, r = 0;
+    int pass = 0, fail = 0, skip = 0;
+
+    while ((opt = getopt(argc, argv, "B:l:Lz:n:t:w:h")) != -1)
+    {
+        switch (opt)
+        {
+        case 'B': bin_dir = optarg; break;
+        case 'l': lrzsz_prefix = optarg; break;
+        case 'L': no_lrzsz = 1; break;
+        case 'z':
+            for (size_num = 0, tok = strtok(optarg, ","); tok != NULL && size_num < BENCH_SIZES_MAX; tok = strtok(NULL, ","))
+            {
+                sizes[size_num++] = (uint32_t)strtoul(tok, NULL, 0);
+            }
+            break;
+        case 'n': runs = atoi(optarg) > 0 ? atoi(optarg) : 1; break;
+        case 't': timeout_sec = (uint32_t)strtoul(optarg, NULL, 0); break;
+        case 'w': work_dir = optarg; break;
+        case 'h':
+        default:
+            fprintf(stderr, "%s", usage);
+            return 2;
+        }
+    }
+    mkdir(work_dir, 0755);
+    for (s = 0; s < size_num; ++s)
+    {
+        snprintf(path, sizeof(path), "%s/src_%u.bin", work_dir, sizes[s]);
+        if (make_file(path, sizes[s]) != 0)
+        {
+            fprintf(stderr, "create [%s] failed: %s\n", path, strerror(errno));
+            return 2;
+        }
+    }
+    signal(SIGPIPE, SIG_IGN);
+    printf("%-7s %-6s %-6s %9s %5s %-5s %10s %10s %9s %9s  %s\n", "proto", "send", "recv", "size", "pkt", "check", "time/ms", "KiB/s",
+           "cpu-tx/ms", "cpu-rx/ms", "result");
+    /* protocol x file size x packet size x check mode x sender x receiver */
+    for (ymodem = 0; ymodem <= 1; ++ymodem)
+    {
+        for (s = 0; s < size_num; ++s)
+        {
+            for (k = 0; k < 2; ++k)
+            {
+                for (crc = 1; crc >= 0; --crc)
+                {
+                    for (tx = IMPL_XYM; tx <= IMPL_LRZSZ; ++tx)
+                    {
+                        for (rx = IMPL_XYM; rx <= IMPL_LRZSZ; ++rx)
+                        {
+                            /* only an lrzsz Xmodem receiver can be asked for the checksum, Ymodem is always CRC16 */
+                            if (crc == 0 && (ymodem || rx != IMPL_LRZSZ))
+                            {
+                                continue;
+                            }
+                            r = run_case(ymodem, (bench_impl_t)tx, (bench_impl_t)rx, sizes[s], pkts[k], crc, runs);
+                            pass += (r == 0);
+                            fail += (r > 0);
+                            skip += (r < 0);
+                        }
+                    }
+                }
+            }
+        }
+    }
+    printf("pass %d, fail %d, skipped %d\n", pass, fail, skip);
+    return (fail > 0) ? 1 : 0;
+}
@@ -0,0 +1,657 @@
+/**
+ *******************************************************************************************************************************************
+ * @file        xym_cli.c
+ * @brief       X / Y modem host command-line tools common part
+ * @since       Change Logs:
+ * Date         Author       Notes
+ * 2026-10-18   lzh          the first version
+ * 2026-10-18   lzh          add parameter cache file [-c] keyed by the device identity [-i]
+ * 2026-10-18   lzh          add learned settings of a device class [-u] by xym-tune
+ * 2026-10-18   lzh          add remote verification [-V] [-A]
+ * 2026-10-18   lzh          add network serial link [-d tcp://HOST:PORT] [-d rfc2217://HOST:PORT]
+ * 2026-10-18   lzh          add CAN / CAN FD link [-d can://IF:TXID:RXID] [-d canfd://IF:TXID:RXID]
+ * @copyright (c) 2023 lzh <lzhoran@163.com>
+ *                https://github.com/ZeHHHHH/Flexible-XYmodem.git
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *******************************************************************************************************************************************
+ */
+#define _DEFAULT_SOURCE
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "xym_cli.h"
+#include "xymodem_port_can.h"
+#include "xymodem_port_tcp.h"
+#include "xymodem_port_tty.h"
+
+/*******************************************************************************************************************************************
+ * Private Define
+ *******************************************************************************************************************************************/
+#define PROGRESS_PERIOD_US      (200000) /* live progress refresh period */
+#define CACHE_ENTRY_NUM         (64)     /* devices in the parameter cache file */
+#define CAN_TX_ID_DEFAULT       (0x7E0)  /* CAN ID of the host => device frames */
+#define CAN_RX_ID_DEFAULT       (0x7E8)  /* CAN ID of the device => host frames */
+
+/* link type */
+typedef enum link_type
+{
+    LINK_TTY = 0, /* serial device / stdio */
+    LINK_TCP,     /* raw TCP / RFC 2217 */
+    LINK_CAN,     /* CAN / CAN FD */
+} link_type_t;
+
+/*******************************************************************************************************************************************
+ * Private Variable
+ *******************************************************************************************************************************************/
+static xym_session_t *volatile cancel_session = NULL; /* session cancelled by signal */
+static char cache_path[4096];                        /* default parameter cache file */
+static xym_tune_t cli_tune;                          /* learned settings of the device class */
+static link_type_t link_type = LINK_TTY;             /* link of [xym_cli_link_open] */
+XYM_PCACHE_DEFINE(cli_cache, CACHE_ENTRY_NUM);
+
+/*******************************************************************************************************************************************
+ * Private Function
+ *******************************************************************************************************************************************/
+/* monotonic time / us */
+static uint64_t now_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000u + (uint64_t)ts.tv_nsec / 1000u;
+}
+
+/* signal handler: only async-signal-safe calls */
+static void on_signal(int sig)
+{
+    (void)sig;
+    if (cancel_session != NULL)
+    {
+        xymodem_cancel_request(cancel_session);
+    }
+}
+
+/* device identity string => key of the parameter cache(FNV-1a) */
+static uint32_t dev_key(const char *id)
+{
+    uint32_t h = 2166136261u;
+    while (*id != 0)
+    {
+        h = (h ^ (uint8_t)*id++) * 16777619u;
+    }
+    return h;
+}
+
+/**
+ * @brief  split a network device "tcp://HOST:PORT" / "rfc2217://HOST:PORT", HOST of IPv6 in brackets
+ * @param  dev  : device
+ * @param  host : returned host
+ * @param  size : size of [host]
+ * @param  port : returned port, NULL: missing
+ * @retval 0: raw TCP, 1: RFC 2217, < 0: not a network device
+ */
+static int net_dev(const char *dev, char *host, const size_t size, const char **port)
+{
+    const char *sep = NULL;
+    int rfc2217 = 0;
+    size_t n = 0;
+
+    if (strncmp(dev, "tcp://", 6) == 0)
+    {
+        dev += 6;
+    }
+    else if (strncmp(dev, "rfc2217://", 10) == 0)
+    {
+        dev += 10;
+        rfc2217 = 1;
+    }
+    else
+    {
+        return -1;
+    }
+    sep = strrchr(dev, ':');
+    *port = (sep != NULL && sep[1] != 0) ? sep + 1 : NULL;
+    n = (sep != NULL) ? (size_t)(sep - dev) : strlen(dev);
+    if (n >= 2 && dev[0] == '[' && dev[n - 1] == ']')
+    {
+        dev += 1;
+        n -= 2;
+    }
+    n = (n < size) ? n : size - 1;
+    memcpy(host, dev, n);
+    host[n] = 0;
+    return rfc2217;
+}
+
+/**
+ * @brief  split a CAN device "can://IF[:TXID:RXID]" / "canfd://IF[:TXID:RXID]", IDs in hex
+ * @param  dev    : device
+ * @param  ifname : returned interface
+ * @param  size   : size of [ifname]
+ * @param  tx_id  : returned CAN ID of the sent frames
+ * @param  rx_id  : returned CAN ID of the received frames
+ * @retval 0: classic CAN, 1: CAN FD, < 0: not a CAN device
+ */
+static int can_dev(const char *dev, char *ifname, const size_t size, uint32_t *tx_id, uint32_t *rx_id)
+{
+    const char *sep = NULL;
+    int fd = 0;
+    size_t n = 0;
+
+    if (strncmp(dev, "can://", 6) == 0)
+    {
+        dev += 6;
+    }
+    else if (strncmp(dev, "canfd://", 8) == 0)
+    {
+        dev += 8;
+        fd = 1;
+    }
+    else
+    {
+        return -1;
+    }
+    *tx_id = CAN_TX_ID_DEFAULT;
+    *rx_id = CAN_RX_ID_DEFAULT;
+    sep = strchr(dev, ':');
+    n = (sep != NULL) ? (size_t)(sep - dev) : strlen(dev);
+    if (sep != NULL)
+    {
+        *tx_id = (uint32_t)strtoul(sep + 1, (char **)&sep, 16);
+        *rx_id = (*sep == ':') ? (uint32_t)strtoul(sep + 1, NULL, 16) : *rx_id;
+    }
+    n = (n < size) ? n : size - 1;
+    memcpy(ifname, dev, n);
+    ifname[n] = 0;
+    return fd;
+}
+
+/* load the learned settings of a device class from the xym-tune file($XYM_TUNE_FILE or $HOME/.xym-tune) */
+static int tune_load(const char *cls, xym_tune_t *tune)
+{
+    char path[4096], line[512], name[512];
+    unsigned baud = 0, pkt = 0, send_tmo = 0, recv_tmo = 0, retry = 0;
+    FILE *fp = NULL;
+    int found = 0;
+
+    if (getenv("XYM_TUNE_FILE") != NULL)
+    {
+        snprintf(path, sizeof(path), "%s", getenv("XYM_TUNE_FILE"));
+    }
+    else
+    {
+        snprintf(path, sizeof(path), "%s/.xym-tune", (getenv("HOME") != NULL) ? getenv("HOME") : ".");
+    }
+    if ((fp = fopen(path, "r")) == NULL)
+    {
+        fprintf(stderr, "open the settings file [%s] failed\n", path);
+        return -1;
+    }
+    while (found == 0 && fgets(line, sizeof(line), fp) != NULL)
+    {
+        if (sscanf(line, "%511s %u %u %u %u %u", name, &baud, &pkt, &send_tmo, &recv_tmo, &retry) == 6 && strcmp(name, cls) == 0)
+        {
+            tune->baud = baud;
+            tune->pkt_size = (pkt > XYM_PKT_SIZE_128) ? XYM_PKT_SIZE_1024 : XYM_PKT_SIZE_128;
+            tune->send_timeout = send_tmo;
+            tune->recv_timeout = recv_tmo;
+            tune->error_max_retry = (uint8_t)retry;
+            found = 1;
+        }
+    }
+    fclose(fp);
+    if (found == 0)
+    {
+        fprintf(stderr, "device class [%s] is not in [%s], run xym-tune first\n", cls, path);
+        return -1;
+    }
+    return 0;
+}
+
+/* human readable rate */
+static void fmt_rate(char *str, const size_t len, const double bps)
+{
+    if (bps >= 1024.0 * 1024.0)
+    {
+        snprintf(str, len, "%.2f MiB/s", bps / (1024.0 * 1024.0));
+    }
+    else
+    {
+        snprintf(str, len, "%.1f KiB/s", bps / 1024.0);
+    }
+}
+
+/*******************************************************************************************************************************************
+ * Public Function
+ *******************************************************************************************************************************************/
+/**
+ * @brief  parse the common options, print usage on error
+ * @param  cfg   : configuration(defaults are set here)
+ * @param  argc  : argc of main
+ * @param  argv  : argv of main
+ * @param  usage : tool specific usage text
+ * @retval index of the first non-option argument, < 0: error / help
+ */
+int xym_cli_parse(xym_cli_cfg_t *cfg, int argc, char **argv, const char *usage)
+{
+    int opt = 0;
+
+    memset(cfg, 0, sizeof(*cfg));
+    cfg->dev = "/dev/ttyUSB0";
+    cfg->baud = 115200;
+    cfg->mode = "8N1";
+    cfg->param.send_timeout = 1000;
+    cfg->param.recv_timeout = 3000;
+    cfg->param.error_max_retry = 10;
+    cfg->profile = XYM_PROFILE_AUTO;
+
+    while ((opt = getopt(argc, argv, "d:b:m:Fxyk:t:r:C:T:p:i:c:u:V:A:Pqh")) != -1)
+    {
+        switch (opt)
+        {
+        case 'd': cfg->dev = optarg; break;
+        case 'b': cfg->baud = (uint32_t)strtoul(optarg, NULL, 0); break;
+        case 'm': cfg->mode = optarg; break;
+        case 'F': cfg->flow = 1; break;
+        case 'x': cfg->xmodem = 1; break;
+        case 'y': cfg->xmodem = 0; break;
+        case 'k': cfg->pkt_size = (strtoul(optarg, NULL, 0) > XYM_PKT_SIZE_128) ? XYM_PKT_SIZE_1024 : XYM_PKT_SIZE_128; break;
+        case 't': cfg->param.recv_timeout = (uint32_t)strtoul(optarg, NULL, 0); break;
+        case 'r': cfg->param.error_max_retry = (uint8_t)strtoul(optarg, NULL, 0); break;
+        case 'C': cfg->param.cancel_cnt = (uint8_t)strtoul(optarg, NULL, 0); break;
+        case 'T': cfg->param.teardown_timeout = (uint32_t)strtoul(optarg, NULL, 0); break;
+        case 'p':
+            for (cfg->profile = XYM_PROFILE_STANDARD; cfg->profile < XYM_PROFILE_AUTO; ++cfg->profile)
+            {
+                if (strcmp(optarg, xym_cli_profile_str(cfg->profile)) == 0)
+                {
+                    break;
+                }
+            }
+            if (cfg->profile == XYM_PROFILE_AUTO && strcmp(optarg, "auto") != 0)
+            {
+                fprintf(stderr, "unknown peer profile [%s]\n", optarg);
+                return -1;
+            }
+            break;
+        case 'i': cfg->dev_id = optarg; break;
+        case 'c': cfg->cache_path = optarg; break;
+        case 'u':
+            if (tune_load(optarg, &cli_tune) != 0)
+            {
+                return -1;
+            }
+            cfg->param.tune = &cli_tune; /* timeouts and retry, loaded by the session init */
+            break;
+        case 'V':
+            if (strcmp(optarg, "crc32") == 0)
+            {
+                cfg->verify = XYM_DIGEST_CRC32;
+            }
+            else if (strcmp(optarg, "sha256") == 0)
+            {
+                cfg->verify = XYM_DIGEST_SHA256;
+            }
+            else
+            {
+                fprintf(stderr, "unknown digest [%s]\n", optarg);
+                return -1;
+            }
+            break;
+        case 'A': cfg->verify_base = (uint32_t)strtoul(optarg, NULL, 0); break;
+        case 'P': cfg->pipeline = 1; break;
+        case 'q': cfg->quiet = 1; break;
+        case 'h':
+        default:
+            fprintf(stderr,
+                    "%s"
+                    "link options:\n"
+                    "  -d DEV    serial device, \"-\" for stdin / stdout (default /dev/ttyUSB0),\n"
+                    "            tcp://HOST:PORT for a raw TCP port, rfc2217://HOST:PORT for a RFC 2217 terminal server,\n"
+                    "            can://IF[:TXID:RXID] / canfd://IF[:TXID:RXID] for CAN / CAN FD (default IDs 7E0:7E8)\n"
+                    "  -b BAUD   baudrate (default 115200)\n"
+                    "  -m MODE   data bits, parity, stop bits (default 8N1)\n"
+                    "  -F        RTS/CTS hardware flow control\n"
+                    "protocol options:\n"
+                    "  -x / -y   Xmodem / Ymodem (default Ymodem)\n"
+                    "  -k SIZE   sender packet size 128 / 1024 (default as cached, 1024)\n"
+                    "  -t MS     receive timeout (default 3000)\n"
+                    "  -r N      max retry (default 10)\n"
+                    "  -C N      CAN count of the cancel sequence (default %d)\n"
+                    "  -T MS     teardown deadline (default send timeout)\n"
+                    "  -p PEER   peer profile: standard, lrzsz, securecrt, teraterm, extraputty, flexible, auto (default auto)\n"
+                    "  -i ID     device identity, fast start with its cached parameters(eg: serial number)\n"
+                    "  -c FILE   parameter cache file (default $HOME/.xym-cache)\n"
+                    "  -u CLASS  learned settings of the device class by xym-tune, override -b -k -t -r\n"
+                    "  -V ALG    remote verification after the session by digest crc32 / sha256 instead of a read-back,\n"
+                    "            receiver: answer the verification requests of the received files (any ALG)\n"
+                    "  -A ADDR   sender: offset of the first file in the device (default 0), the next files follow\n"
+                    "  -P        receiver: store in a worker thread, overlapped with the link\n"
+                    "  -q        no live progress\n",
+                    usage, XYM_CANCEL_CNT_DEFAULT);
+            return -1;
+        }
+    }
+    if (cfg->param.tune != NULL)
+    {
+        cfg->baud = (cli_tune.baud > 0) ? cli_tune.baud : cfg->baud;
+        cfg->pkt_size = cli_tune.pkt_size;
+    }
+    if (cfg->cache_path == NULL)
+    {
+        snprintf(cache_path, sizeof(cache_path), "%s/.xym-cache", (getenv("HOME") != NULL) ? getenv("HOME") : ".");
+        cfg->cache_path = cache_path;
+    }
+    return optind;
+}
+
+/**
+ * @brief  open the link and fill the session ops
+ * @param  cfg : configuration
+ * @param  ops : returned ops
+ * @retval enum xym_sta
+ */
+xym_sta_t xym_cli_link_open(const xym_cli_cfg_t *cfg, struct xym_ops *ops)
+{
+    xym_sta_t res = XYM_OK;
+    const char *port = NULL;
+    char host[256];
+    uint32_t tx_id = 0, rx_id = 0;
+    int rfc2217 = net_dev(cfg->dev, host, sizeof(host), &port);
+    int canfd = can_dev(cfg->dev, host, sizeof(host), &tx_id, &rx_id);
+
+    link_type = (rfc2217 >= 0) ? LINK_TCP : (canfd >= 0) ? LINK_CAN : LINK_TTY;
+    if (strcmp(cfg->dev, "-") == 0)
+    {
+        res = xymodem_port_tty_attach(STDIN_FILENO, STDOUT_FILENO);
+    }
+    else if (link_type == LINK_TCP)
+    {
+        res = (port != NULL) ? xymodem_port_tcp_open(host, port, (uint8_t)rfc2217, cfg->baud, cfg->mode, cfg->flow)
+                             : XYM_ERROR_INVALID_DATA;
+    }
+    else if (link_type == LINK_CAN)
+    {
+        res = xymodem_port_can_open(host, tx_id, rx_id, (uint8_t)canfd);
+    }
+    else
+    {
+        res = xymodem_port_tty_open(cfg->dev, cfg->baud, cfg->mode, cfg->flow);
+    }
+    if (res != XYM_OK)
+    {
+        fprintf(stderr, "open link [%s] failed: %s\n", cfg->dev, xym_cli_sta_str(res));
+        return res;
+    }
+    memset(ops, 0, sizeof(*ops));
+    if (link_type == LINK_TCP)
+    {
+        ops->send = xymodem_port_tcp_send;
+        ops->recv = xymodem_port_tcp_recv;
+        ops->abort = xymodem_port_tcp_abort;
+        ops->post = xymodem_port_tcp_post;
+        ops->read = xymodem_port_tcp_read;
+        return XYM_OK;
+    }
+    if (link_type == LINK_CAN)
+    {
+        ops->send = xymodem_port_can_send;
+        ops->recv = xymodem_port_can_recv;
+        ops->abort = xymodem_port_can_abort;
+        ops->post = xymodem_port_can_post;
+        ops->read = xymodem_port_can_read;
+        return XYM_OK;
+    }
+    ops->send = xymodem_port_tty_send;
+    ops->recv = xymodem_port_tty_recv;
+    ops->abort = xymodem_port_tty_abort;
+    ops->post = xymodem_port_tty_post;
+    ops->read = xymodem_port_tty_read; /* used when built with XYM_RX_BUFF_SIZE > 0 */
+    return XYM_OK;
+}
+
+/**
+ * @brief  close the link
+ * @param  \
+ * @retval \
+ */
+void xym_cli_link_close(void)
+{
+    if (link_type == LINK_TCP)
+    {
+        xymodem_port_tcp_close();
+        return;
+    }
+    if (link_type == LINK_CAN)
+    {
+        xymodem_port_can_close();
+        return;
+    }
+    xymodem_port_tty_close();
+}
+
+/**
+ * @brief  cancel the session on SIGINT / SIGTERM / SIGHUP
+ * @param  p : session control struct
+ * @retval \
+ */
+void xym_cli_cancel_on_signal(xym_session_t *p)
+{
+    struct sigaction sa;
+
+    cancel_session = p;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = on_signal;
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+    sigaction(SIGHUP, &sa, NULL);
+}
+
+/**
+ * @brief  start a new file
+ * @param  s     : statistics
+ * @param  name  : file name
+ * @param  total : file size / Bytes, 0: unknown
+ * @retval \
+ */
+void xym_cli_file_start(xym_cli_stat_t *s, const char *name, const uint64_t total)
+{
+    if (s->start_us == 0)
+    {
+        s->start_us = now_us();
+    }
+    s->file_us = s->print_us = now_us();
+    s->file_done = 0;
+    s->file_total = total;
+    s->name = name;
+    s->files++;
+}
+
+/**
+ * @brief  account transferred data and print the live throughput / ETA
+ * @param  cfg : configuration
+ * @param  s   : statistics
+ * @param  cnt : transferred / Bytes
+ * @retval \
+ */
+void xym_cli_progress(const xym_cli_cfg_t *cfg, xym_cli_stat_t *s, const uint32_t cnt)
+{
+    uint64_t t = now_us();
+    double sec = 0, bps = 0;
+    char rate[32];
+
+    s->file_done += cnt;
+    s->total_done += cnt;
+    if (cfg->quiet != 0 || t - s->print_us < PROGRESS_PERIOD_US)
+    {
+        return;
+    }
+    s->print_us = t;
+    sec = (double)(t - s->file_us) / 1e6;
+    bps = (sec > 0) ? (double)s->file_done / sec : 0;
+    fmt_rate(rate, sizeof(rate), bps);
+    if (s->file_total > 0 && s->file_done <= s->file_total)
+    {
+        double eta = (bps > 0) ? (double)(s->file_total - s->file_done) / bps : 0;
+        fprintf(stderr, "\r%s: %llu / %llu (%3.0f%%)  %s  ETA %02u:%02u   ", s->name ? s->name : "",
+                (unsigned long long)s->file_done, (unsigned long long)s->file_total, 100.0 * (double)s->file_done / (double)s->file_total,
+                rate, (unsigned)eta / 60, (unsigned)eta % 60);
+    }
+    else
+    {
+        fprintf(stderr, "\r%s: %llu  %s   ", s->name ? s->name : "", (unsigned long long)s->file_done, rate);
+    }
+}
+
+/**
+ * @brief  print the final summary(throughput and efficiency against the line rate)
+ * @param  cfg : configuration
+ * @param  s   : statistics
+ * @param  sta : session result
+ * @retval 0: success, other: failed
+ */
+int xym_cli_summary(const xym_cli_cfg_t *cfg, const xym_cli_stat_t *s, const xym_sta_t sta)
+{
+    double sec = (s->start_us > 0) ? (double)(now_us() - s->start_us) / 1e6 : 0;
+    double bps = (sec > 0) ? (double)s->total_done / sec : 0;
+    char rate[32];
+
+    fmt_rate(rate, sizeof(rate), bps);
+    if (cfg->quiet == 0 && s->files > 0)
+    {
+        fprintf(stderr, "\n");
+    }
+    fprintf(stderr, "%s: %u file(s), %llu Bytes in %.3f s, %s", xym_cli_sta_str(sta), s->files, (unsigned long long)s->total_done, sec, rate);
+    if (strcmp(cfg->dev, "-") != 0 && cfg->baud > 0)
+    {
+        /* start bit + data bits + parity + stop bits per character */
+        double bits = 1 + (cfg->mode[0] - '0') + ((cfg->mode[1] == 'N' || cfg->mode[1] == 'n') ? 0 : 1) + (cfg->mode[2] - '0');
+        fprintf(stderr, ", efficiency %.1f%% of %u baud", 100.0 * bps * bits / (double)cfg->baud, cfg->baud);
+    }
+    fprintf(stderr, "\n");
+    return (sta == XYM_END) ? 0 : 1;
+}
+
+/**
+ * @brief  load the parameter cache file and find the cached parameters of the device [cfg.dev_id]
+ * @param  cfg : configuration
+ * @retval cache entry, NULL: no device identity or not cached
+ * @note   The file has a line per device: "key crc_flag pkt_1k profile", eg: "9a3f01c2 1 1 flexible"
+ */
+const xym_pcache_entry_t *xym_cli_cache_find(const xym_cli_cfg_t *cfg)
+{
+    xym_pcache_entry_t *e = NULL;
+    FILE *fp = NULL;
+    char name[32];
+    unsigned key = 0, crc = 0, pkt_1k = 0;
+    xym_profile_t profile = XYM_PROFILE_STANDARD;
+    uint16_t n = 0;
+
+    xymodem_pcache_init(&cli_cache);
+    if (cfg->dev_id == NULL || (fp = fopen(cfg->cache_path, "r")) == NULL)
+    {
+        return NULL;
+    }
+    while (n < cli_cache.num && fscanf(fp, "%x %u %u %31s", &key, &crc, &pkt_1k, name) == 4)
+    {
+        for (profile = XYM_PROFILE_STANDARD; profile < XYM_PROFILE_AUTO && strcmp(name, xym_cli_profile_str(profile)) != 0; ++profile)
+        {
+        }
+        e = &cli_cache.entry[n++];
+        e->id = key;
+        e->valid = 1;
+        e->crc_flag = (crc != 0) ? 1 : 0;
+        e->pkt_1k = (pkt_1k != 0) ? 1 : 0;
+        e->profile = (uint8_t)profile;
+    }
+    cli_cache.next = (n < cli_cache.num) ? n : 0;
+    fclose(fp);
+    return xymodem_pcache_find(&cli_cache, dev_key(cfg->dev_id));
+}
+
+/**
+ * @brief  store the parameters negotiated by the session for the device [cfg.dev_id] and save the parameter cache file
+ * @param  cfg : configuration
+ * @param  p   : session control struct, after the session is over normally
+ * @retval \
+ */
+void xym_cli_cache_store(const xym_cli_cfg_t *cfg, const xym_session_t *p)
+{
+    FILE *fp = NULL;
+    uint16_t i = 0;
+
+    if (cfg->dev_id == NULL || XYM_OK != xymodem_pcache_store(&cli_cache, dev_key(cfg->dev_id), p))
+    {
+        return;
+    }
+    if ((fp = fopen(cfg->cache_path, "w")) == NULL)
+    {
+        fprintf(stderr, "save parameter cache [%s] failed\n", cfg->cache_path);
+        return;
+    }
+    for (i = 0; i < cli_cache.num; ++i)
+    {
+        if (cli_cache.entry[i].valid != 0)
+        {
+            fprintf(fp, "%08x %u %u %s\n", (unsigned)cli_cache.entry[i].id, cli_cache.entry[i].crc_flag,
+                    cli_cache.entry[i].pkt_1k, xym_cli_profile_str((xym_profile_t)cli_cache.entry[i].profile));
+        }
+    }
+    fclose(fp);
+}
+
+/**
+ * @brief  readable peer profile name
+ * @param  profile : enum xym_profile
+ * @retval string
+ */
+const char *xym_cli_profile_str(const xym_profile_t profile)
+{
+    switch (profile)
+    {
+    case XYM_PROFILE_STANDARD: return "standard";
+    case XYM_PROFILE_LRZSZ: return "lrzsz";
+    case XYM_PROFILE_SECURECRT: return "securecrt";
+    case XYM_PROFILE_TERATERM: return "teraterm";
+    case XYM_PROFILE_EXTRAPUTTY: return "extraputty";
+    case XYM_PROFILE_FLEXIBLE: return "flexible";
+    default: return "auto";
+    }
+}
+
+/**
+ * @brief  readable session result
+ * @param  sta : enum xym_sta
+ * @retval string
+ */
+const char *xym_cli_sta_str(const xym_sta_t sta)
+{
+    switch (sta)
+    {
+    case XYM_OK: return "ok";
+    case XYM_END: return "done";
+    case XYM_FIL_GET: return "file info get";
+    case XYM_FIL_SET: return "file info set";
+    case XYM_CANCEL_REMOTE: return "cancelled by remote";
+    case XYM_CANCEL_ACTIVE: return "cancelled";
+    case XYM_ERROR_TIMEOUT: return "timeout";
+    case XYM_ERROR_RETRANS: return "too many retransmissions";
+    case XYM_ERROR_INVALID_DATA: return "invalid data";
+    case XYM_ERROR_HW: return "hardware error";
+    default: return "unknown";
+    }
+}
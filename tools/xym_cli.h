@@ -0,0 +1,157 @@
+/**
+ *******************************************************************************************************************************************
+ * @file        xym_cli.h
+ * @brief       X / Y modem host command-line tools common part
+ * @since       Change Logs:
+ * Date         Author       Notes
+ * 2026-10-18   lzh          the first version
+ * 2026-10-18   lzh          add parameter cache file [-c] keyed by the device identity [-i]
+ * 2026-10-18   lzh          add remote verification [-V]
+ * 2026-10-18   lzh          add network serial link [-d tcp://HOST:PORT] [-d rfc2217://HOST:PORT]
+ * 2026-10-18   lzh          add CAN / CAN FD link [-d can://IF:TXID:RXID] [-d canfd://IF:TXID:RXID]
+ * @copyright (c) 2023 lzh <lzhoran@163.com>
+ *                https://github.com/ZeHHHHH/Flexible-XYmodem.git
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *******************************************************************************************************************************************
+ */
+#ifndef __XYM_CLI_H__
+#define __XYM_CLI_H__
+
+#include <stdio.h>
+#include "xymodem.h"
+#include "xymodem_verify.h"
+
+/** command-line configuration */
+typedef struct xym_cli_cfg
+{
+    const char *dev;         /**< link device, "-": stdin / stdout, "tcp://HOST:PORT" / "rfc2217://HOST:PORT": network,
+                                  "can://IF:TXID:RXID" / "canfd://IF:TXID:RXID": CAN */
+    uint32_t baud;           /**< baudrate */
+    const char *mode;        /**< data bits, parity and stop bits, eg: "8N1" */
+    uint8_t flow;            /**< hardware flow control(RTS/CTS) : 0-disable; 1-enable */
+    uint8_t xmodem;          /**< protocol : 0-Ymodem; 1-Xmodem */
+    uint16_t pkt_size;       /**< sender packet size : 128 / 1024, 0: as cached(default 1024) */
+    uint8_t quiet;           /**< no live progress : 0-No; 1-Yes */
+    uint8_t pipeline;        /**< receiver verifies / stores in a worker thread : 0-No; 1-Yes */
+    xym_profile_t profile;   /**< peer profile */
+    const char *dev_id;      /**< device identity of the fast start, NULL: full negotiation */
+    const char *cache_path;  /**< parameter cache file */
+    uint8_t verify;          /**< remote verification after the session, enum xym_digest_alg, 0: disable */
+    uint32_t verify_base;    /**< sender: offset of the first file in the device */
+    struct xym_param param;  /**< session param */
+} xym_cli_cfg_t;
+
+/** transfer statistics */
+typedef struct xym_cli_stat
+{
+    uint64_t start_us;       /**< session start time / us */
+    uint64_t file_us;        /**< current file start time / us */
+    uint64_t print_us;       /**< last progress print time / us */
+    uint64_t file_done;      /**< current file done / Bytes */
+    uint64_t file_total;     /**< current file size / Bytes, 0: unknown */
+    uint64_t total_done;     /**< all files done / Bytes */
+    uint32_t files;          /**< number of files */
+    const char *name;        /**< current file name */
+} xym_cli_stat_t;
+
+/**
+ * @brief  parse the common options, print usage on error
+ * @param  cfg   : configuration(defaults are set here)
+ * @param  argc  : argc of main
+ * @param  argv  : argv of main
+ * @param  usage : tool specific usage text
+ * @retval index of the first non-option argument, < 0: error / help
+ */
+int xym_cli_parse(xym_cli_cfg_t *cfg, int argc, char **argv, const char *usage);
+
+/**
+ * @brief  open the link and fill the session ops
+ * @param  cfg : configuration
+ * @param  ops : returned ops
+ * @retval enum xym_sta
+ */
+xym_sta_t xym_cli_link_open(const xym_cli_cfg_t *cfg, struct xym_ops *ops);
+
+/**
+ * @brief  close the link
+ * @param  \
+ * @retval \
+ */
+void xym_cli_link_close(void);
+
+/**
+ * @brief  cancel the session on SIGINT / SIGTERM / SIGHUP
+ * @param  p : session control struct
+ * @retval \
+ */
+void xym_cli_cancel_on_signal(xym_session_t *p);
+
+/**
+ * @brief  start a new file
+ * @param  s     : statistics
+ * @param  name  : file name
+ * @param  total : file size / Bytes, 0: unknown
+ * @retval \
+ */
+void xym_cli_file_start(xym_cli_stat_t *s, const char *name, const uint64_t total);
+
+/**
+ * @brief  account transferred data and print the live throughput / ETA
+ * @param  cfg : configuration
+ * @param  s   : statistics
+ * @param  cnt : transferred / Bytes
+ * @retval \
+ */
+void xym_cli_progress(const xym_cli_cfg_t *cfg, xym_cli_stat_t *s, const uint32_t cnt);
+
+/**
+ * @brief  print the final summary(throughput and efficiency against the line rate)
+ * @param  cfg : configuration
+ * @param  s   : statistics
+ * @param  sta : session result
+ * @retval 0: success, other: failed
+ */
+int xym_cli_summary(const xym_cli_cfg_t *cfg, const xym_cli_stat_t *s, const xym_sta_t sta);
+
+/**
+ * @brief  load the parameter cache file and find the cached parameters of the device [cfg.dev_id]
+ * @param  cfg : configuration
+ * @retval cache entry, NULL: no device identity or not cached
+ */
+const xym_pcache_entry_t *xym_cli_cache_find(const xym_cli_cfg_t *cfg);
+
+/**
+ * @brief  store the parameters negotiated by the session for the device [cfg.dev_id] and save the parameter cache file
+ * @param  cfg : configuration
+ * @param  p   : session control struct, after the session is over normally
+ * @retval \
+ */
+void xym_cli_cache_store(const xym_cli_cfg_t *cfg, const xym_session_t *p);
+
+/**
+ * @brief  readable peer profile name
+ * @param  profile : enum xym_profile
+ * @retval string
+ */
+const char *xym_cli_profile_str(const xym_profile_t profile);
+
+/**
+ * @brief  readable session result
+ * @param  sta : enum xym_sta
+ * @retval string
+ */
+const char *xym_cli_sta_str(const xym_sta_t sta);
+
+#endif /* __XYM_CLI_H__ */
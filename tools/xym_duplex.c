@@ -0,0 +1,284 @@
+/**
+ *******************************************************************************************************************************************
+ * @file        xym_duplex.c
+ * @brief       X / Y modem full-duplex transfer: send and receive files at once over one link [xym-duplex]
+ * @since       Change Logs:
+ * Date         Author       Notes
+ * 2026-10-18   lzh          the first version
+ * @copyright (c) 2023 lzh <lzhoran@163.com>
+ *                https://github.com/ZeHHHHH/Flexible-XYmodem.git
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *******************************************************************************************************************************************
+ */
+#define _DEFAULT_SOURCE
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/stat.h>
+#include "xym_cli.h"
+#include "xymodem_duplex.h"
+
+/*******************************************************************************************************************************************
+ * Private Variable
+ *******************************************************************************************************************************************/
+static const char usage[] =
+    "usage: xym-duplex [options] host|device DIR [FILE...]\n"
+    "  full-duplex Ymodem: sends the FILEs while the files of the peer are received into DIR, both over one link\n"
+    "  host offers the mode, device waits for the offer (xym-duplex device, or a firmware with xymodem_duplex)\n";
+
+XYM_MUX_DEFINE(duplex, 2);
+XYM_MUX_CHANNEL(duplex, 0)
+XYM_MUX_CHANNEL(duplex, 1)
+
+/* one direction */
+typedef struct duplex_dir
+{
+    xym_session_t session;
+    xym_sta_t res;
+    uint32_t files;
+    uint64_t bytes;
+    uint64_t us;
+} duplex_dir_t;
+
+static xym_cli_cfg_t cfg;
+static duplex_dir_t tx, rx;
+static char **tx_files = NULL;
+static int tx_num = 0;
+static const char *rx_dir = ".";
+static volatile int pump_stop = 0;
+
+/*******************************************************************************************************************************************
+ * Private Function
+ *******************************************************************************************************************************************/
+/* monotonic time / us */
+static uint64_t now_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000u + (uint64_t)ts.tv_nsec / 1000u;
+}
+
+/* tick source of the mux / ms */
+static uint32_t ticks(void)
+{
+    return (uint32_t)(now_us() / 1000u);
+}
+
+/**
+ * @brief  send one file: file info, data, EOT
+ * @param  p    : session
+ * @param  path : file
+ * @retval XYM_OK : next file, other : session over
+ */
+static xym_sta_t send_file(xym_session_t *p, const char *path)
+{
+    uint8_t *buff = xymodem_frame_data(p);
+    const char *name = strrchr(path, '/');
+    xym_sta_t res = XYM_OK;
+    struct stat st;
+    FILE *fp = fopen(path, "rb");
+    size_t n = 0;
+
+    if (fp == NULL || fstat(fileno(fp), &st) != 0)
+    {
+        fprintf(stderr, "open [%s] failed, skipped\n", path);
+        if (fp != NULL)
+        {
+            fclose(fp);
+        }
+        return XYM_OK;
+    }
+    memset(buff, 0, XYM_PKT_SIZE_128);
+    n = (size_t)snprintf((char *)buff, XYM_PKT_SIZE_128 - 16, "%s", (name != NULL) ? name + 1 : path) + 1;
+    snprintf((char *)&buff[n], XYM_PKT_SIZE_128 - n, "%lld", (long long)st.st_size);
+    res = ymodem_transmit(p, buff, XYM_PKT_SIZE_128);
+    while (res == XYM_OK)
+    {
+        n = fread(buff, 1, XYM_PKT_SIZE_1024, fp);
+        res = (n > 0) ? ymodem_transmit(p, buff, (uint16_t)n) : ymodem_transmit_eof(p); /* also an empty file */
+        tx.bytes += (res == XYM_OK) ? n : 0;
+        if (n == 0)
+        {
+            break;
+        }
+    }
+    fclose(fp);
+    tx.files += (res == XYM_FIL_SET) ? 1 : 0;
+    return (res == XYM_FIL_SET) ? XYM_OK : res;
+}
+
+/* sender context: the FILEs, then the end of batch */
+static void *tx_run(void *arg)
+{
+    xym_session_t *p = &tx.session;
+    xym_sta_t res = XYM_OK;
+    int i = 0;
+
+    (void)arg;
+    ymodem_init(p);
+    for (i = 0; res == XYM_OK && i < tx_num; ++i)
+    {
+        res = send_file(p, tx_files[i]);
+    }
+    if (res == XYM_OK)
+    {
+        memset(xymodem_frame_data(p), 0, XYM_PKT_SIZE_128);
+        res = ymodem_transmit(p, xymodem_frame_data(p), 0);
+    }
+    tx.res = res;
+    tx.us = now_us() - tx.us;
+    return NULL;
+}
+
+/* receiver context: the files of the peer into DIR */
+static void *rx_run(void *arg)
+{
+    xym_session_t *p = &rx.session;
+    uint8_t *data = xymodem_frame_data(p);
+    char path[4096];
+    const char *base = NULL;
+    FILE *fp = NULL;
+    uint64_t left = 0;
+    uint16_t len = 0;
+    xym_sta_t res = XYM_OK;
+
+    (void)arg;
+    ymodem_init(p);
+    while ((res = ymodem_receive(p, NULL, &len)) == XYM_OK || res == XYM_FIL_GET)
+    {
+        if (res == XYM_FIL_GET)
+        {
+            if (fp != NULL)
+            {
+                fclose(fp);
+                rx.files++;
+            }
+            /* never leave the output directory */
+            base = strrchr((const char *)data, '/');
+            base = (base != NULL) ? base + 1 : (const char *)data;
+            snprintf(path, sizeof(path), "%s/%s", rx_dir, (base[0] != 0 && base[0] != '.') ? base : "unnamed");
+            left = strtoull((const char *)&data[strnlen((const char *)data, len) + 1], NULL, 10);
+            left = (left > 0) ? left : UINT64_MAX;
+            if ((fp = fopen(path, "wb")) == NULL)
+            {
+                fprintf(stderr, "open [%s] failed\n", path);
+                res = xymodem_active_cancel(p);
+                break;
+            }
+            continue;
+        }
+        len = (left < len) ? (uint16_t)left : len;
+        if (fp != NULL && fwrite(data, 1, len, fp) != len)
+        {
+            res = xymodem_active_cancel(p);
+            break;
+        }
+        left -= len;
+        rx.bytes += len;
+    }
+    if (fp != NULL)
+    {
+        fclose(fp);
+        rx.files += (res == XYM_END) ? 1 : 0;
+    }
+    rx.res = res;
+    rx.us = now_us() - rx.us;
+    return NULL;
+}
+
+/* pump context: the physical link, until both sessions are over and the last reply has left */
+static void *pump_run(void *arg)
+{
+    (void)arg;
+    while (pump_stop == 0 || xymodem_mux_pending(&duplex) > 0)
+    {
+        if (XYM_OK != xymodem_mux_poll(&duplex, 1))
+        {
+            fprintf(stderr, "link error\n");
+            xymodem_cancel_request(&tx.session);
+            xymodem_cancel_request(&rx.session);
+            break;
+        }
+    }
+    return NULL;
+}
+
+/* result line of one direction */
+static void print_dir(const char *name, const duplex_dir_t *d)
+{
+    fprintf(stderr, "%s: %u file(s), %llu Bytes in %.3f s, %.2f KiB/s : %s\n", name, d->files, (unsigned long long)d->bytes,
+            d->us / 1e6, (d->us > 0) ? d->bytes / 1024.0 / (d->us / 1e6) : 0.0, xym_cli_sta_str(d->res));
+}
+
+/*******************************************************************************************************************************************
+ * Public Function
+ *******************************************************************************************************************************************/
+int main(int argc, char **argv)
+{
+    struct xym_ops ops, chan_ops[2] = {XYM_MUX_OPS(duplex, 0), XYM_MUX_OPS(duplex, 1)};
+    pthread_t th_tx, th_rx, th_pump;
+    xym_sta_t res = XYM_OK;
+    int host = 0, i = xym_cli_parse(&cfg, argc, argv, usage);
+
+    if (i < 0 || argc - i < 2 || cfg.xmodem != 0 || (strcmp(argv[i], "host") != 0 && strcmp(argv[i], "device") != 0))
+    {
+        if (i >= 0)
+        {
+            fprintf(stderr, "%s", usage);
+        }
+        return 2;
+    }
+    host = (strcmp(argv[i], "host") == 0);
+    rx_dir = argv[i + 1];
+    tx_files = &argv[i + 2];
+    tx_num = argc - i - 2;
+    if (XYM_OK != xym_cli_link_open(&cfg, &ops))
+    {
+        return 2;
+    }
+    res = (host != 0) ? xymodem_duplex_offer(ops, 1000, 5) : xymodem_duplex_accept(ops, 60000);
+    if (res != XYM_OK)
+    {
+        fprintf(stderr, "full-duplex mode not %s: %s\n", (host != 0) ? "accepted" : "offered", xym_cli_sta_str(res));
+        xym_cli_link_close();
+        return 1;
+    }
+    xymodem_mux_init(&duplex, ops, ticks, cfg.param.send_timeout);
+    /* host -> device on XYM_DUPLEX_CH_HOST, device -> host on XYM_DUPLEX_CH_DEVICE */
+    xymodem_session_init(&tx.session, chan_ops[(host != 0) ? 0 : 1], cfg.param);
+    xymodem_session_init(&rx.session, chan_ops[(host != 0) ? 1 : 0], cfg.param);
+    xymodem_profile_set(&rx.session, XYM_PROFILE_FLEXIBLE);
+    xym_cli_cancel_on_signal(&tx.session);
+
+    tx.us = rx.us = now_us();
+    pthread_create(&th_pump, NULL, pump_run, NULL);
+    pthread_create(&th_rx, NULL, rx_run, NULL);
+    pthread_create(&th_tx, NULL, tx_run, NULL);
+    pthread_join(th_tx, NULL);
+    if (tx.res == XYM_CANCEL_ACTIVE)
+    {
+        xymodem_cancel_request(&rx.session); /* Ctrl+C cancels both directions */
+    }
+    pthread_join(th_rx, NULL);
+    pump_stop = 1;
+    pthread_join(th_pump, NULL);
+    xym_cli_link_close();
+
+    print_dir("send", &tx);
+    print_dir("recv", &rx);
+    return (tx.res == XYM_END && rx.res == XYM_END) ? 0 : 1;
+}
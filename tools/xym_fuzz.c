@@ -0,0 +1,371 @@
+/**
+ *******************************************************************************************************************************************
+ * @file        xym_fuzz.c
+ * @brief       X / Y modem worst-case-time fuzz harness over a simulated transport with virtual time [xym-fuzz]
+ * @since       Change Logs:
+ * Date         Author       Notes
+ * 2026-10-18   lzh          the first version
+ * @copyright (c) 2023 lzh <lzhoran@163.com>
+ *                https://github.com/ZeHHHHH/Flexible-XYmodem.git
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *******************************************************************************************************************************************
+ */
+/*
+ * Input layout: [config] [peer byte stream ...]
+ *   config bit0   : 0-Xmodem; 1-Ymodem
+ *   config bit1   : 0-library receives; 1-library transmits(the stream is the receiver replies)
+ *   config bit2   : [ops.read] through the read-ahead buffer(XYM_RX_BUFF_SIZE > 0)
+ *   config bit3   : escape mode, FUZZ_ESC in the stream is one receive timeout
+ *   config bit4~5 : error_max_retry = 1 / 3 / 10 / 30
+ * After the stream, the peer is silent: every receive times out.
+ *
+ * Virtual time: every byte on the line costs 1 tick, every timeout costs the requested tick.
+ * Budget: each input event(stream byte, escape) and each retry of the final silence may cost one timeout,
+ *         one frame and one CAN sequence. A session over budget is a pathological slow path.
+ *
+ * libFuzzer : clang -g -O1 -fsanitize=fuzzer,address -DXYM_FUZZ_LIBFUZZER -DXYM_RX_BUFF_SIZE=256 -I. tools/xym_fuzz.c xymodem.c
+ * AFL       : afl-clang-fast -O2 -DXYM_RX_BUFF_SIZE=256 -I. tools/xym_fuzz.c xymodem.c -o xym-fuzz; afl-fuzz -i seeds -o out ./xym-fuzz
+ * replay    : xym-fuzz [FILE ...] (stdin without FILE), prints the cost of each input, exit 1 if one is over budget
+ * seeds     : xym-fuzz -g DIR
+ */
+#define _DEFAULT_SOURCE
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "xymodem.h"
+
+/*******************************************************************************************************************************************
+ * Private Define
+ *******************************************************************************************************************************************/
+#define FUZZ_ESC                (0xFD)  /* escape mode: a receive timeout */
+#define FUZZ_SEND_TIMEOUT       (10)    /* send timeout / tick */
+#define FUZZ_RECV_TIMEOUT       (100)   /* receive timeout / tick */
+#define FUZZ_CALL_MAX           (100000) /* receive / transmit calls of one session, a hang guard */
+#define FUZZ_INPUT_MAX          (65536) /* max input of replay */
+
+/* cost of one session */
+typedef struct fuzz_cost
+{
+    uint64_t vtime;      /* virtual time / tick */
+    uint64_t budget;     /* virtual time budget / tick */
+    uint32_t events;     /* input events(stream bytes + escapes) */
+    uint32_t timeouts;   /* receive timeouts */
+    uint32_t sends;      /* [ops.send] calls */
+    uint32_t recvs;      /* [ops.recv] / [ops.read] calls */
+    uint32_t calls;      /* receive / transmit calls */
+    uint64_t crc_bytes;  /* bytes through [ops.crc16], CPU proxy */
+    xym_sta_t sta;       /* session result */
+} fuzz_cost_t;
+
+/*******************************************************************************************************************************************
+ * Private Variable
+ *******************************************************************************************************************************************/
+static const uint8_t *in_data;   /* peer byte stream */
+static size_t in_len;            /* size of stream */
+static size_t in_pos;            /* read position */
+static uint8_t in_esc;           /* escape mode */
+static fuzz_cost_t cost;
+
+/*******************************************************************************************************************************************
+ * Private Function
+ *******************************************************************************************************************************************/
+/* build-in CRC16 of the protocol, counted as CPU */
+static uint16_t fuzz_crc16(const uint8_t *data, const uint32_t cnt)
+{
+    uint16_t crc = 0;
+    uint32_t i = 0;
+    uint8_t j = 0;
+
+    cost.crc_bytes += cnt;
+    for (i = 0; i < cnt; ++i)
+    {
+        crc ^= (uint16_t)(data[i] << 8);
+        for (j = 0; j < 8; ++j)
+        {
+            crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+/* the line takes everything, 1 tick per byte */
+static xym_sta_t fuzz_send(const uint8_t *data, const uint32_t cnt, const uint32_t tick)
+{
+    (void)data;
+    (void)tick;
+    cost.sends++;
+    cost.vtime += cnt;
+    return XYM_OK;
+}
+
+/* take one byte of the stream, 0: a timeout(escape or silence) */
+static int fuzz_take(uint8_t *c, const uint32_t tick)
+{
+    if (in_pos < in_len && !(in_esc && in_data[in_pos] == FUZZ_ESC))
+    {
+        *c = in_data[in_pos++];
+        cost.vtime += 1;
+        return 1;
+    }
+    in_pos += (in_pos < in_len) ? 1 : 0; /* the escape is consumed */
+    cost.timeouts++;
+    cost.vtime += tick;
+    return 0;
+}
+
+static xym_sta_t fuzz_recv(uint8_t *data, const uint32_t cnt, const uint32_t tick)
+{
+    uint32_t i = 0;
+
+    cost.recvs++;
+    for (i = 0; i < cnt; ++i)
+    {
+        if (!fuzz_take(&data[i], tick))
+        {
+            return XYM_ERROR_TIMEOUT;
+        }
+    }
+    return XYM_OK;
+}
+
+/* read up to [cnt]: waits for the first byte, then whatever is left before the next escape */
+static xym_sta_t fuzz_read(uint8_t *data, const uint32_t cnt, uint32_t *got, const uint32_t tick)
+{
+    uint32_t i = 0;
+
+    cost.recvs++;
+    if (!fuzz_take(&data[0], tick))
+    {
+        *got = 0;
+        return XYM_ERROR_TIMEOUT;
+    }
+    for (i = 1; i < cnt && in_pos < in_len && !(in_esc && in_data[in_pos] == FUZZ_ESC); ++i)
+    {
+        data[i] = in_data[in_pos++];
+        cost.vtime += 1;
+    }
+    *got = i;
+    return XYM_OK;
+}
+
+/**
+ * @brief  run one session over an input and measure its cost
+ * @param  data : input [config] [stream]
+ * @param  size : size of input
+ * @retval 1: over budget, 0: OK
+ */
+static int fuzz_session(const uint8_t *data, const size_t size)
+{
+    static xym_session_t session;
+    static const uint8_t retry_sel[4] = {1, 3, 10, 30};
+    struct xym_ops ops;
+    struct xym_param param;
+    uint8_t cfg = (size > 0) ? data[0] : 0;
+    uint8_t buff[XYM_PKT_SIZE_1024];
+    uint16_t len = 0;
+    uint8_t step = 0;
+    xym_sta_t sta = XYM_OK;
+
+    memset(&cost, 0, sizeof(cost));
+    in_data = (size > 0) ? &data[1] : data;
+    in_len = (size > 0) ? size - 1 : 0;
+    in_pos = 0;
+    in_esc = (cfg >> 3) & 1;
+    cost.events = (uint32_t)in_len;
+
+    memset(&ops, 0, sizeof(ops));
+    ops.send = fuzz_send;
+    ops.recv = fuzz_recv;
+    ops.crc16 = fuzz_crc16;
+    ops.read = ((cfg >> 2) & 1) ? fuzz_read : NULL;
+    memset(&param, 0, sizeof(param));
+    param.send_timeout = FUZZ_SEND_TIMEOUT;
+    param.recv_timeout = FUZZ_RECV_TIMEOUT;
+    param.error_max_retry = retry_sel[(cfg >> 4) & 3];
+    xymodem_session_init(&session, ops, param);
+
+    memset(buff, 0x5A, sizeof(buff));
+    (cfg & 1) ? ymodem_init(&session) : xmodem_init(&session);
+    for (cost.calls = 0; sta == XYM_OK && cost.calls < FUZZ_CALL_MAX; ++cost.calls)
+    {
+        if (((cfg >> 1) & 1) == 0)
+        {
+            sta = (cfg & 1) ? ymodem_receive(&session, buff, &len) : xmodem_receive(&session, buff, &len);
+            sta = (sta == XYM_FIL_GET) ? XYM_OK : sta;
+            continue;
+        }
+        /* Xmodem: 3 packets + EOT; Ymodem: file info, 2 packets, EOT, null header */
+        if ((cfg & 1) == 0)
+        {
+            sta = xmodem_transmit(&session, buff, (step < 3) ? XYM_PKT_SIZE_1024 : 0);
+        }
+        else if (step == 0)
+        {
+            memcpy(buff, "fuzz.bin\0" "2048", 14);
+            sta = ymodem_transmit(&session, buff, XYM_PKT_SIZE_128);
+        }
+        else
+        {
+            sta = ymodem_transmit(&session, buff, (step < 3) ? XYM_PKT_SIZE_1024 : 0);
+            if (sta == XYM_FIL_SET)
+            {
+                memset(buff, 0, XYM_PKT_SIZE_128);
+                sta = ymodem_transmit(&session, buff, 0);
+            }
+        }
+        ++step;
+    }
+    cost.sta = sta;
+    /* every event and every retry of the final silence may cost one timeout, one frame and one CAN sequence */
+    cost.budget = ((uint64_t)cost.events + 2u * (param.error_max_retry + 2u)) *
+                  (FUZZ_RECV_TIMEOUT + FUZZ_SEND_TIMEOUT + XYM_FRAME_SIZE + XYM_CANCEL_CNT_MAX);
+    return (cost.vtime > cost.budget || cost.calls >= FUZZ_CALL_MAX) ? 1 : 0;
+}
+
+/* print the cost of one input */
+static void fuzz_report(FILE *fp, const char *name, const size_t size, const int over)
+{
+    fprintf(fp, "%s: %zu B, vtime %llu / budget %llu (%.2f), timeouts %u, send %u, recv %u, calls %u, crc %llu B, sta %d%s\n",
+            name, size, (unsigned long long)cost.vtime, (unsigned long long)cost.budget,
+            (cost.budget > 0) ? (double)cost.vtime / (double)cost.budget : 0.0, cost.timeouts, cost.sends, cost.recvs, cost.calls,
+            (unsigned long long)cost.crc_bytes, (int)cost.sta, over ? "  << OVER BUDGET" : "");
+}
+
+#ifdef XYM_FUZZ_LIBFUZZER
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size);
+
+/* libFuzzer entry, an over-budget input is reported as a crash */
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    if (fuzz_session(data, size) != 0)
+    {
+        fuzz_report(stderr, "over budget", size, 1);
+        abort();
+    }
+    return 0;
+}
+#else
+/**
+ * @brief  append a frame(header + data + CRC16) to a seed
+ * @param  out  : seed
+ * @param  seq  : packet sequence
+ * @param  data : valid data
+ * @param  size : 128 / 1024
+ * @retval size of the frame
+ */
+static size_t seed_frame(uint8_t *out, const uint8_t seq, const uint8_t *data, const uint16_t size)
+{
+    uint16_t crc = fuzz_crc16(data, size);
+
+    out[0] = (size == XYM_PKT_SIZE_128) ? 0x01 : 0x02;
+    out[1] = seq;
+    out[2] = (uint8_t)~seq;
+    memcpy(&out[3], data, size);
+    out[3 + size] = (uint8_t)(crc >> 8);
+    out[4 + size] = (uint8_t)crc;
+    return 5u + size;
+}
+
+/* write the seeds of a valid session of each mode */
+static int seed_write(const char *dir)
+{
+    static uint8_t seed[4 * XYM_FRAME_SIZE];
+    uint8_t data[XYM_PKT_SIZE_1024];
+    char path[4096];
+    size_t n = 0;
+    FILE *fp = NULL;
+    int mode = 0;
+
+    for (mode = 0; mode < 4; ++mode)
+    {
+        n = 0;
+        seed[n++] = (uint8_t)(mode | (1u << 4)); /* retry 3 */
+        if ((mode & 2) == 0 && (mode & 1) == 0)
+        {
+            memset(data, 0xA5, sizeof(data));
+            n += seed_frame(&seed[n], 1, data, XYM_PKT_SIZE_1024);
+            n += seed_frame(&seed[n], 2, data, XYM_PKT_SIZE_128);
+            seed[n++] = 0x04;
+        }
+        else if ((mode & 2) == 0)
+        {
+            memset(data, 0, sizeof(data));
+            memcpy(data, "seed.bin\0" "1100", 14);
+            n += seed_frame(&seed[n], 0, data, XYM_PKT_SIZE_128);
+            memset(data, 0xA5, sizeof(data));
+            n += seed_frame(&seed[n], 1, data, XYM_PKT_SIZE_1024);
+            n += seed_frame(&seed[n], 2, data, XYM_PKT_SIZE_128);
+            seed[n++] = 0x04;
+            seed[n++] = 0x04;
+            memset(data, 0, sizeof(data));
+            n += seed_frame(&seed[n], 0, data, XYM_PKT_SIZE_128);
+        }
+        else
+        {
+            /* receiver replies: 'C', then ACK for every frame / EOT, 'C' before each Ymodem header */
+            const char *reply = (mode & 1) ? "C\x06" "C\x06\x06\x15\x06" "C\x06" : "C\x06\x06\x06\x06";
+            n += strlen(reply);
+            memcpy(&seed[1], reply, strlen(reply));
+        }
+        snprintf(path, sizeof(path), "%s/seed_%d", dir, mode);
+        if ((fp = fopen(path, "wb")) == NULL || fwrite(seed, 1, n, fp) != n)
+        {
+            fprintf(stderr, "write [%s] failed\n", path);
+            return 2;
+        }
+        fclose(fp);
+    }
+    return 0;
+}
+
+/* replay inputs(AFL runs it on stdin) */
+int main(int argc, char **argv)
+{
+    static uint8_t data[FUZZ_INPUT_MAX];
+    size_t size = 0;
+    int i = 0, over = 0, res = 0;
+    FILE *fp = NULL;
+
+    if (argc == 3 && strcmp(argv[1], "-g") == 0)
+    {
+        return seed_write(argv[2]);
+    }
+    for (i = (argc > 1) ? 1 : 0; i < argc; ++i)
+    {
+        fp = (argc > 1) ? fopen(argv[i], "rb") : stdin;
+        if (fp == NULL)
+        {
+            fprintf(stderr, "open [%s] failed\n", argv[i]);
+            return 2;
+        }
+        size = fread(data, 1, sizeof(data), fp);
+        if (fp != stdin)
+        {
+            fclose(fp);
+        }
+        over = fuzz_session(data, size);
+        fuzz_report(stdout, (argc > 1) ? argv[i] : "stdin", size, over);
+        if (over != 0)
+        {
+            res = 1;
+#ifdef XYM_FUZZ_ABORT
+            abort(); /* make AFL keep it as a crash */
+#endif
+        }
+    }
+    return res;
+}
+#endif
@@ -0,0 +1,347 @@
+/**
+ *******************************************************************************************************************************************
+ * @file        xym_log.c
+ * @brief       X / Y modem deferred log decoder: format a memory dump of [xym_log] with the firmware image [xym-log]
+ * @since       Change Logs:
+ * Date         Author       Notes
+ * 2026-10-18   lzh          the first version
+ * @copyright (c) 2023 lzh <lzhoran@163.com>
+ *                https://github.com/ZeHHHHH/Flexible-XYmodem.git
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *******************************************************************************************************************************************
+ */
+/*
+ * The target only stores the address of the format string, a time stamp and the raw arguments(xymodem_log.h).
+ * The records are formatted here, on the host, from:
+ *   IMAGE : the firmware as it is in ROM(objcopy -O binary firmware.elf firmware.bin), loaded at ADDR
+ *   DUMP  : the memory of [xym_log] saved by the debugger, eg:
+ *           J-Link : savebin xym.dump, <&xym_log>, <sizeof(xym_log)>
+ *           gdb    : dump binary memory xym.dump &xym_log (char *)&xym_log + sizeof(xym_log)
+ * The dump may be larger(eg: the whole RAM), [xym_log] is found by its magic. The pointer size and the byte order
+ * of the target come from the header, the records are never read on the target itself.
+ *
+ * gcc -O2 -I. tools/xym_log.c -o xym-log
+ */
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/*******************************************************************************************************************************************
+ * Private Define
+ *******************************************************************************************************************************************/
+#define LOG_MAGIC        (0x4C4D5958) /* XYM_LOG_MAGIC */
+#define LOG_HEAD_SIZE    (20)         /* magic, depth, args, rec_size, wr, rd, lost */
+#define LOG_SPEC_MAX     (32)         /* one conversion specification / Bytes */
+
+/* [xym_log] found in the dump */
+typedef struct log_ring
+{
+    const uint8_t *base;   /* &xym_log in the dump */
+    int swap;              /* the target is big-endian */
+    uint32_t depth;
+    uint32_t args;
+    uint32_t rec_size;
+    uint32_t ptr_size;     /* 4: 32 bits target, 8: 64 bits(host test) */
+    uint32_t rec_off;      /* offset of rec[] */
+    uint32_t wr, rd, lost;
+} log_ring_t;
+
+/* file in memory */
+typedef struct log_file
+{
+    uint8_t *data;
+    size_t size;
+} log_file_t;
+
+/*******************************************************************************************************************************************
+ * Private Variable
+ *******************************************************************************************************************************************/
+static const char usage[] =
+    "usage: xym-log [options] IMAGE DUMP\n"
+    "  -a ADDR   load address of IMAGE (default 0, eg: 0x08000000)\n"
+    "  -n        only the records not yet formatted by [xymodem_log_flush] on the target\n"
+    "  -h        help\n";
+
+static log_file_t image;
+static uint64_t image_addr = 0;
+
+/*******************************************************************************************************************************************
+ * Private Function
+ *******************************************************************************************************************************************/
+/* read a whole file, 0: success */
+static int log_load(const char *path, log_file_t *f)
+{
+    FILE *fp = fopen(path, "rb");
+    long len = 0;
+
+    if (fp == NULL || fseek(fp, 0, SEEK_END) != 0 || (len = ftell(fp)) < 0 || fseek(fp, 0, SEEK_SET) != 0)
+    {
+        perror(path);
+        if (fp != NULL)
+        {
+            fclose(fp);
+        }
+        return -1;
+    }
+    f->size = (size_t)len;
+    f->data = malloc(f->size + 1);
+    if (f->data == NULL || fread(f->data, 1, f->size, fp) != f->size)
+    {
+        perror(path);
+        fclose(fp);
+        return -1;
+    }
+    f->data[f->size] = 0;
+    fclose(fp);
+    return 0;
+}
+
+/* target value of [n] Bytes */
+static uint64_t log_get(const log_ring_t *r, const uint8_t *p, const uint32_t n)
+{
+    uint64_t v = 0;
+    uint32_t i = 0;
+
+    for (i = 0; i < n; ++i)
+    {
+        v |= (uint64_t)p[r->swap ? (n - 1 - i) : i] << (8 * i);
+    }
+    return v;
+}
+
+/* string of the image at a target address, NULL: not in the image */
+static const char *log_str(const uint64_t addr)
+{
+    if (addr < image_addr || addr - image_addr >= image.size)
+    {
+        return NULL;
+    }
+    /* the image is 0 terminated by [log_load] */
+    return (const char *)image.data + (addr - image_addr);
+}
+
+/* find [xym_log] in the dump, 0: success */
+static int log_find(const log_file_t *dump, log_ring_t *r)
+{
+    size_t off = 0;
+    uint32_t fixed = 0;
+
+    for (off = 0; off + LOG_HEAD_SIZE <= dump->size; off += 4)
+    {
+        memset(r, 0, sizeof(*r));
+        r->base = dump->data + off;
+        if (log_get(r, r->base, 4) != LOG_MAGIC)
+        {
+            r->swap = 1;
+            if (log_get(r, r->base, 4) != LOG_MAGIC)
+            {
+                continue;
+            }
+        }
+        r->depth = (uint32_t)log_get(r, r->base + 4, 2);
+        r->args = r->base[6];
+        r->rec_size = r->base[7];
+        fixed = 4 + 4 * r->args;
+        /* fmt, tick, arg[]: the pointer is what remains, padded to its own alignment */
+        r->ptr_size = (r->rec_size >= fixed + 8) ? 8 : 4;
+        r->rec_off = (LOG_HEAD_SIZE + r->ptr_size - 1) / r->ptr_size * r->ptr_size;
+        if (r->depth == 0 || (r->depth & (r->depth - 1)) != 0 || r->rec_size < fixed + 4 ||
+            off + r->rec_off + (size_t)r->depth * r->rec_size > dump->size)
+        {
+            continue;
+        }
+        r->wr = (uint32_t)log_get(r, r->base + 8, 4);
+        r->rd = (uint32_t)log_get(r, r->base + 12, 4);
+        r->lost = (uint32_t)log_get(r, r->base + 16, 4);
+        return 0;
+    }
+    return -1;
+}
+
+/* format one record: the conversions one by one, each with the argument cast to what it expects */
+static void log_format(const log_ring_t *r, const char *fmt, const uint32_t *arg)
+{
+    char spec[LOG_SPEC_MAX];
+    uint32_t n = 0, len = 0;
+    const char *s = NULL;
+    int star[2] = {0, 0}, stars = 0, i = 0;
+
+#define NEXT_ARG() ((n < r->args) ? arg[n++] : 0)
+    for (; *fmt != '\0'; ++fmt)
+    {
+        if (*fmt != '%')
+        {
+            if (*fmt != '\r')
+            {
+                putchar(*fmt);
+            }
+            continue;
+        }
+        if (fmt[1] == '%')
+        {
+            putchar('%');
+            ++fmt;
+            continue;
+        }
+
+        /* flags, width, precision: kept; length modifiers: dropped, every argument is 32 bits */
+        len = 0;
+        stars = 0;
+        spec[len++] = *fmt++;
+        while (*fmt != '\0' && strchr("-+ #0123456789.*hlLqjzt", *fmt) != NULL)
+        {
+            if (*fmt == '*' && stars < 2)
+            {
+                star[stars++] = (int)NEXT_ARG();
+            }
+            if (strchr("hlLqjzt", *fmt) == NULL && len < LOG_SPEC_MAX - 2)
+            {
+                spec[len++] = *fmt;
+            }
+            ++fmt;
+        }
+        if (*fmt == '\0')
+        {
+            break;
+        }
+        spec[len++] = *fmt;
+        spec[len] = '\0';
+
+        switch (*fmt)
+        {
+        case 'd':
+        case 'i':
+            i = (int)(int32_t)NEXT_ARG();
+            (stars == 2) ? printf(spec, star[0], star[1], i) : (stars == 1) ? printf(spec, star[0], i) : printf(spec, i);
+            break;
+        case 'u':
+        case 'x':
+        case 'X':
+        case 'o':
+        case 'c':
+            i = (int)NEXT_ARG();
+            (stars == 2) ? printf(spec, star[0], star[1], (unsigned)i) :
+            (stars == 1) ? printf(spec, star[0], (unsigned)i) : printf(spec, (unsigned)i);
+            break;
+        case 's':
+            i = (int)NEXT_ARG();
+            s = log_str((uint32_t)i);
+            if (s == NULL)
+            {
+                printf("<0x%08x>", (unsigned)i);
+                break;
+            }
+            (stars == 2) ? printf(spec, star[0], star[1], s) : (stars == 1) ? printf(spec, star[0], s) : printf(spec, s);
+            break;
+        case 'p':
+            printf("0x%08x", (unsigned)NEXT_ARG());
+            break;
+        default:
+            /* not an integer conversion(eg: %f): shown as it is */
+            printf("%s", spec);
+            break;
+        }
+    }
+#undef NEXT_ARG
+}
+
+/*******************************************************************************************************************************************
+ * Public Function
+ *******************************************************************************************************************************************/
+int main(int argc, char **argv)
+{
+    log_file_t dump = {NULL, 0};
+    log_ring_t r;
+    uint32_t first = 0, seq = 0, a = 0;
+    uint32_t arg[256];
+    const uint8_t *p = NULL;
+    const char *fmt = NULL;
+    uint64_t fmt_addr = 0;
+    int opt = 0, unread = 0;
+
+    while ((opt = getopt(argc, argv, "a:nh")) != -1)
+    {
+        switch (opt)
+        {
+        case 'a': image_addr = strtoull(optarg, NULL, 0); break;
+        case 'n': unread = 1; break;
+        case 'h':
+        default:
+            fprintf(stderr, "%s", usage);
+            return 2;
+        }
+    }
+    if (argc - optind != 2)
+    {
+        fprintf(stderr, "%s", usage);
+        return 2;
+    }
+    if (log_load(argv[optind], &image) != 0 || log_load(argv[optind + 1], &dump) != 0)
+    {
+        return 2;
+    }
+    if (log_find(&dump, &r) != 0)
+    {
+        fprintf(stderr, "%s: no [xym_log] found (magic 0x%08X)\n", argv[optind + 1], LOG_MAGIC);
+        return 1;
+    }
+
+    /* the oldest record still in the ring */
+    first = (r.wr > r.depth) ? r.wr - r.depth : 0;
+    fprintf(stderr, "xym_log: %u bits %s-endian, depth %u, written %u, formatted on the target %u\n",
+            (unsigned)(r.ptr_size * 8), r.swap ? "big" : "little", (unsigned)r.depth, (unsigned)r.wr, (unsigned)r.rd);
+    if (unread == 0 && first > 0)
+    {
+        printf("[xym-log] %u older records overwritten\n", (unsigned)first);
+    }
+    else if (unread != 0)
+    {
+        if (r.wr - r.rd <= r.wr - first)
+        {
+            first = r.rd;
+        }
+        if (first - r.rd + r.lost > 0)
+        {
+            printf("[xym-log] %u records lost\n", (unsigned)(first - r.rd + r.lost));
+        }
+    }
+
+    for (seq = first; seq != r.wr; ++seq)
+    {
+        p = r.base + r.rec_off + (size_t)(seq & (r.depth - 1)) * r.rec_size;
+        fmt_addr = log_get(&r, p, r.ptr_size);
+        for (a = 0; a < r.args && a < sizeof(arg) / sizeof(arg[0]); ++a)
+        {
+            arg[a] = (uint32_t)log_get(&r, p + r.ptr_size + 4 + 4 * a, 4);
+        }
+        printf("[%10lu] ", (unsigned long)log_get(&r, p + r.ptr_size, 4));
+        fmt = log_str(fmt_addr);
+        if (fmt == NULL)
+        {
+            /* wrong image / ADDR, or a format string in RAM */
+            printf("<fmt 0x%08llx>", (unsigned long long)fmt_addr);
+            for (a = 0; a < r.args; ++a)
+            {
+                printf(" 0x%08x", (unsigned)arg[a]);
+            }
+            putchar('\n');
+            continue;
+        }
+        log_format(&r, fmt, arg);
+    }
+    return 0;
+}
@@ -0,0 +1,683 @@
+/**
+ *******************************************************************************************************************************************
+ * @file        xym_mem.c
+ * @brief       X / Y modem stack high-water and memory footprint of every protocol path [xym-mem]
+ * @since       Change Logs:
+ * Date         Author       Notes
+ * 2026-10-18   lzh          the first version
+ * @copyright (c) 2023 lzh <lzhoran@163.com>
+ *                https://github.com/ZeHHHHH/Flexible-XYmodem.git
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *******************************************************************************************************************************************
+ */
+/*
+ * Each peer of a case (sender, receiver, pipeline worker, device behind the relay) runs in a thread on its own stack: the stack is painted
+ * before the thread starts and has a PROT_NONE guard page below it, so an overflow faults instead of passing silently.
+ * After the case, the untouched paint gives the high-water mark, minus the base of an idle thread (libc / TLS).
+ * Sessions and data buffers are static, they are reported in the footprint table instead of the stack.
+ *
+ * The peers are the library itself on both sides, over an in-memory link(tick = 1 ms).
+ * The stack depends on the compiler, options and target: build with the flags of the firmware to compare,
+ * eg: gcc -O2 / -Os, -DXYM_RX_BUFF_SIZE=256, -DXYM_VERIFY_SHA256=0.
+ *
+ * gcc -O2 -I. tools/xym_mem.c xymodem.c xymodem_pipe.c xymodem_relay.c xymodem_verify.c -lpthread -o xym-mem
+ */
+#define _DEFAULT_SOURCE
+#include <errno.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <unistd.h>
+#include "xymodem.h"
+#include "xymodem_pipe.h"
+#include "xymodem_relay.h"
+#include "xymodem_verify.h"
+
+/*******************************************************************************************************************************************
+ * Private Define
+ *******************************************************************************************************************************************/
+#define MEM_STACK_SIZE          (256 * 1024) /* stack of each peer / Bytes */
+#define MEM_PAINT               (0xA5)       /* stack paint */
+#define MEM_FIFO_SIZE           (16 * 1024)  /* in-memory link, each direction / Bytes */
+#define MEM_IMAGE_MAX           (1 << 20)    /* max image size / Bytes */
+#define MEM_TIMEOUT             (1000)       /* send / receive timeout / ms */
+
+/* peer of a case, runs in its own thread */
+typedef void (*mem_role_t)(void);
+
+/* protocol path */
+typedef struct mem_case
+{
+    const char *name;
+    mem_role_t tx;       /* sender */
+    mem_role_t rx;       /* receiver (the pipeline I/O stage) */
+    mem_role_t worker;   /* pipeline worker stage (the relay downstream), NULL: none */
+    mem_role_t dev;      /* receiver behind the relay, NULL: none */
+    xym_sta_t tx_end;    /* expected results */
+    xym_sta_t rx_end;
+} mem_case_t;
+
+/* thread of a peer */
+typedef struct mem_peer
+{
+    mem_role_t role;
+    int side;            /* 0: sender, 1: receiver, 2: relay downstream, 3: device */
+    pthread_t tid;
+    uint8_t *stack;      /* MEM_STACK_SIZE Bytes above the guard page */
+} mem_peer_t;
+
+/* one direction of the link */
+typedef struct mem_fifo
+{
+    uint8_t buff[MEM_FIFO_SIZE];
+    uint32_t rd;
+    uint32_t wr;
+} mem_fifo_t;
+
+/*******************************************************************************************************************************************
+ * Private Variable
+ *******************************************************************************************************************************************/
+static const char usage[] =
+    "usage: xym-mem [options]\n"
+    "  -n SIZE   image size of each path (default 20000)\n"
+    "  -s BYTES  stack budget, exit 1 if a peer of a path needs more(eg: 2048)\n"
+    "  -h        help\n";
+
+static pthread_mutex_t link_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t link_cond = PTHREAD_COND_INITIALIZER;
+static mem_fifo_t fifo[4];            /* fifo[n] : to the side n, links 0 - 1 and 2 - 3 */
+static __thread int self;             /* side of this peer */
+
+static xym_session_t session[4];      /* sessions of the sides */
+static xym_pipe_t pipeline;
+static xym_relay_t relay;
+static uint8_t image[MEM_IMAGE_MAX];  /* sent image */
+static uint8_t recvd[MEM_IMAGE_MAX];  /* received image */
+static uint32_t image_size = 20000;
+static uint32_t recvd_size;
+static xym_sta_t tx_res, rx_res;
+static xym_sta_t up_res, down_res;    /* results of the relay stages */
+static xym_pcache_entry_t cached;     /* fast start / checksum entry of the case */
+
+/*******************************************************************************************************************************************
+ * Private Function
+ *******************************************************************************************************************************************/
+/* deadline after [ms] */
+static struct timespec deadline(const uint32_t ms)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_REALTIME, &ts);
+    ts.tv_sec += ms / 1000;
+    ts.tv_nsec += (long)(ms % 1000) * 1000000L;
+    if (ts.tv_nsec >= 1000000000L)
+    {
+        ts.tv_sec += 1;
+        ts.tv_nsec -= 1000000000L;
+    }
+    return ts;
+}
+
+static xym_sta_t mem_send(const uint8_t *data, const uint32_t cnt, const uint32_t tick)
+{
+    mem_fifo_t *f = &fifo[self ^ 1];
+    struct timespec ts = deadline(tick);
+    uint32_t i = 0;
+
+    pthread_mutex_lock(&link_lock);
+    for (i = 0; i < cnt; ++i)
+    {
+        while (f->wr - f->rd >= MEM_FIFO_SIZE)
+        {
+            if (pthread_cond_timedwait(&link_cond, &link_lock, &ts) == ETIMEDOUT)
+            {
+                pthread_mutex_unlock(&link_lock);
+                return XYM_ERROR_TIMEOUT;
+            }
+        }
+        f->buff[f->wr++ % MEM_FIFO_SIZE] = data[i];
+    }
+    pthread_cond_broadcast(&link_cond);
+    pthread_mutex_unlock(&link_lock);
+    return XYM_OK;
+}
+
+static xym_sta_t mem_read(uint8_t *data, const uint32_t cnt, uint32_t *got, const uint32_t tick)
+{
+    mem_fifo_t *f = &fifo[self];
+    struct timespec ts = deadline(tick);
+    uint32_t n = 0;
+
+    pthread_mutex_lock(&link_lock);
+    while (f->wr == f->rd)
+    {
+        if (pthread_cond_timedwait(&link_cond, &link_lock, &ts) == ETIMEDOUT)
+        {
+            pthread_mutex_unlock(&link_lock);
+            return XYM_ERROR_TIMEOUT;
+        }
+    }
+    for (n = 0; n < cnt && f->rd != f->wr; ++n)
+    {
+        data[n] = f->buff[f->rd++ % MEM_FIFO_SIZE];
+    }
+    pthread_cond_broadcast(&link_cond);
+    pthread_mutex_unlock(&link_lock);
+    *got = n;
+    return XYM_OK;
+}
+
+static xym_sta_t mem_recv(uint8_t *data, const uint32_t cnt, const uint32_t tick)
+{
+    uint32_t i = 0, got = 0;
+
+    for (i = 0; i < cnt; i += got)
+    {
+        if (XYM_OK != mem_read(&data[i], 1, &got, tick))
+        {
+            return XYM_ERROR_TIMEOUT;
+        }
+    }
+    return XYM_OK;
+}
+
+/* session of this peer */
+static xym_session_t *mem_session(void)
+{
+    struct xym_ops ops = {mem_send, mem_recv, NULL, NULL, NULL, mem_read};
+    struct xym_param param = {MEM_TIMEOUT, MEM_TIMEOUT, 10, 0, 0, NULL};
+
+    xymodem_session_init(&session[self], ops, param);
+    return &session[self];
+}
+
+/* store a received packet, the Ymodem file info is not data */
+static void mem_store(const xym_sta_t sta, const uint8_t *data, const uint16_t size)
+{
+    if (sta == XYM_OK && recvd_size + size <= MEM_IMAGE_MAX)
+    {
+        memcpy(&recvd[recvd_size], data, size);
+        recvd_size += size;
+    }
+}
+
+/* Xmodem: packet by packet from the frame buffer */
+static void tx_xmodem(void)
+{
+    xym_session_t *p = mem_session();
+    uint32_t i = 0, n = 0;
+
+    xmodem_init(p);
+    xymodem_fast_start(p, cached.valid ? &cached : NULL);
+    for (tx_res = XYM_OK; tx_res == XYM_OK && i < image_size; i += n)
+    {
+        n = (image_size - i < XYM_PKT_SIZE_1024) ? image_size - i : XYM_PKT_SIZE_1024;
+        memcpy(xymodem_frame_data(p), &image[i], n);
+        tx_res = xmodem_transmit(p, xymodem_frame_data(p), (uint16_t)n);
+    }
+    tx_res = (tx_res == XYM_OK) ? xmodem_transmit(p, NULL, 0) : tx_res;
+}
+
+/* Xmodem-128 from a user buffer */
+static void tx_xmodem_128(void)
+{
+    xym_session_t *p = mem_session();
+    uint32_t i = 0, n = 0;
+
+    xmodem_init(p);
+    for (tx_res = XYM_OK; tx_res == XYM_OK && i < image_size; i += n)
+    {
+        n = (image_size - i < XYM_PKT_SIZE_128) ? image_size - i : XYM_PKT_SIZE_128;
+        tx_res = xmodem_transmit(p, &image[i], (uint16_t)n);
+    }
+    tx_res = (tx_res == XYM_OK) ? xmodem_transmit(p, NULL, 0) : tx_res;
+}
+
+/* Xmodem: the image in place */
+static void tx_xmodem_span(void)
+{
+    xym_session_t *p = mem_session();
+
+    xmodem_init(p);
+    tx_res = xmodem_transmit_span(p, image, image_size, NULL);
+    tx_res = (tx_res == XYM_OK) ? xmodem_transmit(p, NULL, 0) : tx_res;
+}
+
+/* Xmodem: cancel after some packets */
+static void tx_xmodem_cancel(void)
+{
+    xym_session_t *p = mem_session();
+
+    xmodem_init(p);
+    tx_res = xmodem_transmit_span(p, image, XYM_PKT_SIZE_1024 * 2, NULL);
+    tx_res = (tx_res == XYM_OK) ? xymodem_active_cancel(p) : tx_res;
+}
+
+/* Ymodem: an empty file first if [empty], file info, data from the frame buffer or in place, end of batch */
+static void tx_ymodem_common(const uint8_t span, const uint8_t empty)
+{
+    xym_session_t *p = mem_session();
+    uint8_t *buff = xymodem_frame_data(p);
+    uint32_t i = 0, n = 0;
+
+    ymodem_init(p);
+    xymodem_fast_start(p, cached.valid ? &cached : NULL);
+    tx_res = XYM_FIL_SET;
+    if (empty != 0)
+    {
+        memset(buff, 0, XYM_PKT_SIZE_128);
+        memcpy(buff, "empty.bin\0" "0", sizeof("empty.bin\0" "0"));
+        tx_res = ymodem_transmit(p, buff, XYM_PKT_SIZE_128);
+        tx_res = (tx_res == XYM_OK) ? ymodem_transmit_eof(p) : tx_res;
+    }
+    if (tx_res != XYM_FIL_SET)
+    {
+        return;
+    }
+    memset(buff, 0, XYM_PKT_SIZE_128);
+    memcpy(buff, "image.bin", sizeof("image.bin")); /* no libc formatting in the measured paths */
+    for (i = image_size, n = 1; i >= 10; i /= 10, ++n)
+    {
+    }
+    for (i = image_size; n > 0; i /= 10)
+    {
+        buff[sizeof("image.bin") - 1 + n--] = (uint8_t)('0' + i % 10);
+    }
+    i = 0;
+    tx_res = ymodem_transmit(p, buff, XYM_PKT_SIZE_128);
+    if (span != 0 && tx_res == XYM_OK)
+    {
+        tx_res = ymodem_transmit_span(p, image, image_size, NULL);
+        i = image_size;
+    }
+    for (; tx_res == XYM_OK && i < image_size; i += n)
+    {
+        n = (image_size - i < XYM_PKT_SIZE_1024) ? image_size - i : XYM_PKT_SIZE_1024;
+        memcpy(buff, &image[i], n);
+        tx_res = ymodem_transmit(p, buff, (uint16_t)n);
+    }
+    tx_res = (tx_res == XYM_OK) ? ymodem_transmit_eof(p) : tx_res;
+    if (tx_res == XYM_FIL_SET)
+    {
+        memset(buff, 0, XYM_PKT_SIZE_128);
+        tx_res = ymodem_transmit(p, buff, 0);
+    }
+}
+
+static void tx_ymodem(void)
+{
+    tx_ymodem_common(0, 0);
+}
+
+static void tx_ymodem_span(void)
+{
+    tx_ymodem_common(1, 0);
+}
+
+/* Ymodem: an empty file in the middle of the batch */
+static void tx_ymodem_empty(void)
+{
+    tx_ymodem_common(0, 1);
+}
+
+/* Ymodem, then verify the image remotely by both digests */
+static void tx_ymodem_verify(void)
+{
+    uint8_t digest[XYM_DIGEST_SIZE_MAX];
+    xym_digest_t d;
+    uint8_t alg = 0;
+
+    tx_ymodem_common(1, 0);
+    for (alg = XYM_DIGEST_CRC32; tx_res == XYM_END && alg <= (XYM_VERIFY_SHA256 ? XYM_DIGEST_SHA256 : XYM_DIGEST_CRC32); ++alg)
+    {
+        xymodem_digest_init(&d, (xym_digest_alg_t)alg);
+        xymodem_digest_update(&d, image, image_size);
+        xymodem_digest_final(&d, digest);
+        tx_res = (XYM_OK == xymodem_verify_remote(&session[self], (xym_digest_alg_t)alg, 0, image_size, digest, MEM_TIMEOUT)) ?
+                 XYM_END : XYM_ERROR_INVALID_DATA;
+    }
+}
+
+/* Xmodem: data returned in the frame buffer */
+static void rx_xmodem(void)
+{
+    xym_session_t *p = mem_session();
+    uint16_t len = 0;
+
+    xmodem_init(p);
+    xymodem_fast_start(p, cached.valid ? &cached : NULL);
+    while (XYM_OK == (rx_res = xmodem_receive(p, NULL, &len)))
+    {
+        mem_store(rx_res, xymodem_frame_data(p), len);
+    }
+}
+
+/* Xmodem: data copied to a user buffer, verified by the caller */
+static void rx_xmodem_defer(void)
+{
+    static uint8_t buff[XYM_PKT_SIZE_1024];
+    xym_session_t *p = mem_session();
+    uint16_t len = 0;
+
+    xmodem_init(p);
+    xymodem_verify_defer(p, 1);
+    while (XYM_OK == (rx_res = xmodem_receive(p, NULL, &len)))
+    {
+        if (0 == xymodem_frame_check(p, xymodem_frame_data(p), len, &xymodem_frame_data(p)[len]))
+        {
+            xymodem_receive_reject(p);
+            continue;
+        }
+        memcpy(buff, xymodem_frame_data(p), len);
+        mem_store(rx_res, buff, len);
+    }
+}
+
+/* Xmodem: data straight into the segments */
+static void rx_xmodem_scatter(void)
+{
+    xym_session_t *p = mem_session();
+    xym_seg_t seg[2] = {{recvd, 0, 4096}, {&recvd[4096], 4096, MEM_IMAGE_MAX - 4096}};
+    uint16_t len = 0;
+
+    xmodem_init(p);
+    xymodem_scatter_set(p, seg, 2);
+    while (XYM_OK == (rx_res = xmodem_receive(p, NULL, &len)))
+    {
+        recvd_size += len;
+    }
+}
+
+/* Ymodem: data returned in the frame buffer */
+static void rx_ymodem(void)
+{
+    xym_session_t *p = mem_session();
+    uint16_t len = 0;
+
+    ymodem_init(p);
+    xymodem_fast_start(p, cached.valid ? &cached : NULL);
+    for (;;)
+    {
+        rx_res = ymodem_receive(p, NULL, &len);
+        if (rx_res != XYM_OK && rx_res != XYM_FIL_GET)
+        {
+            break;
+        }
+        mem_store(rx_res, xymodem_frame_data(p), len);
+    }
+}
+
+/* read the received image for the remote verification */
+static xym_sta_t rx_image_read(void *user, const uint32_t offset, uint8_t *data, const uint32_t cnt)
+{
+    (void)user;
+    if (offset > recvd_size || cnt > recvd_size - offset)
+    {
+        return XYM_ERROR_INVALID_DATA;
+    }
+    memcpy(data, &recvd[offset], cnt);
+    return XYM_OK;
+}
+
+/* Ymodem, then serve the verification requests */
+static void rx_ymodem_verify(void)
+{
+    rx_ymodem();
+    while (rx_res == XYM_END && XYM_OK == xymodem_verify_serve(&session[self], rx_image_read, NULL, MEM_TIMEOUT / 4))
+    {
+    }
+}
+
+/* storage of the pipeline worker */
+static xym_sta_t pipe_sink(void *user, const xym_sta_t sta, const uint8_t *data, const uint16_t size)
+{
+    (void)user;
+    mem_store(sta, data, size);
+    return XYM_OK;
+}
+
+/* Ymodem pipeline: I/O stage */
+static void rx_ymodem_pipe(void)
+{
+    xym_session_t *p = mem_session();
+
+    xymodem_pipe_init(&pipeline, p, 1, pipe_sink, NULL);
+    rx_res = xymodem_pipe_io(&pipeline);
+}
+
+/* Ymodem pipeline: worker stage, started with the I/O stage */
+static void rx_ymodem_pipe_worker(void)
+{
+    while (pipeline.p == NULL)
+    {
+        sched_yield();
+    }
+    xymodem_pipe_worker(&pipeline);
+}
+
+/* Ymodem relay: upstream stage, forwards to the device(side 3) */
+static void rx_ymodem_relay(void)
+{
+    xymodem_relay_init(&relay, mem_session(), &session[2]);
+    up_res = xymodem_relay_upstream(&relay);
+}
+
+/* Ymodem relay: downstream stage, started with the upstream stage */
+static void rx_ymodem_relay_down(void)
+{
+    while (relay.pipe.p == NULL)
+    {
+        sched_yield();
+    }
+    (void)mem_session();
+    down_res = xymodem_relay_downstream(&relay);
+}
+
+/* base of an idle peer */
+static void role_idle(void)
+{
+}
+
+static const mem_case_t cases[] = {
+    {"xmodem-crc-1k",      tx_xmodem,        rx_xmodem,         NULL, NULL, XYM_END,           XYM_END},
+    {"xmodem-crc-128",     tx_xmodem_128,    rx_xmodem,         NULL, NULL, XYM_END,           XYM_END},
+    {"xmodem-checksum",    tx_xmodem,        rx_xmodem,         NULL, NULL, XYM_END,           XYM_END},
+    {"xmodem-fast-start",  tx_xmodem,        rx_xmodem,         NULL, NULL, XYM_END,           XYM_END},
+    {"xmodem-span",        tx_xmodem_span,   rx_xmodem,         NULL, NULL, XYM_END,           XYM_END},
+    {"xmodem-defer",       tx_xmodem,        rx_xmodem_defer,   NULL, NULL, XYM_END,           XYM_END},
+    {"xmodem-scatter",     tx_xmodem,        rx_xmodem_scatter, NULL, NULL, XYM_END,           XYM_END},
+    {"xmodem-cancel",      tx_xmodem_cancel, rx_xmodem,         NULL, NULL, XYM_CANCEL_ACTIVE, XYM_CANCEL_REMOTE},
+    {"ymodem-1k",          tx_ymodem,        rx_ymodem,         NULL, NULL, XYM_END,           XYM_END},
+    {"ymodem-span",        tx_ymodem_span,   rx_ymodem,         NULL, NULL, XYM_END,           XYM_END},
+    {"ymodem-fast-start",  tx_ymodem,        rx_ymodem,         NULL, NULL, XYM_END,           XYM_END},
+    {"ymodem-empty-file",  tx_ymodem_empty,  rx_ymodem,         NULL, NULL, XYM_END,           XYM_END},
+    {"ymodem-pipeline",    tx_ymodem,        rx_ymodem_pipe,    rx_ymodem_pipe_worker, NULL, XYM_END, XYM_END},
+    {"ymodem-verify",      tx_ymodem_verify, rx_ymodem_verify,  NULL, NULL, XYM_END,           XYM_END},
+    {"ymodem-relay",       tx_ymodem,        rx_ymodem_relay,   rx_ymodem_relay_down, rx_ymodem, XYM_END, XYM_END},
+    {"ymodem-relay-empty", tx_ymodem_empty,  rx_ymodem_relay,   rx_ymodem_relay_down, rx_ymodem, XYM_END, XYM_END},
+};
+
+/* thread of a peer */
+static void *mem_thread(void *arg)
+{
+    const mem_peer_t *peer = (const mem_peer_t *)arg;
+
+    self = peer->side;
+    peer->role();
+    return NULL;
+}
+
+/**
+ * @brief  start a peer on a painted stack with a guard page below
+ * @param  peer : peer, [role] and [side] set
+ * @retval 0: success
+ */
+static int mem_start(mem_peer_t *peer)
+{
+    long page = sysconf(_SC_PAGESIZE);
+    pthread_attr_t attr;
+    uint8_t *map = mmap(NULL, MEM_STACK_SIZE + (size_t)page, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    int ret = 0;
+
+    if (map == MAP_FAILED || mprotect(map, (size_t)page, PROT_NONE) != 0)
+    {
+        return -1;
+    }
+    peer->stack = map + page;
+    memset(peer->stack, MEM_PAINT, MEM_STACK_SIZE);
+    pthread_attr_init(&attr);
+    pthread_attr_setstack(&attr, peer->stack, MEM_STACK_SIZE);
+    ret = pthread_create(&peer->tid, &attr, mem_thread, peer);
+    pthread_attr_destroy(&attr);
+    return ret;
+}
+
+/* join a peer and return its stack high-water / Bytes */
+static uint32_t mem_join(mem_peer_t *peer)
+{
+    long page = sysconf(_SC_PAGESIZE);
+    uint32_t i = 0;
+
+    pthread_join(peer->tid, NULL);
+    for (i = 0; i < MEM_STACK_SIZE && peer->stack[i] == MEM_PAINT; ++i)
+    {
+    }
+    munmap(peer->stack - page, MEM_STACK_SIZE + (size_t)page);
+    return MEM_STACK_SIZE - i;
+}
+
+/**
+ * @brief  run a path
+ * @param  c    : path
+ * @param  peak : returned stack high-water of the sender / receiver / worker / device, Bytes
+ * @retval 0: success, 1: unexpected result or data
+ */
+static int mem_run(const mem_case_t *c, uint32_t peak[4])
+{
+    mem_peer_t peer[4] = {{c->tx, 0, 0, NULL}, {c->rx, 1, 0, NULL}, {c->worker, 2, 0, NULL}, {c->dev, 3, 0, NULL}};
+    int i = 0;
+
+    memset(fifo, 0, sizeof(fifo));
+    memset(&pipeline, 0, sizeof(pipeline));
+    memset(&relay, 0, sizeof(relay));
+    up_res = down_res = XYM_END;
+    memset(recvd, 0, sizeof(recvd));
+    recvd_size = 0;
+    memset(&cached, 0, sizeof(cached));
+    cached.valid = (strstr(c->name, "fast-start") != NULL || strstr(c->name, "checksum") != NULL);
+    cached.crc_flag = (strstr(c->name, "checksum") == NULL);
+    cached.pkt_1k = 1;
+    cached.profile = XYM_PROFILE_FLEXIBLE;
+
+    for (i = 0; i < 4; ++i)
+    {
+        if (peer[i].role != NULL && mem_start(&peer[i]) != 0)
+        {
+            fprintf(stderr, "start the peer failed\n");
+            exit(2);
+        }
+    }
+    for (i = 0; i < 4; ++i)
+    {
+        peak[i] = (peer[i].role != NULL) ? mem_join(&peer[i]) : 0;
+    }
+    if (tx_res != c->tx_end || rx_res != c->rx_end || up_res != XYM_END || down_res != XYM_END)
+    {
+        return 1;
+    }
+    return (c->tx_end == XYM_END && (recvd_size < image_size || memcmp(recvd, image, image_size) != 0)) ? 1 : 0;
+}
+
+/* static memory of the build configuration */
+static void mem_footprint(void)
+{
+    printf("configuration: XYM_RX_BUFF_SIZE=%d XYM_FRAME_ALIGN=%d XYM_PIPE_DEPTH=%d XYM_VERIFY_SHA256=%d\n",
+           XYM_RX_BUFF_SIZE, XYM_FRAME_ALIGN, XYM_PIPE_DEPTH, XYM_VERIFY_SHA256);
+    printf("static memory / Bytes:\n");
+    printf("  %-28s %6u  (frame buffer %u", "xym_session_t", (unsigned)sizeof(xym_session_t), (unsigned)sizeof(xym_frame_t));
+#if XYM_RX_BUFF_SIZE > 0
+    printf(", read-ahead %u", (unsigned)sizeof(xym_rxbuf_t));
+#endif
+    printf(")\n");
+    printf("  %-28s %6u  (%d slots)\n", "xym_pipe_t", (unsigned)sizeof(xym_pipe_t), XYM_PIPE_DEPTH);
+    printf("  %-28s %6u\n", "xym_digest_t", (unsigned)sizeof(xym_digest_t));
+    printf("  %-28s %6u  (+ %u per session)\n", "xym_pool_t", (unsigned)sizeof(xym_pool_t),
+           (unsigned)(sizeof(xym_session_t) + sizeof(uint16_t)));
+    printf("  %-28s %6u  (+ %u per device)\n", "xym_pcache_t", (unsigned)sizeof(xym_pcache_t), (unsigned)sizeof(xym_pcache_entry_t));
+    printf("  %-28s %6u  (a session on the stack adds it to the stack below)\n", "caller data buffer", XYM_PKT_SIZE_1024);
+}
+
+/*******************************************************************************************************************************************
+ * Public Function
+ *******************************************************************************************************************************************/
+int main(int argc, char **argv)
+{
+    mem_peer_t idle = {role_idle, 0, 0, NULL};
+    uint32_t budget = 0, base = 0, peak[4], worst = 0;
+    uint32_t i = 0, j = 0;
+    int opt = 0, fail = 0, res = 0, over = 0;
+
+    while ((opt = getopt(argc, argv, "n:s:h")) != -1)
+    {
+        switch (opt)
+        {
+        case 'n': image_size = (uint32_t)strtoul(optarg, NULL, 0); break;
+        case 's': budget = (uint32_t)strtoul(optarg, NULL, 0); break;
+        case 'h':
+        default:
+            fprintf(stderr, "%s", usage);
+            return 2;
+        }
+    }
+    image_size = (image_size > MEM_IMAGE_MAX) ? MEM_IMAGE_MAX : (image_size == 0) ? 1 : image_size;
+    for (i = 0; i < image_size; ++i)
+    {
+        image[i] = (uint8_t)((i * 2654435761u) >> 13);
+    }
+    mem_footprint();
+
+    /* warm up: the lazy binding of the libc symbols runs on the stack of their first caller */
+    for (i = 0; i < sizeof(cases) / sizeof(cases[0]); ++i)
+    {
+        mem_run(&cases[i], peak);
+    }
+    if (mem_start(&idle) != 0)
+    {
+        fprintf(stderr, "start the peer failed\n");
+        return 2;
+    }
+    base = mem_join(&idle);
+    printf("stack high-water / Bytes (idle thread base %u subtracted):\n", (unsigned)base);
+    printf("  %-20s %8s %8s %8s %8s  %s\n", "path", "sender", "receiver", "worker", "device", "result");
+    for (i = 0; i < sizeof(cases) / sizeof(cases[0]); ++i)
+    {
+        res = mem_run(&cases[i], peak);
+        for (over = 0, j = 0; j < 4; ++j)
+        {
+            peak[j] -= (peak[j] > base) ? base : peak[j];
+            worst = (peak[j] > worst) ? peak[j] : worst;
+            over |= (budget > 0 && peak[j] > budget);
+        }
+        printf("  %-20s %8u %8u %8u %8u  %s\n", cases[i].name, (unsigned)peak[0], (unsigned)peak[1], (unsigned)peak[2],
+               (unsigned)peak[3], (res != 0) ? "FAILED" : (over != 0) ? "OVER BUDGET" : "ok");
+        fail |= res | over;
+    }
+    printf("worst stack: %u Bytes\n", (unsigned)worst);
+    return fail;
+}
@@ -0,0 +1,461 @@
+/**
+ *******************************************************************************************************************************************
+ * @file        xym_net.c
+ * @brief       X / Y modem stand-in terminal server(raw TCP / RFC 2217) bridging a command on a pty [xym-net]
+ * @since       Change Logs:
+ * Date         Author       Notes
+ * 2026-10-18   lzh          the first version
+ * @copyright (c) 2023 lzh <lzhoran@163.com>
+ *                https://github.com/ZeHHHHH/Flexible-XYmodem.git
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *******************************************************************************************************************************************
+ */
+#define _DEFAULT_SOURCE
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pty.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+
+/*******************************************************************************************************************************************
+ * Private Define
+ *******************************************************************************************************************************************/
+#define NET_BUFF_SIZE           (4096) /* bridge buffer / Bytes */
+#define NET_LINGER_MS           (500)  /* wait for the client to close after the command exits / ms */
+
+/* Telnet(RFC 854) commands and options */
+#define TN_SE                   (240)
+#define TN_SB                   (250)
+#define TN_WILL                 (251)
+#define TN_WONT                 (252)
+#define TN_DO                   (253)
+#define TN_DONT                 (254)
+#define TN_IAC                  (255)
+#define TN_OPT_BINARY           (0)
+#define TN_OPT_SGA              (3)
+#define TN_OPT_COMPORT          (44)   /* RFC 2217 COM-PORT-OPTION */
+
+/* Telnet receive parser state */
+typedef enum tn_state
+{
+    TN_STATE_DATA = 0, /* data */
+    TN_STATE_CMD,      /* after IAC */
+    TN_STATE_OPT,      /* after IAC WILL / WONT / DO / DONT */
+    TN_STATE_SUB,      /* inside IAC SB ... */
+    TN_STATE_SUB_IAC,  /* IAC inside IAC SB ... */
+} tn_state_t;
+
+/* one client connection */
+typedef struct net_conn
+{
+    int sock;          /* client socket */
+    int master;        /* pty master, the "serial device" side of the command */
+    tn_state_t state;  /* Telnet parser state */
+    uint8_t verb;      /* WILL / WONT / DO / DONT being parsed */
+    uint8_t sub[16];   /* subnegotiation being parsed */
+    uint8_t sub_len;
+    uint64_t will;     /* options enabled on this side, bit: option < 64 */
+    uint64_t dos;      /* options enabled on the client side, bit: option < 64 */
+} net_conn_t;
+
+/*******************************************************************************************************************************************
+ * Private Variable
+ *******************************************************************************************************************************************/
+static const char usage[] =
+    "usage: xym-net [options] CMD [ARGS...]\n"
+    "  stand-in terminal server(ser2net like) for the network link of xym-send / xym-recv: each connection runs\n"
+    "  CMD with a pty as stdin / stdout (the serial device) and bridges it to the socket\n"
+    "  -a ADDR   listen address (default 127.0.0.1)\n"
+    "  -p PORT   listen port (default 2217)\n"
+    "  -r        RFC 2217: Telnet with COM-PORT-OPTION, the settings asked by the client are printed (default raw TCP)\n"
+    "  -n N      connections to serve, 0: forever (default 1)\n"
+    "  -N        leave Nagle on the server socket (default TCP_NODELAY)\n";
+
+static uint8_t rfc2217 = 0;
+static uint8_t nagle = 0;
+
+/*******************************************************************************************************************************************
+ * Private Function
+ *******************************************************************************************************************************************/
+/* write all, blocking */
+static int write_all(const int fd, const uint8_t *data, size_t cnt)
+{
+    ssize_t n = 0;
+
+    for (; cnt > 0; data += n, cnt -= (size_t)n)
+    {
+        n = write(fd, data, cnt);
+        if (n < 0)
+        {
+            if (errno == EINTR)
+            {
+                n = 0;
+                continue;
+            }
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief  answer a Telnet option request of the client: BINARY and SGA both ways, COM-PORT-OPTION on the client side only
+ * @param  c    : connection
+ * @param  verb : WILL / WONT / DO / DONT
+ * @param  opt  : option
+ * @retval \
+ */
+static void tn_option(net_conn_t *c, const uint8_t verb, const uint8_t opt)
+{
+    const uint64_t bit = (opt < 64) ? ((uint64_t)1 << opt) : 0;
+    const uint8_t ok = (opt == TN_OPT_BINARY || opt == TN_OPT_SGA || (opt == TN_OPT_COMPORT && verb <= TN_WONT));
+    uint8_t reply[3] = {TN_IAC, 0, opt};
+
+    /* reply only on a change of state(RFC 854) */
+    switch (verb)
+    {
+    case TN_WILL:
+        reply[1] = (ok == 0) ? TN_DONT : ((c->dos & bit) == 0) ? TN_DO : 0;
+        c->dos |= (ok != 0) ? bit : 0;
+        break;
+    case TN_WONT:
+        reply[1] = ((c->dos & bit) != 0) ? TN_DONT : 0;
+        c->dos &= ~bit;
+        break;
+    case TN_DO:
+        reply[1] = (ok == 0) ? TN_WONT : ((c->will & bit) == 0) ? TN_WILL : 0;
+        c->will |= (ok != 0) ? bit : 0;
+        break;
+    default: /* TN_DONT */
+        reply[1] = ((c->will & bit) != 0) ? TN_WONT : 0;
+        c->will &= ~bit;
+        break;
+    }
+    if (reply[1] != 0)
+    {
+        (void)write_all(c->sock, reply, sizeof(reply));
+    }
+}
+
+/**
+ * @brief  answer a RFC 2217 command of the client: the value is taken as is and echoed with the command + 100
+ * @param  c : connection
+ * @retval \
+ */
+static void tn_comport(net_conn_t *c)
+{
+    static const char *parity[] = {"?", "none", "odd", "even", "mark", "space"};
+    uint8_t reply[2 * sizeof(c->sub) + 8];
+    uint32_t value = 0;
+    uint8_t i = 0, n = 0;
+
+    if (c->sub_len < 2 || c->sub[0] != TN_OPT_COMPORT || c->sub[1] == 0 || c->sub[1] > 12)
+    {
+        return;
+    }
+    for (i = 2; i < c->sub_len; ++i)
+    {
+        value = (value << 8) | c->sub[i];
+    }
+    switch (c->sub[1])
+    {
+    case 1: fprintf(stderr, "rfc2217: baudrate %u\n", value); break;
+    case 2: fprintf(stderr, "rfc2217: data size %u\n", value); break;
+    case 3: fprintf(stderr, "rfc2217: parity %s\n", parity[(value <= 5) ? value : 0]); break;
+    case 4: fprintf(stderr, "rfc2217: stop size %s\n", (value == 2) ? "2" : (value == 3) ? "1.5" : "1"); break;
+    case 5:
+        fprintf(stderr, "rfc2217: control %u%s\n", value, (value == 1) ? " (no flow control)" : (value == 3) ? " (RTS/CTS)" : "");
+        break;
+    default: break;
+    }
+    reply[n++] = TN_IAC;
+    reply[n++] = TN_SB;
+    reply[n++] = TN_OPT_COMPORT;
+    reply[n++] = (uint8_t)(c->sub[1] + 100);
+    for (i = 2; i < c->sub_len; ++i)
+    {
+        reply[n++] = c->sub[i];
+        if (c->sub[i] == TN_IAC)
+        {
+            reply[n++] = TN_IAC;
+        }
+    }
+    reply[n++] = TN_IAC;
+    reply[n++] = TN_SE;
+    (void)write_all(c->sock, reply, n);
+}
+
+/**
+ * @brief  strip the Telnet commands of the client in place
+ * @param  c   : connection
+ * @param  buf : received Bytes
+ * @param  cnt : received size / Bytes
+ * @retval data size / Bytes
+ */
+static size_t tn_decode(net_conn_t *c, uint8_t *buf, const size_t cnt)
+{
+    size_t i = 0, k = 0;
+    uint8_t ch = 0;
+
+    for (i = 0; i < cnt; ++i)
+    {
+        ch = buf[i];
+        switch (c->state)
+        {
+        case TN_STATE_DATA:
+            if (ch == TN_IAC)
+            {
+                c->state = TN_STATE_CMD;
+            }
+            else
+            {
+                buf[k++] = ch;
+            }
+            break;
+        case TN_STATE_CMD:
+            c->verb = ch;
+            c->sub_len = 0;
+            c->state = (ch >= TN_WILL && ch <= TN_DONT) ? TN_STATE_OPT : (ch == TN_SB) ? TN_STATE_SUB : TN_STATE_DATA;
+            if (ch == TN_IAC)
+            {
+                buf[k++] = ch; /* escaped 0xFF */
+            }
+            break;
+        case TN_STATE_OPT:
+            tn_option(c, c->verb, ch);
+            c->state = TN_STATE_DATA;
+            break;
+        case TN_STATE_SUB:
+        case TN_STATE_SUB_IAC:
+            if (c->state == TN_STATE_SUB && ch == TN_IAC)
+            {
+                c->state = TN_STATE_SUB_IAC;
+                break;
+            }
+            if (c->state == TN_STATE_SUB_IAC && ch != TN_IAC)
+            {
+                if (ch == TN_SE)
+                {
+                    tn_comport(c);
+                }
+                c->state = TN_STATE_DATA;
+                break;
+            }
+            if (c->sub_len < sizeof(c->sub))
+            {
+                c->sub[c->sub_len++] = ch;
+            }
+            c->state = TN_STATE_SUB;
+            break;
+        }
+    }
+    return k;
+}
+
+/**
+ * @brief  start the command on the slave side of a pty
+ * @param  slave : pty slave, stdin / stdout of the command
+ * @param  cmd   : command
+ * @retval pid, < 0: failed
+ */
+static pid_t spawn(const int slave, char *const cmd[])
+{
+    pid_t pid = fork();
+
+    if (pid != 0)
+    {
+        return pid;
+    }
+    setsid();
+    dup2(slave, STDIN_FILENO);
+    dup2(slave, STDOUT_FILENO);
+    execvp(cmd[0], cmd);
+    _exit(127);
+}
+
+/**
+ * @brief  serve one connection until the command exits or the client closes
+ * @param  sock : client socket
+ * @param  cmd  : command
+ * @retval exit code of the command, < 0: failed to start
+ */
+static int serve(const int sock, char *const cmd[])
+{
+    uint8_t buf[NET_BUFF_SIZE], out[2 * NET_BUFF_SIZE];
+    struct pollfd pfd[2];
+    struct termios tio;
+    net_conn_t c;
+    ssize_t n = 0;
+    size_t i = 0, k = 0;
+    int slave = -1, status = 0, on = 1;
+    pid_t pid = -1;
+
+    memset(&c, 0, sizeof(c));
+    c.sock = sock;
+    if (openpty(&c.master, &slave, NULL, NULL, NULL) != 0)
+    {
+        return -1;
+    }
+    /* raw up front: data may arrive before the command switches the pty itself */
+    tcgetattr(slave, &tio);
+    cfmakeraw(&tio);
+    tcsetattr(slave, TCSANOW, &tio);
+    if (nagle == 0)
+    {
+        setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+    }
+    pid = spawn(slave, cmd);
+    close(slave);
+    if (pid < 0)
+    {
+        close(c.master);
+        return -1;
+    }
+
+    pfd[0].fd = sock;
+    pfd[0].events = POLLIN;
+    pfd[1].fd = c.master;
+    pfd[1].events = POLLIN;
+    for (;;)
+    {
+        if (poll(pfd, 2, -1) < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            break;
+        }
+        /* client -> device */
+        if (pfd[0].revents != 0)
+        {
+            if ((n = read(sock, buf, NET_BUFF_SIZE)) <= 0)
+            {
+                break; /* closed by the client: the command sees a hang-up */
+            }
+            k = (rfc2217 != 0) ? tn_decode(&c, buf, (size_t)n) : (size_t)n;
+            if (write_all(c.master, buf, k) != 0)
+            {
+                break;
+            }
+        }
+        /* device -> client, 0xFF doubled on a Telnet link */
+        if (pfd[1].revents != 0)
+        {
+            if ((n = read(c.master, buf, NET_BUFF_SIZE)) <= 0)
+            {
+                /* the command exited: close our side, let the client read the rest and close */
+                shutdown(sock, SHUT_WR);
+                pfd[0].events = POLLIN;
+                while (poll(pfd, 1, NET_LINGER_MS) > 0 && read(sock, buf, NET_BUFF_SIZE) > 0)
+                {
+                }
+                break;
+            }
+            for (i = 0, k = 0; i < (size_t)n; ++i)
+            {
+                out[k++] = buf[i];
+                if (rfc2217 != 0 && buf[i] == TN_IAC)
+                {
+                    out[k++] = TN_IAC;
+                }
+            }
+            if (write_all(sock, out, k) != 0)
+            {
+                break;
+            }
+        }
+    }
+    close(c.master);
+    waitpid(pid, &status, 0);
+    return WIFEXITED(status) ? WEXITSTATUS(status) : 128 + WTERMSIG(status);
+}
+
+/*******************************************************************************************************************************************
+ * Public Function
+ *******************************************************************************************************************************************/
+int main(int argc, char **argv)
+{
+    struct sockaddr_in addr;
+    const char *host = "127.0.0.1";
+    int port = 2217, conns = 1, served = 0, opt = 0, fd = -1, sock = -1, on = 1, res = 0;
+
+    while ((opt = getopt(argc, argv, "+a:p:rn:Nh")) != -1)
+    {
+        switch (opt)
+        {
+        case 'a': host = optarg; break;
+        case 'p': port = atoi(optarg); break;
+        case 'r': rfc2217 = 1; break;
+        case 'n': conns = atoi(optarg); break;
+        case 'N': nagle = 1; break;
+        case 'h':
+        default:
+            fprintf(stderr, "%s", usage);
+            return 2;
+        }
+    }
+    if (optind >= argc)
+    {
+        fprintf(stderr, "%s", usage);
+        return 2;
+    }
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons((uint16_t)port);
+    if (inet_pton(AF_INET, host, &addr.sin_addr) != 1)
+    {
+        fprintf(stderr, "bad address [%s]\n", host);
+        return 2;
+    }
+    fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+    if (fd < 0 || bind(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0 || listen(fd, 1) != 0)
+    {
+        fprintf(stderr, "listen on %s:%d failed: %s\n", host, port, strerror(errno));
+        return 2;
+    }
+    signal(SIGPIPE, SIG_IGN);
+    fprintf(stderr, "xym-net: %s on %s:%d\n", (rfc2217 != 0) ? "rfc2217" : "raw tcp", host, port);
+    for (served = 0; conns == 0 || served < conns; ++served)
+    {
+        if ((sock = accept(fd, NULL, NULL)) < 0)
+        {
+            if (errno == EINTR)
+            {
+                --served;
+                continue;
+            }
+            break;
+        }
+        fcntl(sock, F_SETFD, FD_CLOEXEC); /* not inherited by the command */
+        res = serve(sock, &argv[optind]);
+        close(sock);
+        fprintf(stderr, "xym-net: [%s] exit %d\n", argv[optind], res);
+    }
+    close(fd);
+    return (res == 0) ? 0 : 1;
+}
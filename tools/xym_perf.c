@@ -0,0 +1,485 @@
+/**
+ *******************************************************************************************************************************************
+ * @file        xym_perf.c
+ * @brief       X / Y modem protocol engine CPU overhead per packet over a null transport [xym-perf]
+ * @since       Change Logs:
+ * Date         Author       Notes
+ * 2026-10-18   lzh          the first version
+ * @copyright (c) 2023 lzh <lzhoran@163.com>
+ *                https://github.com/ZeHHHHH/Flexible-XYmodem.git
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *******************************************************************************************************************************************
+ */
+/*
+ * Only the protocol logic is measured: callback dispatch, header checks, retry bookkeeping, copies and padding.
+ *   - [ops.crc16] is a stub returning 0, the frames of the scripted peer carry a zero CRC (CRC mode only).
+ *   - receiver : [ops.recv] / [ops.read] copy from a prebuilt byte stream of the whole session, [ops.send] drops the replies.
+ *   - sender   : [ops.send] only tracks frame boundaries, [ops.recv] pops the replies a standard receiver would send.
+ * Each path runs -n sessions in one thread, the best session is reported per packet: ns by CLOCK_MONOTONIC,
+ * cycles / instructions by perf_event_open(user space only, "n/a" where the counters are not permitted).
+ *
+ * gcc -O2 -I. tools/xym_perf.c xymodem.c -o xym-perf
+ * gcc -O2 -DXYM_RX_BUFF_SIZE=4096 -I. tools/xym_perf.c xymodem.c -o xym-perf-rb     # receiver through [ops.read]
+ */
+#define _DEFAULT_SOURCE
+#include <linux/perf_event.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#include "xymodem.h"
+
+/*******************************************************************************************************************************************
+ * Private Define
+ *******************************************************************************************************************************************/
+#define SOH                     (0x01)
+#define STX                     (0x02)
+#define EOT                     (0x04)
+#define ACK                     (0x06)
+#define NAK                     (0x15)
+#define CAN                     (0x18)
+#define CRC16_FLAG              ('C')
+
+#define PERF_IMAGE_MAX          (16 << 20)  /* max image size / Bytes */
+#define PERF_REPLY_MAX          (64)        /* pending replies of the scripted receiver */
+
+/* path */
+typedef struct perf_case
+{
+    const char *name;
+    uint8_t ymodem;      /* 0: Xmodem, 1: Ymodem */
+    uint8_t tx;          /* 0: library receives, 1: library transmits */
+    uint16_t pkt;        /* packet size */
+    uint8_t mode;        /* tx: 0-frame buffer, 1-user buffer, 2-span; rx: 0-frame buffer, 1-user buffer */
+} perf_case_t;
+
+/* result of one session */
+typedef struct perf_sample
+{
+    uint64_t ns;
+    uint64_t cycles;
+    uint64_t instructions;
+} perf_sample_t;
+
+/*******************************************************************************************************************************************
+ * Private Variable
+ *******************************************************************************************************************************************/
+static const char usage[] =
+    "usage: xym-perf [options]\n"
+    "  -z SIZE   image size of each session (default 1048576)\n"
+    "  -n N      sessions of each path, the best one is reported (default 20)\n"
+    "  -h        help\n";
+
+static const perf_case_t cases[] = {
+    {"xmodem-rx-1k",       0, 0, XYM_PKT_SIZE_1024, 0},
+    {"xmodem-rx-1k-copy",  0, 0, XYM_PKT_SIZE_1024, 1},
+    {"xmodem-rx-128",      0, 0, XYM_PKT_SIZE_128,  0},
+    {"xmodem-tx-1k",       0, 1, XYM_PKT_SIZE_1024, 0},
+    {"xmodem-tx-1k-copy",  0, 1, XYM_PKT_SIZE_1024, 1},
+    {"xmodem-tx-1k-span",  0, 1, XYM_PKT_SIZE_1024, 2},
+    {"xmodem-tx-128",      0, 1, XYM_PKT_SIZE_128,  0},
+    {"ymodem-rx-1k",       1, 0, XYM_PKT_SIZE_1024, 0},
+    {"ymodem-tx-1k",       1, 1, XYM_PKT_SIZE_1024, 0},
+    {"ymodem-tx-1k-span",  1, 1, XYM_PKT_SIZE_1024, 2},
+};
+
+static xym_session_t session;
+static uint8_t image[PERF_IMAGE_MAX];
+static uint8_t user_buff[XYM_PKT_SIZE_1024];
+static uint32_t image_size = 1 << 20;
+
+/* receiver: stream of the scripted sender */
+static uint8_t *stream;
+static size_t stream_len;
+static size_t stream_pos;
+
+/* sender: frame tracking and replies of the scripted receiver */
+static uint8_t is_ymodem;
+static uint32_t frame_left;          /* bytes left of the frame on the line */
+static uint8_t header_next;          /* the next frame is a Ymodem header(session start, after the EOT) */
+static uint8_t frame_header;         /* the frame is a Ymodem header */
+static uint32_t eot_cnt;
+static uint8_t reply[PERF_REPLY_MAX];
+static uint32_t reply_rd, reply_wr;
+
+static int perf_fd = -1;             /* group leader: cycles, member: instructions */
+
+/*******************************************************************************************************************************************
+ * Private Function
+ *******************************************************************************************************************************************/
+/* CRC stub: the protocol logic only */
+static uint16_t null_crc16(const uint8_t *data, const uint32_t cnt)
+{
+    (void)data;
+    (void)cnt;
+    return 0;
+}
+
+/* receiver: the replies are dropped */
+static xym_sta_t rx_send(const uint8_t *data, const uint32_t cnt, const uint32_t tick)
+{
+    (void)data;
+    (void)cnt;
+    (void)tick;
+    return XYM_OK;
+}
+
+static xym_sta_t rx_recv(uint8_t *data, const uint32_t cnt, const uint32_t tick)
+{
+    (void)tick;
+    if (stream_len - stream_pos < cnt)
+    {
+        return XYM_ERROR_TIMEOUT;
+    }
+    memcpy(data, &stream[stream_pos], cnt);
+    stream_pos += cnt;
+    return XYM_OK;
+}
+
+static xym_sta_t rx_read(uint8_t *data, const uint32_t cnt, uint32_t *got, const uint32_t tick)
+{
+    uint32_t n = (stream_len - stream_pos < cnt) ? (uint32_t)(stream_len - stream_pos) : cnt;
+
+    (void)tick;
+    if (n == 0)
+    {
+        return XYM_ERROR_TIMEOUT;
+    }
+    memcpy(data, &stream[stream_pos], n);
+    stream_pos += n;
+    *got = n;
+    return XYM_OK;
+}
+
+static void reply_push(const uint8_t c)
+{
+    reply[reply_wr++ % PERF_REPLY_MAX] = c;
+}
+
+/* sender: a standard receiver replies to each complete frame / EOT */
+static xym_sta_t tx_send(const uint8_t *data, const uint32_t cnt, const uint32_t tick)
+{
+    uint32_t i = 0, n = 0;
+
+    (void)tick;
+    while (i < cnt)
+    {
+        if (frame_left == 0)
+        {
+            switch (data[i])
+            {
+            case SOH:
+            case STX:
+                frame_left = XYM_FRAME_HEAD_SIZE + ((data[i] == STX) ? XYM_PKT_SIZE_1024 : XYM_PKT_SIZE_128) + XYM_FRAME_TAIL_SIZE;
+                frame_header = is_ymodem && header_next;
+                header_next = 0;
+                break;
+            case EOT:
+                reply_push((++eot_cnt & 1) ? NAK : ACK);
+                if (is_ymodem && (eot_cnt & 1) == 0)
+                {
+                    reply_push(CRC16_FLAG);
+                    header_next = 1;
+                }
+                ++i;
+                continue;
+            default: /* CAN */
+                ++i;
+                continue;
+            }
+        }
+        n = (cnt - i < frame_left) ? cnt - i : frame_left;
+        i += n;
+        frame_left -= n;
+        if (frame_left == 0)
+        {
+            reply_push(ACK);
+            if (frame_header)
+            {
+                reply_push(CRC16_FLAG);
+            }
+        }
+    }
+    return XYM_OK;
+}
+
+static xym_sta_t tx_recv(uint8_t *data, const uint32_t cnt, const uint32_t tick)
+{
+    uint32_t i = 0;
+
+    (void)tick;
+    for (i = 0; i < cnt; ++i)
+    {
+        data[i] = (reply_rd != reply_wr) ? reply[reply_rd++ % PERF_REPLY_MAX] : CRC16_FLAG; /* handshake */
+    }
+    return XYM_OK;
+}
+
+static xym_sta_t tx_read(uint8_t *data, const uint32_t cnt, uint32_t *got, const uint32_t tick)
+{
+    (void)cnt;
+    *got = 1;
+    return tx_recv(data, 1, tick);
+}
+
+/* append a frame with a zero CRC to the stream */
+static void stream_frame(const uint8_t seqno, const uint8_t *data, const uint16_t size, const uint16_t pkt)
+{
+    uint8_t *f = &stream[stream_len];
+
+    f[0] = (pkt == XYM_PKT_SIZE_1024) ? STX : SOH;
+    f[1] = seqno;
+    f[2] = (uint8_t)~seqno;
+    memcpy(&f[XYM_FRAME_HEAD_SIZE], data, size);
+    memset(&f[XYM_FRAME_HEAD_SIZE + size], 0x1A, pkt - size);
+    f[XYM_FRAME_HEAD_SIZE + pkt] = 0;
+    f[XYM_FRAME_HEAD_SIZE + pkt + 1] = 0;
+    stream_len += XYM_FRAME_HEAD_SIZE + pkt + XYM_FRAME_TAIL_SIZE;
+}
+
+/* build the whole byte stream of a sender session */
+static void stream_build(const perf_case_t *c)
+{
+    uint8_t info[XYM_PKT_SIZE_128];
+    uint32_t i = 0, n = 0;
+    uint8_t seqno = c->ymodem ? 0 : 1;
+
+    stream_len = 0;
+    if (c->ymodem)
+    {
+        memset(info, 0, sizeof(info));
+        n = (uint32_t)snprintf((char *)info, sizeof(info), "image.bin") + 1;
+        snprintf((char *)&info[n], sizeof(info) - n, "%u", (unsigned)image_size);
+        stream_frame(seqno++, info, sizeof(info), XYM_PKT_SIZE_128);
+    }
+    for (i = 0; i < image_size; i += n)
+    {
+        n = (image_size - i < c->pkt) ? image_size - i : c->pkt;
+        stream_frame(seqno++, &image[i], (uint16_t)n, c->pkt);
+    }
+    stream[stream_len++] = EOT;
+    stream[stream_len++] = EOT;
+    if (c->ymodem)
+    {
+        memset(info, 0, sizeof(info));
+        stream_frame(0, info, sizeof(info), XYM_PKT_SIZE_128);
+    }
+}
+
+/* open the counters, -1: not permitted */
+static int perf_open(void)
+{
+    struct perf_event_attr attr;
+    int leader = -1;
+
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = PERF_COUNT_HW_CPU_CYCLES;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP;
+    leader = (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+    if (leader < 0)
+    {
+        return -1;
+    }
+    attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+    attr.disabled = 0;
+    if ((int)syscall(SYS_perf_event_open, &attr, 0, -1, leader, 0) < 0)
+    {
+        close(leader);
+        return -1;
+    }
+    return leader;
+}
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+/* the session of a path, between the measurement points */
+static xym_sta_t perf_session(const perf_case_t *c)
+{
+    uint8_t *buff = (c->mode == 1) ? user_buff : xymodem_frame_data(&session);
+    xym_sta_t res = XYM_OK;
+    uint16_t len = 0;
+    uint32_t i = 0, n = 0;
+
+    if (c->tx == 0)
+    {
+        for (;;)
+        {
+            res = c->ymodem ? ymodem_receive(&session, (c->mode == 1) ? user_buff : NULL, &len)
+                            : xmodem_receive(&session, (c->mode == 1) ? user_buff : NULL, &len);
+            if (res != XYM_OK && res != XYM_FIL_GET)
+            {
+                return res;
+            }
+        }
+    }
+    if (c->ymodem)
+    {
+        memset(buff, 0, XYM_PKT_SIZE_128);
+        n = (uint32_t)snprintf((char *)buff, XYM_PKT_SIZE_128, "image.bin") + 1;
+        snprintf((char *)&buff[n], XYM_PKT_SIZE_128 - n, "%u", (unsigned)image_size);
+        if (XYM_OK != (res = ymodem_transmit(&session, buff, XYM_PKT_SIZE_128)))
+        {
+            return res;
+        }
+    }
+    if (c->mode == 2)
+    {
+        res = c->ymodem ? ymodem_transmit_span(&session, image, image_size, NULL) : xmodem_transmit_span(&session, image, image_size, NULL);
+        i = image_size;
+    }
+    for (; res == XYM_OK && i < image_size; i += n)
+    {
+        n = (image_size - i < c->pkt) ? image_size - i : c->pkt;
+        memcpy(buff, &image[i], n);
+        res = c->ymodem ? ymodem_transmit(&session, buff, (uint16_t)n) : xmodem_transmit(&session, buff, (uint16_t)n);
+    }
+    if (res != XYM_OK)
+    {
+        return res;
+    }
+    if (c->ymodem == 0)
+    {
+        return xmodem_transmit(&session, buff, 0);
+    }
+    if (XYM_FIL_SET != (res = ymodem_transmit(&session, buff, 0)))
+    {
+        return res;
+    }
+    memset(buff, 0, XYM_PKT_SIZE_128);
+    return ymodem_transmit(&session, buff, 0);
+}
+
+/**
+ * @brief  run one session of a path
+ * @param  c : path
+ * @param  s : returned sample
+ * @retval session result
+ */
+static xym_sta_t perf_run(const perf_case_t *c, perf_sample_t *s)
+{
+    struct xym_ops ops = {c->tx ? tx_send : rx_send, c->tx ? tx_recv : rx_recv, null_crc16, NULL, NULL, c->tx ? tx_read : rx_read};
+    struct xym_param param = {1000, 1000, 10, 0, 0, NULL};
+    uint64_t val[3] = {0, 0, 0}; /* nr, cycles, instructions */
+    xym_sta_t res = XYM_OK;
+
+    xymodem_session_init(&session, ops, param);
+    c->ymodem ? ymodem_init(&session) : xmodem_init(&session);
+    stream_pos = 0;
+    is_ymodem = c->ymodem;
+    frame_left = 0;
+    header_next = 1;
+    eot_cnt = 0;
+    reply_rd = reply_wr = 0;
+
+    if (perf_fd >= 0)
+    {
+        ioctl(perf_fd, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(perf_fd, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+    s->ns = now_ns();
+    res = perf_session(c);
+    s->ns = now_ns() - s->ns;
+    if (perf_fd >= 0)
+    {
+        ioctl(perf_fd, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+        if (read(perf_fd, val, sizeof(val)) != (ssize_t)sizeof(val))
+        {
+            val[1] = val[2] = 0;
+        }
+    }
+    s->cycles = val[1];
+    s->instructions = val[2];
+    return res;
+}
+
+/*******************************************************************************************************************************************
+ * Public Function
+ *******************************************************************************************************************************************/
+int main(int argc, char **argv)
+{
+    perf_sample_t s, best;
+    uint32_t runs = 20, i = 0, r = 0, pkts = 0;
+    xym_sta_t res = XYM_OK;
+    int opt = 0, fail = 0;
+
+    while ((opt = getopt(argc, argv, "z:n:h")) != -1)
+    {
+        switch (opt)
+        {
+        case 'z': image_size = (uint32_t)strtoul(optarg, NULL, 0); break;
+        case 'n': runs = (uint32_t)strtoul(optarg, NULL, 0); break;
+        case 'h':
+        default:
+            fprintf(stderr, "%s", usage);
+            return 2;
+        }
+    }
+    image_size = (image_size > PERF_IMAGE_MAX) ? PERF_IMAGE_MAX : (image_size == 0) ? 1 : image_size;
+    runs = (runs == 0) ? 1 : runs;
+    for (i = 0; i < image_size; ++i)
+    {
+        image[i] = (uint8_t)((i * 2654435761u) >> 13);
+    }
+    if ((stream = malloc((size_t)image_size / XYM_PKT_SIZE_128 * (XYM_PKT_SIZE_128 + 5) + 4096)) == NULL)
+    {
+        fprintf(stderr, "out of memory\n");
+        return 2;
+    }
+    perf_fd = perf_open();
+    printf("null transport, CRC stubbed, XYM_RX_BUFF_SIZE=%d, image %u Bytes, best of %u sessions%s\n",
+           XYM_RX_BUFF_SIZE, (unsigned)image_size, (unsigned)runs, (perf_fd < 0) ? ", perf counters not permitted" : "");
+    printf("  %-20s %8s %10s %10s %10s %8s\n", "path", "packets", "ns/pkt", "cycles/pkt", "instr/pkt", "result");
+    for (i = 0; i < sizeof(cases) / sizeof(cases[0]); ++i)
+    {
+        stream_build(&cases[i]);
+        memset(&best, 0xFF, sizeof(best));
+        for (r = 0; r < runs; ++r)
+        {
+            res = perf_run(&cases[i], &s);
+            best.ns = (s.ns < best.ns) ? s.ns : best.ns;
+            best.cycles = (s.cycles < best.cycles) ? s.cycles : best.cycles;
+            best.instructions = (s.instructions < best.instructions) ? s.instructions : best.instructions;
+        }
+        pkts = (image_size + cases[i].pkt - 1) / cases[i].pkt;
+        if (perf_fd >= 0)
+        {
+            printf("  %-20s %8u %10.1f %10.1f %10.1f %8s\n", cases[i].name, (unsigned)pkts, (double)best.ns / pkts,
+                   (double)best.cycles / pkts, (double)best.instructions / pkts, (res == XYM_END) ? "ok" : "FAILED");
+        }
+        else
+        {
+            printf("  %-20s %8u %10.1f %10s %10s %8s\n", cases[i].name, (unsigned)pkts, (double)best.ns / pkts, "n/a", "n/a",
+                   (res == XYM_END) ? "ok" : "FAILED");
+        }
+        fail |= (res != XYM_END);
+    }
+    free(stream);
+    return fail;
+}
@@ -0,0 +1,358 @@
+/**
+ *******************************************************************************************************************************************
+ * @file        xym_recv.c
+ * @brief       X / Y modem host receiver [xym-recv]
+ * @since       Change Logs:
+ * Date         Author       Notes
+ * 2026-10-18   lzh          the first version
+ * 2026-10-18   lzh          answer the remote verification requests of the received files [-V]
+ * @copyright (c) 2023 lzh <lzhoran@163.com>
+ *                https://github.com/ZeHHHHH/Flexible-XYmodem.git
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *******************************************************************************************************************************************
+ */
+#define _DEFAULT_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#include "xym_cli.h"
+#include "xymodem_pipe.h"
+
+/*******************************************************************************************************************************************
+ * Private Variable
+ *******************************************************************************************************************************************/
+static const char usage[] =
+    "usage: xym-recv [options] [OUT]\n"
+    "  Ymodem: OUT is the directory of the received files (default \".\"), \"-\" : all to stdout\n"
+    "  Xmodem: OUT is the received file (default \"-\" : stdout), the trailing ^Z of the last packet is trimmed\n";
+
+static xym_session_t session;
+static xym_cli_cfg_t cfg;
+static xym_cli_stat_t xfer;
+static char file_name[XYM_PKT_SIZE_1024];
+static FILE *fp_out = NULL; /* current output file */
+static uint64_t left = 0;   /* left bytes of the current Ymodem file */
+static const xym_pcache_entry_t *cached = NULL; /* cached parameters of the sender */
+
+#define VERIFY_FILE_MAX   (64) /* files served by -V */
+
+static char *received[VERIFY_FILE_MAX]; /* received files in turn, the verified regions follow one another */
+static uint32_t received_num = 0;
+
+/*******************************************************************************************************************************************
+ * Private Function
+ *******************************************************************************************************************************************/
+/**
+ * @brief  open the file of a Ymodem file info packet: "name\0size ..."
+ * @param  out  : output directory or "-"
+ * @param  data : file info packet
+ * @param  size : size of packet
+ * @retval file, NULL: failed
+ */
+static FILE *open_file_info(const char *out, const uint8_t *data, const uint16_t size)
+{
+    char path[4096];
+    const char *name = (const char *)data;
+    const char *base = NULL;
+    size_t len = strnlen(name, size);
+
+    if (len >= size)
+    {
+        return NULL;
+    }
+    /* never leave the output directory */
+    base = strrchr(name, '/');
+    base = (base != NULL) ? base + 1 : name;
+    if (base[0] == 0 || strcmp(base, ".") == 0 || strcmp(base, "..") == 0)
+    {
+        return NULL;
+    }
+    snprintf(file_name, sizeof(file_name), "%s", base);
+    xym_cli_file_start(&xfer, file_name, strtoull((const char *)&data[len + 1], NULL, 10));
+    if (strcmp(out, "-") == 0)
+    {
+        return stdout;
+    }
+    snprintf(path, sizeof(path), "%s/%s", out, file_name);
+    if (received_num < VERIFY_FILE_MAX)
+    {
+        received[received_num++] = strdup(path);
+    }
+    return fopen(path, "wb");
+}
+
+/**
+ * @brief  read the received files as one region for the remote verification
+ * @param  user   : \
+ * @param  offset : offset from the start of the first received file
+ * @param  data   : data
+ * @param  cnt    : data size / Bytes
+ * @retval XYM_OK : success, other : out of the received files
+ */
+static xym_sta_t read_received(void *user, const uint32_t offset, uint8_t *data, const uint32_t cnt)
+{
+    uint64_t pos = offset;
+    uint32_t done = 0, i = 0;
+    struct stat st;
+    FILE *fp = NULL;
+
+    (void)user;
+    for (i = 0; i < received_num && done < cnt; ++i)
+    {
+        if (received[i] == NULL || stat(received[i], &st) != 0)
+        {
+            return XYM_ERROR_INVALID_DATA;
+        }
+        if (pos >= (uint64_t)st.st_size)
+        {
+            pos -= (uint64_t)st.st_size;
+            continue;
+        }
+        if ((fp = fopen(received[i], "rb")) == NULL)
+        {
+            return XYM_ERROR_INVALID_DATA;
+        }
+        if (fseeko(fp, (off_t)pos, SEEK_SET) == 0)
+        {
+            done += (uint32_t)fread(&data[done], 1, cnt - done, fp);
+        }
+        fclose(fp);
+        pos = 0;
+    }
+    return (done == cnt) ? XYM_OK : XYM_ERROR_INVALID_DATA;
+}
+
+/**
+ * @brief  storage of the Ymodem batch
+ * @param  user : output directory or "-"
+ * @param  sta  : XYM_FIL_GET / XYM_OK / session over
+ * @param  data : data
+ * @param  size : data size / Bytes
+ * @retval XYM_OK : continue, other : cancel the session
+ */
+static xym_sta_t store_ymodem(void *user, const xym_sta_t sta, const uint8_t *data, const uint16_t size)
+{
+    const char *out = (const char *)user;
+    uint16_t len = size;
+
+    if (sta != XYM_OK)
+    {
+        if (fp_out != NULL && fp_out != stdout)
+        {
+            fclose(fp_out);
+        }
+        fp_out = NULL;
+    }
+    if (sta == XYM_FIL_GET)
+    {
+        if ((fp_out = open_file_info(out, data, size)) == NULL)
+        {
+            fprintf(stderr, "\ncan not create the received file, cancel\n");
+            return XYM_ERROR_INVALID_DATA;
+        }
+        left = (xfer.file_total > 0) ? xfer.file_total : UINT64_MAX;
+        return XYM_OK;
+    }
+    if (sta != XYM_OK)
+    {
+        return XYM_OK;
+    }
+    if (fp_out == NULL)
+    {
+        return XYM_ERROR_INVALID_DATA;
+    }
+    /* cut the padding of the last packet by the file size */
+    len = (left < len) ? (uint16_t)left : len;
+    left -= len;
+    if (fwrite(data, 1, len, fp_out) != len)
+    {
+        fprintf(stderr, "\nwrite failed, cancel\n");
+        return XYM_ERROR_INVALID_DATA;
+    }
+    xym_cli_progress(&cfg, &xfer, len);
+    return XYM_OK;
+}
+
+/**
+ * @brief  storage of the Xmodem file, the last packet is held back to trim ^Z
+ * @param  user : \
+ * @param  sta  : XYM_OK / session over
+ * @param  data : data
+ * @param  size : data size / Bytes
+ * @retval XYM_OK : continue, other : cancel the session
+ */
+static xym_sta_t store_xmodem(void *user, const xym_sta_t sta, const uint8_t *data, const uint16_t size)
+{
+    static uint8_t last[XYM_PKT_SIZE_1024];
+    static uint16_t last_len = 0;
+
+    (void)user;
+    if (sta == XYM_OK)
+    {
+        if (last_len > 0 && fwrite(last, 1, last_len, fp_out) != last_len)
+        {
+            fprintf(stderr, "\nwrite failed, cancel\n");
+            return XYM_ERROR_INVALID_DATA;
+        }
+        memcpy(last, data, size);
+        last_len = size;
+        xym_cli_progress(&cfg, &xfer, size);
+        return XYM_OK;
+    }
+    if (sta == XYM_END)
+    {
+        for (; last_len > 0 && last[last_len - 1] == 0x1A; --last_len)
+        {
+        }
+        fwrite(last, 1, last_len, fp_out);
+    }
+    if (fp_out != stdout)
+    {
+        fclose(fp_out);
+    }
+    fp_out = NULL;
+    return XYM_OK;
+}
+
+/**
+ * @brief  receive in the calling thread: link, verification and storage in turn
+ * @param  sink : storage
+ * @param  user : user data of [sink]
+ * @retval enum xym_sta
+ */
+static xym_sta_t recv_direct(xym_pipe_sink_t sink, void *user)
+{
+    const uint8_t *data = xymodem_frame_data(&session); /* zero-copy: the data stays in the frame */
+    xym_sta_t res = XYM_OK;
+    uint16_t len = 0;
+
+    (cfg.xmodem != 0) ? xmodem_init(&session) : ymodem_init(&session);
+    xymodem_fast_start(&session, cached);
+    for (;;)
+    {
+        res = (cfg.xmodem != 0) ? xmodem_receive(&session, NULL, &len) : ymodem_receive(&session, NULL, &len);
+        if (res != XYM_OK && res != XYM_FIL_GET)
+        {
+            break;
+        }
+        if (XYM_OK != sink(user, res, data, len))
+        {
+            res = xymodem_active_cancel(&session);
+            break;
+        }
+    }
+    sink(user, res, NULL, 0);
+    return res;
+}
+
+/**
+ * @brief  worker thread of the receive pipeline
+ * @param  arg : pipeline
+ * @retval \
+ */
+static void *pipe_worker(void *arg)
+{
+    xymodem_pipe_worker((xym_pipe_t *)arg);
+    return NULL;
+}
+
+/**
+ * @brief  receive by the two-stage pipeline: the link in the calling thread, verification and storage in a worker
+ * @param  sink : storage
+ * @param  user : user data of [sink]
+ * @retval enum xym_sta
+ */
+static xym_sta_t recv_pipeline(xym_pipe_sink_t sink, void *user)
+{
+    static xym_pipe_t pipe;
+    pthread_t tid;
+    xym_sta_t res = XYM_OK;
+
+    xymodem_pipe_init(&pipe, &session, (cfg.xmodem != 0) ? 0 : 1, sink, user);
+    xymodem_fast_start(&session, cached);
+    if (pthread_create(&tid, NULL, pipe_worker, &pipe) != 0)
+    {
+        fprintf(stderr, "create the worker thread failed, fall back to direct\n");
+        return recv_direct(sink, user);
+    }
+    res = xymodem_pipe_io(&pipe);
+    pthread_join(tid, NULL);
+    return res;
+}
+
+/*******************************************************************************************************************************************
+ * Public Function
+ *******************************************************************************************************************************************/
+int main(int argc, char **argv)
+{
+    struct xym_ops ops;
+    xym_pipe_sink_t sink = NULL;
+    xym_sta_t res = XYM_OK;
+    const char *out = NULL;
+    int i = xym_cli_parse(&cfg, argc, argv, usage);
+
+    if (i < 0 || argc - i > 1)
+    {
+        if (i >= 0)
+        {
+            fprintf(stderr, "%s", usage);
+        }
+        return 2;
+    }
+    out = (i < argc) ? argv[i] : (cfg.xmodem != 0) ? "-" : ".";
+    if (strcmp(out, "-") == 0 && strcmp(cfg.dev, "-") == 0)
+    {
+        fprintf(stderr, "stdout is the link, choose another OUT\n");
+        return 2;
+    }
+    sink = (cfg.xmodem != 0) ? store_xmodem : store_ymodem;
+    if (XYM_OK != xym_cli_link_open(&cfg, &ops))
+    {
+        return 2;
+    }
+    xymodem_session_init(&session, ops, cfg.param);
+    xymodem_profile_set(&session, cfg.profile);
+    xym_cli_cancel_on_signal(&session);
+    if (cfg.xmodem != 0)
+    {
+        if ((fp_out = (strcmp(out, "-") == 0) ? stdout : fopen(out, "wb")) == NULL)
+        {
+            fprintf(stderr, "open [%s] failed\n", out);
+            xym_cli_link_close();
+            return 2;
+        }
+        xym_cli_file_start(&xfer, out, 0);
+        received[received_num++] = (fp_out != stdout) ? strdup(out) : NULL;
+    }
+    cached = xym_cli_cache_find(&cfg);
+    res = (cfg.pipeline != 0) ? recv_pipeline(sink, (void *)out) : recv_direct(sink, (void *)out);
+    if (res == XYM_END)
+    {
+        xym_cli_cache_store(&cfg, &session);
+    }
+    if (cfg.quiet == 0 && cfg.xmodem == 0)
+    {
+        fprintf(stderr, "\npeer: %s\n", xym_cli_profile_str(xymodem_profile_get(&session)));
+    }
+    i = xym_cli_summary(&cfg, &xfer, res);
+    /* answer the verification requests until the sender is quiet */
+    while (res == XYM_END && cfg.verify != 0 && XYM_OK == xymodem_verify_serve(&session, read_received, NULL, cfg.param.recv_timeout))
+    {
+    }
+    xym_cli_link_close();
+    return i;
+}
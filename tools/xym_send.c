@@ -0,0 +1,232 @@
+/**
+ *******************************************************************************************************************************************
+ * @file        xym_send.c
+ * @brief       X / Y modem host sender [xym-send]
+ * @since       Change Logs:
+ * Date         Author       Notes
+ * 2026-10-18   lzh          the first version
+ * 2026-10-18   lzh          verify the sent files by the digest of the device [-V] [-A]
+ * @copyright (c) 2023 lzh <lzhoran@163.com>
+ *                https://github.com/ZeHHHHH/Flexible-XYmodem.git
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *******************************************************************************************************************************************
+ */
+#define _DEFAULT_SOURCE
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include "xym_cli.h"
+
+/*******************************************************************************************************************************************
+ * Private Variable
+ *******************************************************************************************************************************************/
+static const char usage[] =
+    "usage: xym-send [options] FILE...   (FILE \"-\" : stdin)\n"
+    "  Ymodem sends a batch of files, Xmodem sends one file.\n";
+
+static xym_session_t session;
+static xym_cli_cfg_t cfg;
+static xym_cli_stat_t xfer;
+
+#define VERIFY_FILE_MAX   (64) /* files verified by -V */
+
+/* digest of the files sent, for the remote verification */
+static struct
+{
+    uint32_t size;
+    uint8_t digest[XYM_DIGEST_SIZE_MAX];
+    const char *name;
+} sent[VERIFY_FILE_MAX];
+static uint32_t sent_num = 0;
+static xym_digest_t digest;
+
+/*******************************************************************************************************************************************
+ * Private Function
+ *******************************************************************************************************************************************/
+/* X / Y modem transmit by the selected protocol, size 0: end of file(Ymodem: also an empty file) */
+static xym_sta_t transmit(uint8_t *buff, const uint16_t size)
+{
+    if (cfg.xmodem == 0 && size == 0)
+    {
+        return ymodem_transmit_eof(&session);
+    }
+    return (cfg.xmodem != 0) ? xmodem_transmit(&session, buff, size) : ymodem_transmit(&session, buff, size);
+}
+
+/**
+ * @brief  send the Ymodem file info packet: "name\0size mtime mode"
+ * @param  path : file path
+ * @param  fp   : file
+ * @retval enum xym_sta
+ */
+static xym_sta_t send_file_info(const char *path, FILE *fp)
+{
+    uint8_t *buff = xymodem_frame_data(&session);
+    const char *name = strrchr(path, '/');
+    struct stat st;
+    int n = 0;
+
+    name = (strcmp(path, "-") == 0) ? "stdin" : (name != NULL) ? name + 1 : path;
+    memset(buff, 0, XYM_PKT_SIZE_1024);
+    n = snprintf((char *)buff, XYM_PKT_SIZE_1024 - 1, "%s", name) + 1;
+    if (fstat(fileno(fp), &st) == 0 && S_ISREG(st.st_mode))
+    {
+        n += snprintf((char *)&buff[n], XYM_PKT_SIZE_1024 - n, "%lld %llo %o",
+                      (long long)st.st_size, (unsigned long long)st.st_mtime, (unsigned)st.st_mode & 0777);
+        xym_cli_file_start(&xfer, name, (uint64_t)st.st_size);
+    }
+    else
+    {
+        xym_cli_file_start(&xfer, name, 0);
+    }
+    return transmit(buff, (n < XYM_PKT_SIZE_128) ? XYM_PKT_SIZE_128 : XYM_PKT_SIZE_1024);
+}
+
+/**
+ * @brief  send the file data and EOT
+ * @param  fp : file
+ * @retval XYM_END / XYM_FIL_SET : file over, other : session over
+ */
+static xym_sta_t send_file_data(FILE *fp)
+{
+    uint8_t *buff = xymodem_frame_data(&session); /* zero-copy: read straight into the frame */
+    xym_sta_t res = XYM_OK;
+    size_t n = 0;
+
+    for (;;)
+    {
+        n = fread(buff, 1, cfg.pkt_size, fp);
+        if (cfg.verify != 0)
+        {
+            xymodem_digest_update(&digest, buff, (uint32_t)n); /* before the padding of the last packet */
+        }
+        res = transmit(buff, (uint16_t)n);
+        if (n == 0 || res != XYM_OK)
+        {
+            return res;
+        }
+        xym_cli_progress(&cfg, &xfer, (uint32_t)n);
+    }
+}
+
+/**
+ * @brief  verify the files sent by the digest of the device, the files follow one another from [cfg.verify_base]
+ * @param   * @retval 0: all match, other: failed
+ */
+static int verify_sent(void)
+{
+    static const char *const str[] = {"match", "MISMATCH", "refused by the device", "no reply"};
+    uint32_t offset = cfg.verify_base;
+    xym_sta_t res = XYM_OK;
+    uint32_t i = 0;
+    int ret = 0;
+
+    for (i = 0; i < sent_num; ++i)
+    {
+        res = xymodem_verify_remote(&session, (xym_digest_alg_t)cfg.verify, offset, sent[i].size, sent[i].digest,
+                                    cfg.param.recv_timeout);
+        fprintf(stderr, "verify [%s] 0x%08x +%u : %s\n", sent[i].name, (unsigned)offset, (unsigned)sent[i].size,
+                (res == XYM_OK) ? str[0] : (res == XYM_ERROR_INVALID_DATA) ? str[1] : (res == XYM_CANCEL_REMOTE) ? str[2] : str[3]);
+        ret |= (res != XYM_OK);
+        offset += sent[i].size;
+    }
+    return ret;
+}
+
+/*******************************************************************************************************************************************
+ * Public Function
+ *******************************************************************************************************************************************/
+int main(int argc, char **argv)
+{
+    struct xym_ops ops;
+    const xym_pcache_entry_t *cached = NULL;
+    xym_sta_t res = XYM_OK;
+    FILE *fp = NULL;
+    int i = xym_cli_parse(&cfg, argc, argv, usage);
+
+    if (i < 0 || i >= argc || (cfg.xmodem != 0 && argc - i != 1))
+    {
+        if (i >= 0)
+        {
+            fprintf(stderr, "%s", usage);
+        }
+        return 2;
+    }
+    if (XYM_OK != xym_cli_link_open(&cfg, &ops))
+    {
+        return 2;
+    }
+    xymodem_session_init(&session, ops, cfg.param);
+    xymodem_profile_set(&session, cfg.profile);
+    xym_cli_cancel_on_signal(&session);
+    (cfg.xmodem != 0) ? xmodem_init(&session) : ymodem_init(&session);
+    cached = xym_cli_cache_find(&cfg);
+    xymodem_fast_start(&session, cached);
+    if (cfg.pkt_size == 0)
+    {
+        cfg.pkt_size = (cached != NULL && cached->pkt_1k == 0) ? XYM_PKT_SIZE_128 : XYM_PKT_SIZE_1024;
+    }
+
+    for (; res == XYM_OK && i < argc; ++i)
+    {
+        fp = (strcmp(argv[i], "-") == 0) ? stdin : fopen(argv[i], "rb");
+        if (fp == NULL)
+        {
+            fprintf(stderr, "open [%s] failed, skipped\n", argv[i]);
+            continue;
+        }
+        if (cfg.verify != 0 && XYM_OK != xymodem_digest_init(&digest, (xym_digest_alg_t)cfg.verify))
+        {
+            fprintf(stderr, "digest not supported, no verification\n");
+            cfg.verify = 0;
+        }
+        if (cfg.xmodem != 0)
+        {
+            xym_cli_file_start(&xfer, argv[i], 0);
+            res = send_file_data(fp);
+        }
+        else if (XYM_OK == (res = send_file_info(argv[i], fp)))
+        {
+            res = send_file_data(fp);
+            res = (res == XYM_FIL_SET) ? XYM_OK : res;
+        }
+        if (fp != stdin)
+        {
+            fclose(fp);
+        }
+        if (cfg.verify != 0 && sent_num < VERIFY_FILE_MAX && (res == XYM_OK || res == XYM_END))
+        {
+            sent[sent_num].size = (uint32_t)xfer.file_done;
+            sent[sent_num].name = argv[i];
+            xymodem_digest_final(&digest, sent[sent_num++].digest);
+        }
+    }
+    /* Ymodem: end of batch */
+    if (cfg.xmodem == 0 && res == XYM_OK)
+    {
+        memset(xymodem_frame_data(&session), 0, XYM_PKT_SIZE_128);
+        res = ymodem_transmit(&session, xymodem_frame_data(&session), 0);
+    }
+    if (res == XYM_END && cfg.verify != 0 && verify_sent() != 0)
+    {
+        res = XYM_ERROR_INVALID_DATA; /* stored image differs from the file */
+    }
+    xym_cli_link_close();
+    if (res == XYM_END)
+    {
+        xym_cli_cache_store(&cfg, &session);
+    }
+    return xym_cli_summary(&cfg, &xfer, res);
+}
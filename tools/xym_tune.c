@@ -0,0 +1,581 @@
+/**
+ *******************************************************************************************************************************************
+ * @file        xym_tune.c
+ * @brief       X / Y modem link settings autotuner of a device class [xym-tune]
+ * @since       Change Logs:
+ * Date         Author       Notes
+ * 2026-10-18   lzh          the first version
+ * @copyright (c) 2023 lzh <lzhoran@163.com>
+ *                https://github.com/ZeHHHHH/Flexible-XYmodem.git
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *******************************************************************************************************************************************
+ */
+/*
+ * Explores baudrate, packet size, receive timeout and max retry of the sender, measures the goodput and the failure rate
+ * of each candidate, and saves the best one as the learned settings of the device class (struct xym_tune):
+ *
+ *   offline : the library transmits over a simulated link with virtual time, the device is a standard Xmodem receiver model
+ *             with the bit error rate of each baudrate, the line latency, the flash write time of each packet(bytes arriving
+ *             meanwhile are lost, as a polled UART) and its own receive timeout.
+ *   live    : -L CMD runs a real transfer per run, "%b %k %t %r" in CMD are replaced by baudrate, packet size, receive
+ *             timeout and max retry, exit status 0 is a success, eg: -L "xym-send -q -d /dev/ttyUSB0 -b %b -k %k -t %t -r %r fw.bin"
+ *
+ * Score: mean goodput of the successful runs * success rate, among the candidates with failure rate <= -f.
+ * The settings file has a line per device class: "class baud pkt_size send_timeout recv_timeout retry goodput fail_rate",
+ * xym-send / xym-recv load it by -u CLASS, firmware takes the printed struct xym_tune as [param.tune].
+ *
+ * build : gcc -O2 -I. tools/xym_tune.c xymodem.c -lm -o xym-tune
+ */
+#define _DEFAULT_SOURCE
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "xymodem.h"
+
+/*******************************************************************************************************************************************
+ * Private Define
+ *******************************************************************************************************************************************/
+#define TUNE_LIST_MAX           (16)     /* max values of one explored parameter */
+#define TUNE_REPLY_MAX          (256)    /* device replies in flight */
+#define TUNE_CLASS_MAX          (256)    /* device classes in the settings file */
+#define TUNE_LINE_MAX           (512)
+
+#define SOH                     (0x01)
+#define STX                     (0x02)
+#define EOT                     (0x04)
+#define ACK                     (0x06)
+#define NAK                     (0x15)
+#define CANCEL                  (0x18)
+#define CRC16_FLAG              (0x43)
+
+/* explored values and the device class model */
+typedef struct tune_cfg
+{
+    const char *cls;                  /* device class */
+    const char *path;                 /* settings file */
+    const char *live;                 /* live command, NULL: offline */
+    uint32_t baud[TUNE_LIST_MAX];     /* baudrates */
+    double ber[TUNE_LIST_MAX];        /* bit error rate of each baudrate */
+    uint32_t pkt[TUNE_LIST_MAX];      /* packet sizes */
+    uint32_t tmo[TUNE_LIST_MAX];      /* receive timeouts / ms */
+    uint32_t retry[TUNE_LIST_MAX];    /* max retries */
+    int n_baud, n_pkt, n_tmo, n_retry;
+    uint32_t size;                    /* transfer size / Bytes */
+    uint32_t runs;                    /* runs per candidate */
+    double fail_max;                  /* acceptable failure rate */
+    uint32_t latency_us;              /* one-way line latency / us */
+    uint32_t write_us;                /* device flash write time per KiB / us */
+    uint32_t dev_timeout_ms;          /* device receive timeout / ms */
+    uint32_t seed;                    /* random seed */
+} tune_cfg_t;
+
+/* result of a candidate */
+typedef struct tune_res
+{
+    xym_tune_t tune;
+    double goodput;                   /* mean goodput of the successful runs / Bytes/s */
+    double fail;                      /* failure rate */
+    double score;                     /* goodput * (1 - fail) */
+} tune_res_t;
+
+/* a device reply in flight */
+typedef struct tune_reply
+{
+    uint64_t at;                      /* arrival at the sender / us */
+    uint8_t byte;
+} tune_reply_t;
+
+/*******************************************************************************************************************************************
+ * Private Variable
+ *******************************************************************************************************************************************/
+static tune_cfg_t cfg;
+
+/* simulated link, virtual time / us */
+static struct
+{
+    double byte_us;                   /* time of 1 Byte on the line(10 bits) */
+    double p_err;                     /* probability of a corrupted byte */
+    uint64_t vt;                      /* sender time */
+    uint64_t line;                    /* sender line busy until */
+    uint64_t rng;                     /* xorshift state */
+} sim;
+
+/* device model: standard Xmodem-CRC receiver */
+static struct
+{
+    uint8_t frame[XYM_FRAME_SIZE];    /* frame being received */
+    uint32_t got;                     /* bytes of [frame] */
+    uint32_t need;                    /* frame size, 0: idle */
+    uint8_t junk;                     /* garbage received, NAK at its timeout */
+    uint64_t last;                    /* arrival of the last byte / us */
+    uint64_t busy;                    /* flash write until / us */
+    uint8_t expect;                   /* next packet sequence */
+    uint32_t accepted;                /* packets accepted */
+    uint8_t started;                  /* a byte of the sender was received */
+    uint64_t probe;                   /* next 'C' / us */
+    uint8_t can;                      /* CAN received in succession */
+    tune_reply_t reply[TUNE_REPLY_MAX];
+    uint32_t rd, wr;
+} dev;
+
+/*******************************************************************************************************************************************
+ * Private Function
+ *******************************************************************************************************************************************/
+static uint64_t rnd(void)
+{
+    sim.rng ^= sim.rng << 13;
+    sim.rng ^= sim.rng >> 7;
+    sim.rng ^= sim.rng << 17;
+    return sim.rng;
+}
+
+/* corrupt one byte with the bit error rate of the line */
+static uint8_t line_byte(uint8_t b)
+{
+    if ((double)(rnd() >> 11) * (1.0 / 9007199254740992.0) < sim.p_err)
+    {
+        b ^= (uint8_t)(1u << (rnd() & 7));
+    }
+    return b;
+}
+
+static uint16_t crc16(const uint8_t *data, const uint32_t cnt)
+{
+    uint16_t crc = 0;
+    uint32_t i = 0;
+    uint8_t j = 0;
+
+    for (i = 0; i < cnt; ++i)
+    {
+        crc ^= (uint16_t)(data[i] << 8);
+        for (j = 0; j < 8; ++j)
+        {
+            crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+/* device sends a reply at [t] */
+static void dev_reply(const uint64_t t, const uint8_t b)
+{
+    if (dev.wr - dev.rd < TUNE_REPLY_MAX)
+    {
+        dev.reply[dev.wr++ % TUNE_REPLY_MAX] = (tune_reply_t){t + cfg.latency_us + (uint64_t)sim.byte_us, line_byte(b)};
+    }
+}
+
+/* the device receive timeout of a partial frame / garbage expired before [t]: drop it and NAK */
+static void dev_expire(const uint64_t t)
+{
+    uint64_t at = dev.last + (uint64_t)cfg.dev_timeout_ms * 1000u;
+    if ((dev.need > 0 || dev.junk != 0) && at <= t)
+    {
+        dev.need = dev.got = 0;
+        dev.junk = 0;
+        dev_reply(at, NAK);
+    }
+}
+
+/* a complete frame */
+static void dev_frame(const uint64_t t)
+{
+    uint32_t size = dev.need - XYM_FRAME_HEAD_SIZE - XYM_FRAME_TAIL_SIZE;
+    uint16_t crc = crc16(&dev.frame[XYM_FRAME_HEAD_SIZE], size);
+    const uint8_t *tail = &dev.frame[XYM_FRAME_HEAD_SIZE + size];
+
+    dev.need = dev.got = 0;
+    if ((uint8_t)(dev.frame[1] ^ dev.frame[2]) != 0xFF || tail[0] != (crc >> 8) || tail[1] != (crc & 0xFF))
+    {
+        dev_reply(t, NAK);
+        return;
+    }
+    if (dev.frame[1] == dev.expect)
+    {
+        dev.expect++;
+        dev.accepted++;
+        dev.busy = t + (uint64_t)cfg.write_us * size / XYM_PKT_SIZE_1024; /* the UART is not served meanwhile */
+        dev_reply(dev.busy, ACK);
+        return;
+    }
+    dev_reply(t, (dev.frame[1] == (uint8_t)(dev.expect - 1)) ? ACK : NAK); /* the previous one is acknowledged again */
+}
+
+/* a byte of the sender arrives at the device at [t] */
+static void dev_input(const uint64_t t, const uint8_t b)
+{
+    dev_expire(t);
+    if (t < dev.busy)
+    {
+        return; /* lost in the flash write */
+    }
+    dev.started = 1;
+    dev.last = t;
+    if (dev.need > 0)
+    {
+        dev.frame[dev.got++] = b;
+        if (dev.got == dev.need)
+        {
+            dev_frame(t);
+        }
+        return;
+    }
+    if (dev.junk != 0)
+    {
+        return;
+    }
+    dev.can = (b == CANCEL) ? dev.can + 1 : 0;
+    switch (b)
+    {
+    case SOH:
+    case STX:
+        dev.frame[0] = b;
+        dev.got = 1;
+        dev.need = XYM_FRAME_HEAD_SIZE + ((b == SOH) ? XYM_PKT_SIZE_128 : XYM_PKT_SIZE_1024) + XYM_FRAME_TAIL_SIZE;
+        break;
+    case EOT:
+        dev_reply(t, ACK);
+        break;
+    case CANCEL:
+        break;
+    default:
+        dev.junk = 1;
+        break;
+    }
+}
+
+/* the line delivers everything, the sender waits for the line */
+static xym_sta_t sim_send(const uint8_t *data, const uint32_t cnt, const uint32_t tick)
+{
+    uint32_t i = 0;
+    double t = (double)((sim.line > sim.vt) ? sim.line : sim.vt);
+
+    (void)tick;
+    for (i = 0; i < cnt; ++i)
+    {
+        t += sim.byte_us;
+        dev_input((uint64_t)t + cfg.latency_us, line_byte(data[i]));
+    }
+    sim.vt = sim.line = (uint64_t)t;
+    return XYM_OK;
+}
+
+/* next device reply(or 'C' probe / expired NAK) arriving before [deadline] */
+static int sim_take(uint8_t *b, const uint64_t deadline)
+{
+    uint64_t at = 0;
+
+    if (dev.started == 0 && dev.rd == dev.wr && dev.probe + cfg.latency_us <= deadline)
+    {
+        dev_reply(dev.probe, CRC16_FLAG);
+        dev.probe += (uint64_t)cfg.dev_timeout_ms * 1000u;
+    }
+    dev_expire(deadline > cfg.latency_us ? deadline - cfg.latency_us : 0);
+    if (dev.rd == dev.wr || (at = dev.reply[dev.rd % TUNE_REPLY_MAX].at) > deadline)
+    {
+        return 0;
+    }
+    *b = dev.reply[dev.rd++ % TUNE_REPLY_MAX].byte;
+    sim.vt = (at > sim.vt) ? at : sim.vt;
+    return 1;
+}
+
+static xym_sta_t sim_recv(uint8_t *data, const uint32_t cnt, const uint32_t tick)
+{
+    uint32_t i = 0;
+
+    for (i = 0; i < cnt; ++i)
+    {
+        if (!sim_take(&data[i], sim.vt + (uint64_t)tick * 1000u))
+        {
+            sim.vt += (uint64_t)tick * 1000u;
+            return XYM_ERROR_TIMEOUT;
+        }
+    }
+    return XYM_OK;
+}
+
+/**
+ * @brief  one offline transfer of [cfg.size] Bytes
+ * @param  tune : candidate
+ * @param  ber  : bit error rate
+ * @param  sec  : returned transfer time / s
+ * @retval 1: success, 0: failed
+ */
+static int sim_run(const xym_tune_t *tune, const double ber, double *sec)
+{
+    static xym_session_t session;
+    struct xym_ops ops = {sim_send, sim_recv, NULL, NULL, NULL, NULL};
+    struct xym_param param = {0, 0, 0, 0, 0, tune};
+    uint32_t done = 0, pkts = 0;
+    uint16_t len = 0;
+    xym_sta_t res = XYM_OK;
+    uint8_t *buff = NULL;
+
+    memset(&dev, 0, sizeof(dev));
+    dev.expect = 1;
+    sim.byte_us = 10e6 / (double)tune->baud;
+    sim.p_err = 1.0 - pow(1.0 - ber, 10);
+    sim.vt = sim.line = 0;
+    xymodem_session_init(&session, ops, param);
+    xmodem_init(&session);
+    buff = xymodem_frame_data(&session);
+    for (done = 0; res == XYM_OK; done += len)
+    {
+        len = (cfg.size - done > tune->pkt_size) ? (uint16_t)tune->pkt_size : (uint16_t)(cfg.size - done);
+        memset(buff, (uint8_t)done, len);
+        res = xmodem_transmit(&session, buff, len);
+        pkts += (len > 0) ? 1 : 0;
+    }
+    *sec = (double)sim.vt / 1e6;
+    return (res == XYM_END && dev.accepted == pkts) ? 1 : 0;
+}
+
+/* monotonic time / s */
+static double now_sec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+/**
+ * @brief  one live transfer by the user command
+ * @param  tune : candidate
+ * @param  sec  : returned transfer time / s
+ * @retval 1: success, 0: failed
+ */
+static int live_run(const xym_tune_t *tune, double *sec)
+{
+    char cmd[4096];
+    const char *s = cfg.live;
+    size_t n = 0;
+    double t = 0;
+    int st = 0;
+
+    for (; *s != 0 && n + 16 < sizeof(cmd); ++s)
+    {
+        if (s[0] == '%' && strchr("bktr", s[1]) != NULL && s[1] != 0)
+        {
+            n += (size_t)snprintf(&cmd[n], sizeof(cmd) - n, "%u",
+                                  (s[1] == 'b') ? tune->baud : (s[1] == 'k') ? tune->pkt_size : (s[1] == 't') ? tune->recv_timeout : tune->error_max_retry);
+            ++s;
+            continue;
+        }
+        cmd[n++] = *s;
+    }
+    cmd[n] = 0;
+    t = now_sec();
+    st = system(cmd);
+    *sec = now_sec() - t;
+    return (st != -1 && WIFEXITED(st) && WEXITSTATUS(st) == 0) ? 1 : 0;
+}
+
+/* measure a candidate over [cfg.runs] transfers */
+static void measure(tune_res_t *r, const double ber)
+{
+    double sec = 0, total = 0;
+    uint32_t i = 0, ok = 0;
+
+    for (i = 0; i < cfg.runs; ++i)
+    {
+        if ((cfg.live != NULL) ? live_run(&r->tune, &sec) : sim_run(&r->tune, ber, &sec))
+        {
+            ok++;
+            total += sec;
+        }
+    }
+    r->fail = (double)(cfg.runs - ok) / (double)cfg.runs;
+    r->goodput = (ok > 0 && total > 0) ? (double)cfg.size * ok / total : 0;
+    r->score = r->goodput * (1.0 - r->fail);
+}
+
+/* parse "a,b,c" (each "value[:ber]") */
+static int parse_list(const char *s, uint32_t *val, double *ber)
+{
+    char *end = NULL;
+    int n = 0;
+
+    while (*s != 0 && n < TUNE_LIST_MAX)
+    {
+        val[n] = (uint32_t)strtoul(s, &end, 0);
+        if (end == s)
+        {
+            return -1;
+        }
+        s = end;
+        if (ber != NULL)
+        {
+            ber[n] = (*s == ':') ? strtod(s + 1, &end) : 0;
+            s = (*s == ':') ? end : s;
+        }
+        n++;
+        s += (*s == ',') ? 1 : 0;
+    }
+    return n;
+}
+
+/* save the learned settings of the class, the other classes are kept */
+static int save(const tune_res_t *r)
+{
+    static char line[TUNE_CLASS_MAX][TUNE_LINE_MAX];
+    char name[TUNE_LINE_MAX];
+    FILE *fp = fopen(cfg.path, "r");
+    int n = 0, i = 0;
+
+    while (fp != NULL && n < TUNE_CLASS_MAX && fgets(line[n], TUNE_LINE_MAX, fp) != NULL)
+    {
+        if (sscanf(line[n], "%511s", name) == 1 && strcmp(name, cfg.cls) != 0)
+        {
+            n++;
+        }
+    }
+    if (fp != NULL)
+    {
+        fclose(fp);
+    }
+    if ((fp = fopen(cfg.path, "w")) == NULL)
+    {
+        fprintf(stderr, "save [%s] failed\n", cfg.path);
+        return -1;
+    }
+    for (i = 0; i < n; ++i)
+    {
+        fputs(line[i], fp);
+    }
+    fprintf(fp, "%s %u %u %u %u %u %.0f %.4f\n", cfg.cls, r->tune.baud, r->tune.pkt_size, r->tune.send_timeout,
+            r->tune.recv_timeout, r->tune.error_max_retry, r->goodput, r->fail);
+    fclose(fp);
+    return 0;
+}
+
+static void usage(void)
+{
+    fprintf(stderr,
+            "usage: xym-tune -c CLASS [options]\n"
+            "  -c CLASS  device class of the learned settings\n"
+            "  -o FILE   settings file (default $HOME/.xym-tune)\n"
+            "  -b LIST   baudrates[:bit error rate] (default 115200:1e-7,460800:1e-6,921600:1e-5)\n"
+            "  -k LIST   packet sizes (default 128,1024)\n"
+            "  -t LIST   receive timeouts / ms (default 20,50,100,200,500,1000,3000)\n"
+            "  -r LIST   max retries (default 3,5,10,20)\n"
+            "  -z SIZE   transfer size / Bytes (default 262144)\n"
+            "  -n RUNS   runs per candidate (default 20, live 3)\n"
+            "  -f RATE   acceptable failure rate (default 0.01)\n"
+            "  -l US     offline: one-way line latency (default 2000, USB bridge)\n"
+            "  -w US     offline: device flash write time per KiB (default 20000)\n"
+            "  -W MS     offline: device receive timeout (default 1000)\n"
+            "  -s SEED   offline: random seed (default 1)\n"
+            "  -L CMD    live: transfer command, %%b %%k %%t %%r are replaced by the candidate\n");
+}
+
+/*******************************************************************************************************************************************
+ * Public Function
+ *******************************************************************************************************************************************/
+int main(int argc, char **argv)
+{
+    static char path[4096];
+    tune_res_t r, best;
+    int opt = 0, b = 0, k = 0, t = 0, n = 0;
+
+    memset(&cfg, 0, sizeof(cfg));
+    memset(&best, 0, sizeof(best));
+    cfg.n_baud = parse_list("115200:1e-7,460800:1e-6,921600:1e-5", cfg.baud, cfg.ber);
+    cfg.n_pkt = parse_list("128,1024", cfg.pkt, NULL);
+    cfg.n_tmo = parse_list("20,50,100,200,500,1000,3000", cfg.tmo, NULL);
+    cfg.n_retry = parse_list("3,5,10,20", cfg.retry, NULL);
+    cfg.size = 262144;
+    cfg.fail_max = 0.01;
+    cfg.latency_us = 2000;
+    cfg.write_us = 20000;
+    cfg.dev_timeout_ms = 1000;
+    cfg.seed = 1;
+    while ((opt = getopt(argc, argv, "c:o:b:k:t:r:z:n:f:l:w:W:s:L:h")) != -1)
+    {
+        switch (opt)
+        {
+        case 'c': cfg.cls = optarg; break;
+        case 'o': cfg.path = optarg; break;
+        case 'b': cfg.n_baud = parse_list(optarg, cfg.baud, cfg.ber); break;
+        case 'k': cfg.n_pkt = parse_list(optarg, cfg.pkt, NULL); break;
+        case 't': cfg.n_tmo = parse_list(optarg, cfg.tmo, NULL); break;
+        case 'r': cfg.n_retry = parse_list(optarg, cfg.retry, NULL); break;
+        case 'z': cfg.size = (uint32_t)strtoul(optarg, NULL, 0); break;
+        case 'n': cfg.runs = (uint32_t)strtoul(optarg, NULL, 0); break;
+        case 'f': cfg.fail_max = strtod(optarg, NULL); break;
+        case 'l': cfg.latency_us = (uint32_t)strtoul(optarg, NULL, 0); break;
+        case 'w': cfg.write_us = (uint32_t)strtoul(optarg, NULL, 0); break;
+        case 'W': cfg.dev_timeout_ms = (uint32_t)strtoul(optarg, NULL, 0); break;
+        case 's': cfg.seed = (uint32_t)strtoul(optarg, NULL, 0); break;
+        case 'L': cfg.live = optarg; break;
+        default: usage(); return 2;
+        }
+    }
+    if (cfg.cls == NULL || strchr(cfg.cls, ' ') != NULL || cfg.n_baud <= 0 || cfg.n_pkt <= 0 || cfg.n_tmo <= 0 || cfg.n_retry <= 0 || cfg.size == 0)
+    {
+        usage();
+        return 2;
+    }
+    if (cfg.path == NULL)
+    {
+        snprintf(path, sizeof(path), "%s/.xym-tune", (getenv("HOME") != NULL) ? getenv("HOME") : ".");
+        cfg.path = path;
+    }
+    cfg.runs = (cfg.runs > 0) ? cfg.runs : (cfg.live != NULL) ? 3 : 20;
+    sim.rng = 0x9E3779B97F4A7C15ull ^ cfg.seed;
+
+    printf("%-8s %5s %6s %5s %12s %7s\n", "baud", "pkt", "tmo", "retry", "goodput B/s", "fail");
+    for (b = 0; b < cfg.n_baud; ++b)
+    {
+        for (k = 0; k < cfg.n_pkt; ++k)
+        {
+            for (t = 0; t < cfg.n_tmo; ++t)
+            {
+                for (n = 0; n < cfg.n_retry; ++n)
+                {
+                    memset(&r, 0, sizeof(r));
+                    r.tune.baud = cfg.baud[b];
+                    r.tune.pkt_size = (cfg.pkt[k] > XYM_PKT_SIZE_128) ? XYM_PKT_SIZE_1024 : XYM_PKT_SIZE_128;
+                    r.tune.recv_timeout = cfg.tmo[t];
+                    r.tune.send_timeout = cfg.tmo[t];
+                    r.tune.error_max_retry = (uint8_t)cfg.retry[n];
+                    measure(&r, cfg.ber[b]);
+                    printf("%-8u %5u %6u %5u %12.0f %7.4f%s\n", r.tune.baud, r.tune.pkt_size, r.tune.recv_timeout,
+                           r.tune.error_max_retry, r.goodput, r.fail, (r.fail > cfg.fail_max) ? "  x" : "");
+                    fflush(stdout);
+                    if (r.fail <= cfg.fail_max && r.score > best.score)
+                    {
+                        best = r;
+                    }
+                }
+            }
+        }
+    }
+    if (best.score <= 0)
+    {
+        fprintf(stderr, "no candidate within the failure rate %.4f\n", cfg.fail_max);
+        return 1;
+    }
+    printf("\n%s: baud %u, pkt %u, recv_timeout %u, retry %u, goodput %.0f B/s, fail %.4f => %s\n", cfg.cls, best.tune.baud,
+           best.tune.pkt_size, best.tune.recv_timeout, best.tune.error_max_retry, best.goodput, best.fail, cfg.path);
+    printf("static const xym_tune_t xym_tune_%s = {%u, %u, %u, %u, %u}; /* [param.tune] */\n", cfg.cls, best.tune.send_timeout,
+           best.tune.recv_timeout, best.tune.error_max_retry, best.tune.pkt_size, best.tune.baud);
+    return (save(&best) == 0) ? 0 : 1;
+}
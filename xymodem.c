@@ -8,6 +8,21 @@
  * 2023-12-10   lzh          fix possible dead loops in EOT response of [ymodem_transmit]
  * 2023-12-14   lzh          sync-change [retry_max] uint32_t => uint8_t, update enum xym_sta: add [XYM_ERROR_INVALID_DATA], del [XYM_ERROR_UNKNOWN]
  * 2023-12-24   lzh          update [struct xym_session] to prepare users for future expansion
+ * 2026-10-18   lzh          assemble / receive frames in the session frame buffer, one-shot send per frame
+ * 2026-10-18   lzh          add static session pool
+ * 2026-10-18   lzh          add asynchronous cancel request [xymodem_cancel_request], checked at every wait point
+ * 2026-10-18   lzh          bounded-time teardown: CAN sequence / trailing ACK in one send or [ops.post] within [teardown_timeout]
+ * 2026-10-18   lzh          add read-ahead buffer over [ops.read], coalesce ACK + 'C' of [ymodem_receive] into one send
+ * 2026-10-18   lzh          add deferred verification [xymodem_verify_defer] / [xymodem_receive_reject] for the receive pipeline
+ * 2026-10-18   lzh          const transmit input, add zero-copy [xmodem_transmit_span] / [ymodem_transmit_span] with virtual padding
+ * 2026-10-18   lzh          add scatter-list receive [xymodem_scatter_set], valid data lands in the destination segments
+ * 2026-10-18   lzh          add peer profiles [xymodem_profile_set] with auto-detection, fix the checksum(non-CRC) tail
+ * 2026-10-18   lzh          add parameter cache [xymodem_pcache_store] and fast start [xymodem_fast_start] of the receiver
+ * 2026-10-18   lzh          load the learned settings of the device class [param.tune] at session init
+ * 2026-10-18   lzh          add raw link access [xymodem_link_send] / [xymodem_link_recv] for protocol extensions
+ * 2026-10-18   lzh          add deferred log points [XYM_LOG] on retries, invalid data and cancel(xymodem_log.h)
+ * 2026-10-18   agent        add [ymodem_transmit_eof] to end a file, also an empty one
+ * 2026-10-18   agent        export the file info parser [ymodem_info_size]
  * @copyright (c) 2023 lzh <lzhoran@163.com>
  *                https://github.com/ZeHHHHH/Flexible-XYmodem.git
  * All rights reserved.
@@ -27,6 +42,7 @@
  */
 #include <string.h>
 #include "xymodem.h"
+#include "xymodem_log.h"
 
 /*******************************************************************************************************************************************
  * Private Prototype
@@ -41,8 +57,57 @@
 #define CRC16_FLAG              (0x43) /**< (Receiver) 'C' == 0x43, request 16-bit CRC */
 #define CTRLZ                   (0x1A) /**< (Sender) End-of-file indicated by ^Z (one or more) */
 
+/* quirks that are only taken when the profile is selected explicitly, never from a detected / cached one:
+ * a slow but standard sender must not have its batch ended by a silence */
+#define QUIRK_EXPLICIT_ONLY     (XYM_QUIRK_END_ON_SILENCE)
+
+/* quirks of each peer profile, see enum xym_profile */
+static const uint8_t xym_profile_quirk[] =
+{
+    0,                                                        /* XYM_PROFILE_STANDARD */
+    XYM_QUIRK_EOT_ACK_FIRST,                                  /* XYM_PROFILE_LRZSZ */
+    XYM_QUIRK_EOT_ACK_FIRST | XYM_QUIRK_END_ON_SILENCE,       /* XYM_PROFILE_SECURECRT */
+    XYM_QUIRK_EOT_ACK_FIRST,                                  /* XYM_PROFILE_TERATERM */
+    XYM_QUIRK_EOT_ACK_FIRST | XYM_QUIRK_END_ON_SILENCE,       /* XYM_PROFILE_EXTRAPUTTY */
+    XYM_QUIRK_EOT_ACK_FIRST | XYM_QUIRK_END_ON_SILENCE | XYM_QUIRK_LAST_NO_ACK, /* XYM_PROFILE_FLEXIBLE */
+    0,                                                        /* XYM_PROFILE_AUTO(until detected) */
+};
+
 /* X/Y modem verify data */
 static uint16_t xymodem_verify_data(const xym_session_t *p, const uint8_t *data, const uint32_t cnt);
+/* X/Y modem continue the build-in verify over more data */
+static uint16_t xymodem_verify_update(const xym_session_t *p, uint16_t result, const uint8_t *data, const uint32_t cnt);
+/* X/Y modem compare the received verify value */
+static uint8_t xymodem_tail_match(const xym_session_t *p, const uint8_t *tail, const uint16_t check_sum);
+/* X/Y modem detect the peer profile by the file info packet */
+static void xymodem_profile_detect(xym_session_t *p, const uint8_t *data, const uint16_t size);
+/* X/Y modem receive the rest of a packet(packet sequence, valid data and verify value) */
+static xym_sta_t xymodem_recv_packet(xym_session_t *p, const uint16_t size, const uint8_t scatter, const uint8_t verify, uint8_t *match);
+/* X/Y modem receive valid data into the destination segments */
+static xym_sta_t xymodem_recv_scatter(xym_session_t *p, const uint16_t size, uint16_t *check_sum);
+/* X/Y modem send a data packet and wait for its ACK */
+static xym_sta_t xymodem_transmit_packet(xym_session_t *p, const uint8_t *src, const uint16_t size, const uint8_t pad, const uint8_t wait);
+
+/* Xmodem transmit data, [src] is sent in place when [zero_copy] */
+static xym_sta_t xmodem_transmit_exec(xym_session_t *p, const uint8_t *buff, const uint16_t size, const uint8_t zero_copy);
+/* Ymodem transmit data, [src] is sent in place when [zero_copy] */
+static xym_sta_t ymodem_transmit_exec(xym_session_t *p, const uint8_t *buff, const uint16_t size, const uint8_t zero_copy);
+/* Ymodem transmit wait for the handshake of the receiver */
+static xym_sta_t ymodem_transmit_handshake(xym_session_t *p);
+/* X/Y modem get the header of the session frame buffer */
+static uint8_t *xymodem_frame_head(xym_session_t *p);
+/* X/Y modem send data, refused when cancel is requested */
+static xym_sta_t xymodem_send(xym_session_t *p, const uint8_t *data, const uint32_t cnt, const uint32_t tick);
+/* X/Y modem receive data, refused when cancel is requested */
+static xym_sta_t xymodem_recv(xym_session_t *p, uint8_t *data, const uint32_t cnt, const uint32_t tick);
+/* X/Y modem execute the asynchronous cancel request */
+static xym_sta_t xymodem_cancel_exec(xym_session_t *p);
+/* X/Y modem send the teardown sequence within the deadline */
+static xym_sta_t xymodem_teardown(xym_session_t *p, const uint8_t msg, const uint8_t cnt);
+#if XYM_RX_BUFF_SIZE > 0
+/* X/Y modem receive data through the read-ahead buffer */
+static xym_sta_t xymodem_rx_fetch(xym_session_t *p, uint8_t *data, uint32_t cnt, const uint32_t tick);
+#endif
 
 /*******************************************************************************************************************************************
  * Public Function
@@ -59,13 +124,27 @@ xym_sta_t xymodem_session_init(xym_session_t *p, struct xym_ops ops, struct xym_
     {
         return XYM_ERROR_INVALID_DATA;
     }
+    /* the learned settings of the device class take precedence */
+    if (param.tune != NULL)
+    {
+        param.send_timeout = (param.tune->send_timeout > 0) ? param.tune->send_timeout : param.send_timeout;
+        param.recv_timeout = (param.tune->recv_timeout > 0) ? param.tune->recv_timeout : param.recv_timeout;
+        param.error_max_retry = (param.tune->error_max_retry > 0) ? param.tune->error_max_retry : param.error_max_retry;
+    }
     memset(p, 0, sizeof(xym_session_t));
     p->ops.send = ops.send;
     p->ops.recv = ops.recv;
     p->ops.crc16 = ops.crc16;
+    p->ops.abort = ops.abort;
+    p->ops.post = ops.post;
+    p->ops.read = ops.read;
     p->param.send_timeout = param.send_timeout;
     p->param.recv_timeout = param.recv_timeout;
     p->param.error_max_retry = param.error_max_retry;
+    p->param.cancel_cnt = (param.cancel_cnt > 0) ? param.cancel_cnt : XYM_CANCEL_CNT_DEFAULT;
+    p->param.cancel_cnt = (p->param.cancel_cnt < XYM_CANCEL_CNT_MAX) ? p->param.cancel_cnt : XYM_CANCEL_CNT_MAX;
+    p->param.teardown_timeout = (param.teardown_timeout > 0) ? param.teardown_timeout : param.send_timeout;
+    p->param.tune = param.tune;
     return XYM_OK;
 }
 
@@ -74,20 +153,359 @@ xym_sta_t xymodem_session_init(xym_session_t *p, struct xym_ops ops, struct xym_
  * @param  p                 : session control struct
  * @retval XYM_CANCEL_ACTIVE : success over
  * @retval XYM_ERROR_HW      : hardware error
+ * @note   Bounded by [param.teardown_timeout], with [ops.post] or [ops.send]
  */
 xym_sta_t xymodem_active_cancel(xym_session_t *p)
 {
-    uint8_t cancel_singal_cnt = 3; /* third time lucky */
-    uint8_t retry = 0;
-    const uint8_t reply_msg = CANCEL;
-    for (retry = 0; retry <= p->param.error_max_retry && cancel_singal_cnt > 0; --cancel_singal_cnt)
+    return (XYM_OK == xymodem_teardown(p, CANCEL, p->param.cancel_cnt)) ? XYM_CANCEL_ACTIVE : XYM_ERROR_HW;
+}
+
+/**
+ * @brief  X/Y modem request to cancel the session asynchronously
+ * @param  p : session control struct
+ * @retval \
+ * @note   It can be called from ISR or other threads at any time, the session owner exits at the next wait point
+ *         (with [ops.abort] immediately) by sending the CAN sequence and returning XYM_CANCEL_ACTIVE.
+ */
+void xymodem_cancel_request(xym_session_t *p)
+{
+    p->lib.cancel_req = 1;
+    if (p->ops.abort)
+    {
+        p->ops.abort();
+    }
+}
+
+/**
+ * @brief  X/Y modem check the verify value of a frame
+ * @param  p     : session control struct
+ * @param  data  : valid data
+ * @param  size  : size of valid data (/ Bytes)
+ * @param  tail  : received verify value [CheckSum / CRC16_H, Reserve / CRC16_L]
+ * @retval 1: match, 0: mismatch
+ */
+uint8_t xymodem_frame_check(const xym_session_t *p, const uint8_t *data, const uint16_t size, const uint8_t *tail)
+{
+    /* select CRC16[MSB] or CheckSum[zero clearing] */
+    return xymodem_tail_match(p, tail, xymodem_verify_data(p, data, size));
+}
+
+/**
+ * @brief  X/Y modem defer the verification of data packets to the caller
+ * @param  p      : session control struct
+ * @param  enable : 0-verify in receive; 1-return data packets unverified
+ * @retval \
+ * @note   The caller checks each XYM_OK packet by [xymodem_frame_check] before the next receive,
+ *         and calls [xymodem_receive_reject] on mismatch. The ACK is only sent by the next receive.
+ */
+void xymodem_verify_defer(xym_session_t *p, const uint8_t enable)
+{
+    p->lib.defer_verify = (enable != 0) ? 1 : 0;
+}
+
+/**
+ * @brief  X/Y modem reject the data packet just returned (deferred verification failed)
+ * @param  p : session control struct
+ * @retval \
+ * @note   Only valid between a receive returning XYM_OK and the next receive, the next receive NAKs it.
+ */
+void xymodem_receive_reject(xym_session_t *p)
+{
+    p->lib.seqno--;
+    p->lib.reply_msg = NAK;
+}
+
+/**
+ * @brief  X/Y modem select the peer profile
+ * @param  p       : session control struct
+ * @param  profile : enum xym_profile
+ * @retval \
+ */
+void xymodem_profile_set(xym_session_t *p, const xym_profile_t profile)
+{
+    p->lib.profile = (profile <= XYM_PROFILE_AUTO) ? (uint8_t)profile : (uint8_t)XYM_PROFILE_STANDARD;
+    p->lib.peer = p->lib.profile;
+    p->lib.quirk = xym_profile_quirk[p->lib.peer];
+}
+
+/**
+ * @brief  X/Y modem get the peer profile in use
+ * @param  p : session control struct
+ * @retval enum xym_profile, XYM_PROFILE_AUTO: not detected yet
+ */
+xym_profile_t xymodem_profile_get(const xym_session_t *p)
+{
+    return (xym_profile_t)p->lib.peer;
+}
+
+/**
+ * @brief  X/Y modem set the destination segments of the received valid data (scatter-list receive)
+ * @param  p   : session control struct
+ * @param  seg : segments, kept by the caller until the session is over, NULL: disable
+ * @param  num : number of segments
+ * @retval \
+ */
+void xymodem_scatter_set(xym_session_t *p, const struct xym_seg *seg, const uint16_t num)
+{
+    p->lib.seg = seg;
+    p->lib.seg_num = (seg != NULL) ? num : 0;
+}
+
+/**
+ * @brief  X/Y modem send raw data over the session link(protocol extensions, eg: remote verification)
+ * @param  p    : session control struct
+ * @param  data : data
+ * @param  cnt  : data size / Bytes
+ * @param  tick : send 1 Bytes timeout / tick
+ * @retval enum xym_sta, XYM_CANCEL_ACTIVE: cancel requested
+ */
+xym_sta_t xymodem_link_send(xym_session_t *p, const uint8_t *data, const uint32_t cnt, const uint32_t tick)
+{
+    return xymodem_send(p, data, cnt, tick);
+}
+
+/**
+ * @brief  X/Y modem receive raw data over the session link(through the read-ahead buffer)
+ * @param  p    : session control struct
+ * @param  data : data
+ * @param  cnt  : data size / Bytes
+ * @param  tick : receive 1 Bytes timeout / tick
+ * @retval enum xym_sta, XYM_CANCEL_ACTIVE: cancel requested
+ */
+xym_sta_t xymodem_link_recv(xym_session_t *p, uint8_t *data, const uint32_t cnt, const uint32_t tick)
+{
+    return xymodem_recv(p, data, cnt, tick);
+}
+
+/**
+ * @brief  X/Y modem parameter cache initialization(all entries free)
+ * @param  cache : parameter cache, see [XYM_PCACHE_DEFINE]
+ * @retval enum xym_sta
+ */
+xym_sta_t xymodem_pcache_init(xym_pcache_t *cache)
+{
+    if (!(cache && cache->entry))
+    {
+        return XYM_ERROR_INVALID_DATA;
+    }
+    memset(cache->entry, 0, sizeof(cache->entry[0]) * cache->num);
+    cache->next = 0;
+    return XYM_OK;
+}
+
+/**
+ * @brief  X/Y modem find the cached parameters of a device
+ * @param  cache : parameter cache
+ * @param  id    : device identity
+ * @retval cache entry, NULL: not cached
+ */
+const xym_pcache_entry_t *xymodem_pcache_find(const xym_pcache_t *cache, const uint32_t id)
+{
+    uint16_t i = 0;
+    for (i = 0; cache && cache->entry && i < cache->num; ++i)
     {
-        if (XYM_OK != p->ops.send(&reply_msg, 1, p->param.send_timeout))
+        if (cache->entry[i].valid != 0 && cache->entry[i].id == id)
         {
-            ++retry;
+            return &cache->entry[i];
         }
     }
-    return (retry <= p->param.error_max_retry) ? XYM_CANCEL_ACTIVE : XYM_ERROR_HW;
+    return NULL;
+}
+
+/**
+ * @brief  X/Y modem store the parameters negotiated by a session into the cache
+ * @param  cache : parameter cache
+ * @param  id    : device identity
+ * @param  p     : session control struct, after the session is over normally
+ * @retval enum xym_sta
+ */
+xym_sta_t xymodem_pcache_store(xym_pcache_t *cache, const uint32_t id, const xym_session_t *p)
+{
+    xym_pcache_entry_t *entry = (xym_pcache_entry_t *)xymodem_pcache_find(cache, id);
+    uint8_t pkt_1k = (entry != NULL) ? entry->pkt_1k : 0; /* a session of small packets does not forget the 1K packet */
+    uint16_t i = 0;
+    if (!(cache && cache->entry && cache->num > 0 && p))
+    {
+        return XYM_ERROR_INVALID_DATA;
+    }
+    /* the entry of the device, a free one, or the oldest one */
+    for (i = 0; entry == NULL && i < cache->num; ++i)
+    {
+        entry = (cache->entry[i].valid == 0) ? &cache->entry[i] : NULL;
+    }
+    if (entry == NULL)
+    {
+        entry = &cache->entry[cache->next];
+        cache->next = (cache->next + 1 < cache->num) ? cache->next + 1 : 0;
+    }
+    entry->id = id;
+    entry->valid = 1;
+    entry->crc_flag = p->lib.crc_flag;
+    entry->pkt_1k = pkt_1k | p->lib.pkt_1k;
+    entry->profile = p->lib.peer;
+    return XYM_OK;
+}
+
+/**
+ * @brief  X/Y modem start the session with the cached parameters (fast start)
+ * @param  p     : session control struct
+ * @param  entry : cache entry of the peer, NULL: full negotiation
+ * @retval \
+ */
+void xymodem_fast_start(xym_session_t *p, const xym_pcache_entry_t *entry)
+{
+    if (entry == NULL || entry->valid == 0 || p->lib.handshake != 0)
+    {
+        p->lib.fast = 0;
+        return;
+    }
+    /* Ymodem(seqno start is 0) is always CRC16 */
+    p->lib.crc_flag = (p->lib.seqno == 0 || entry->crc_flag != 0) ? 1 : 0;
+    p->lib.reply_msg = (p->lib.crc_flag != 0) ? CRC16_FLAG : NAK;
+    p->lib.fast = 1;
+    if (p->lib.profile == XYM_PROFILE_AUTO && entry->profile < XYM_PROFILE_AUTO)
+    {
+        p->lib.peer = entry->profile;
+        p->lib.quirk = xym_profile_quirk[p->lib.peer] & (uint8_t)~QUIRK_EXPLICIT_ONLY;
+    }
+}
+
+/**
+ * @brief  X/Y modem session pool initialization(all sessions free)
+ * @param  pool : session pool, see [XYM_POOL_DEFINE]
+ * @retval enum xym_sta
+ */
+xym_sta_t xymodem_pool_init(xym_pool_t *pool)
+{
+    uint16_t i = 0;
+    if (!(pool && pool->session && pool->free_list))
+    {
+        return XYM_ERROR_INVALID_DATA;
+    }
+    XYM_POOL_LOCK();
+    for (i = 0; i < pool->num; ++i)
+    {
+        pool->free_list[i] = pool->num - 1 - i; /* index 0 is acquired first */
+    }
+    pool->free_cnt = pool->num;
+#if XYM_POOL_STATS
+    memset(&pool->stats, 0, sizeof(pool->stats));
+#endif
+    XYM_POOL_UNLOCK();
+    return XYM_OK;
+}
+
+/**
+ * @brief  X/Y modem acquire a session from the pool and initialize it, O(1)
+ * @param  pool  : session pool
+ * @param  ops   : struct xym_ops
+ * @param  param : struct xym_param
+ * @retval session control struct, NULL: pool exhausted or invalid parameter
+ */
+xym_session_t *xymodem_pool_acquire(xym_pool_t *pool, struct xym_ops ops, struct xym_param param)
+{
+    xym_session_t *p = NULL;
+
+    if (pool == NULL)
+    {
+        return NULL;
+    }
+    XYM_POOL_LOCK();
+    if (pool->free_cnt > 0)
+    {
+        p = &pool->session[pool->free_list[--pool->free_cnt]];
+    }
+#if XYM_POOL_STATS
+    if (p != NULL)
+    {
+        ++pool->stats.acquire;
+        if (++pool->stats.used > pool->stats.peak)
+        {
+            pool->stats.peak = pool->stats.used;
+        }
+    }
+    else
+    {
+        ++pool->stats.fail;
+    }
+#endif
+    XYM_POOL_UNLOCK();
+
+    if (p != NULL && XYM_OK != xymodem_session_init(p, ops, param))
+    {
+        xymodem_pool_release(pool, p);
+        p = NULL;
+    }
+    return p;
+}
+
+/**
+ * @brief  X/Y modem release a session back to the pool, O(1)
+ * @param  pool : session pool
+ * @param  p    : session control struct, must have been acquired from [pool] and not released yet
+ * @retval enum xym_sta
+ */
+xym_sta_t xymodem_pool_release(xym_pool_t *pool, xym_session_t *p)
+{
+    if (!(pool && p && p >= pool->session && p < &pool->session[pool->num]))
+    {
+        return XYM_ERROR_INVALID_DATA;
+    }
+    XYM_POOL_LOCK();
+    if (pool->free_cnt >= pool->num)
+    {
+        XYM_POOL_UNLOCK();
+        return XYM_ERROR_INVALID_DATA;
+    }
+    pool->free_list[pool->free_cnt++] = (uint16_t)(p - pool->session);
+#if XYM_POOL_STATS
+    ++pool->stats.release;
+    --pool->stats.used;
+#endif
+    XYM_POOL_UNLOCK();
+    return XYM_OK;
+}
+
+/**
+ * @brief  X/Y modem get the session pool statistics
+ * @param  pool  : session pool
+ * @param  stats : returned statistics (all zero if [XYM_POOL_STATS] is disabled)
+ * @retval \
+ */
+void xymodem_pool_stats(xym_pool_t *pool, xym_pool_stats_t *stats)
+{
+#if XYM_POOL_STATS
+    XYM_POOL_LOCK();
+    *stats = pool->stats;
+    XYM_POOL_UNLOCK();
+#else
+    (void)pool;
+    memset(stats, 0, sizeof(*stats));
+#endif
+}
+
+/**
+ * @brief  X/Y modem get the valid data area of the session frame buffer
+ * @param  p       : session control struct
+ * @retval uint8_t : valid data area (XYM_PKT_SIZE_1024 Bytes, aligned to XYM_FRAME_ALIGN)
+ * @note   Fill it and pass it as [buff] of transmit to skip the copy,
+ *         or pass NULL as [buff] of receive and read the valid data from here.
+ */
+uint8_t *xymodem_frame_data(xym_session_t *p)
+{
+    return (uint8_t *)(((uintptr_t)&p->frame.raw[XYM_FRAME_HEAD_SIZE] + (XYM_FRAME_ALIGN - 1)) & ~(uintptr_t)(XYM_FRAME_ALIGN - 1));
+}
+
+/**
+ * @brief  X/Y modem get the last frame assembled or received (contiguous)
+ * @param  p       : session control struct
+ * @param  size    : size of the frame (/ Bytes), 0 if there is no frame
+ * @retval uint8_t : frame [header + valid data + tail], eg: source of one-shot DMA or write
+ */
+const uint8_t *xymodem_frame_get(xym_session_t *p, uint16_t *size)
+{
+    *size = p->frame.size;
+    return xymodem_frame_head(p);
 }
 
 /**
@@ -101,6 +519,16 @@ void xmodem_init(xym_session_t *p)
     p->lib.crc_flag = 1;
     p->lib.reply_msg = (p->lib.handshake == 0 && p->lib.crc_flag != 0) ? CRC16_FLAG : NAK;
     p->lib.seqno = 1; /* xmodem start is 1, ymodem start is 0 */
+    p->lib.cancel_req = 0; /* discard the request of the previous session */
+    p->lib.offset = 0;
+    p->lib.file_size = XYM_FILE_SIZE_UNKNOWN;
+    p->lib.fast = 0;
+    p->lib.pkt_1k = 0;
+    p->lib.peer = p->lib.profile; /* no file info in Xmodem: the detected profile of a previous session is dropped */
+    p->lib.quirk = xym_profile_quirk[p->lib.peer];
+#if XYM_RX_BUFF_SIZE > 0
+    p->rx.rd = p->rx.wr = 0; /* discard the read-ahead data of the previous session */
+#endif
 }
 
 /**
@@ -115,25 +543,39 @@ void xmodem_init(xym_session_t *p)
  */
 xym_sta_t xmodem_receive(xym_session_t *p, uint8_t *buff, uint16_t *size)
 {
-    uint8_t header[3] = {0};    /* header[Special byte, Packet sequence, ~Packet sequence] */
-    uint8_t tail[2] = {0};      /* tail[CheckSum / CRC16_H, Reserve / CRC16_L] */
-    uint8_t retry = 0;          /* retry counter */
-    uint16_t pkt_data_size = 0; /* the valid data length of packet */
-    uint8_t handshake_flag = 0; /* two handshakes(CRC16 or CheckSum) */
+    uint8_t *header = xymodem_frame_head(p);      /* header[Special byte, Packet sequence, ~Packet sequence] */
+    uint8_t *data = &header[XYM_FRAME_HEAD_SIZE]; /* valid data (aligned) */
+    uint8_t retry = 0;                            /* retry counter */
+    uint16_t pkt_data_size = 0;                   /* the valid data length of packet */
+    uint16_t tail_size = 0;                       /* the verify value length of packet */
+    uint8_t handshake_flag = 0;                   /* two handshakes(CRC16 or CheckSum) */
+    uint8_t match = 0;                            /* verify value match */
 
     *size = 0; /* zero clearing */
+    p->frame.size = 0;
 
     for (retry = 0; retry <= p->param.error_max_retry; ++retry)
     {
+        /* asynchronous cancel request */
+        if (p->lib.cancel_req != 0)
+        {
+            return xymodem_cancel_exec(p);
+        }
         /* reply */
-        if (XYM_OK != p->ops.send(&p->lib.reply_msg, 1, p->param.send_timeout))
+        if (XYM_OK != xymodem_send(p, &p->lib.reply_msg, 1, p->param.send_timeout))
         {
             continue;
         }
         /* get special byte */
-        if (XYM_OK != p->ops.recv(header, 1, p->param.recv_timeout))
+        if (XYM_OK != xymodem_recv(p, header, 1, p->param.recv_timeout))
         {
-            if (p->lib.handshake == 0 && handshake_flag == 0 && retry >= p->param.error_max_retry)
+            if (p->lib.handshake == 0 && p->lib.fast != 0)
+            {
+                p->lib.fast = 0; /* the sender does not answer the cached handshake, back to full negotiation */
+                p->lib.crc_flag = 1;
+                retry = 0;
+            }
+            else if (p->lib.handshake == 0 && handshake_flag == 0 && retry >= p->param.error_max_retry)
             {
                 ++handshake_flag;
                 retry = 0;
@@ -154,36 +596,31 @@ xym_sta_t xmodem_receive(xym_session_t *p, uint8_t *buff, uint16_t *size)
             break;
         case EOT:
             p->lib.reply_msg = ACK;
-            p->ops.send(&p->lib.reply_msg, 1, p->param.send_timeout);
+            xymodem_teardown(p, ACK, 1);
             return XYM_END;
         case CANCEL:
-            if (XYM_OK == p->ops.recv(header, 1, p->param.recv_timeout))
+            if (XYM_OK == xymodem_recv(p, header, 1, p->param.recv_timeout))
             {
                 if (header[0] == CANCEL)
                 {
                     p->lib.reply_msg = ACK;
-                    p->ops.send(&p->lib.reply_msg, 1, p->param.send_timeout);
+                    xymodem_teardown(p, ACK, 1);
                     return XYM_CANCEL_REMOTE;
                 }
             }
+            else if (p->lib.cancel_req != 0)
+            {
+                return xymodem_cancel_exec(p);
+            }
+            /* fall through */
         default:
+            XYM_LOG(("xym rx: invalid special byte 0x%02x\r\n", header[0]));
             xymodem_active_cancel(p);
             return XYM_ERROR_INVALID_DATA;
         }
-        /* get packet sequence */
-        if (XYM_OK != p->ops.recv(&header[1], 2, p->param.recv_timeout))
-        {
-            p->lib.reply_msg = NAK;
-            continue;
-        }
-        /* get valid data */
-        if (XYM_OK != p->ops.recv(buff, pkt_data_size, p->param.recv_timeout))
-        {
-            p->lib.reply_msg = NAK;
-            continue;
-        }
-        /* get verify value */
-        if (XYM_OK != p->ops.recv(tail, (p->lib.crc_flag != 0) ? 2 : 1, p->param.recv_timeout))
+        /* get packet sequence, valid data and verify value, CRC16[MSB] or CheckSum[zero clearing] unless deferred */
+        tail_size = (p->lib.crc_flag != 0) ? 2 : 1;
+        if (XYM_OK != xymodem_recv_packet(p, pkt_data_size, (p->lib.seg_num > 0) ? 1 : 0, (p->lib.defer_verify == 0) ? 1 : 0, &match))
         {
             p->lib.reply_msg = NAK;
             continue;
@@ -194,24 +631,43 @@ xym_sta_t xmodem_receive(xym_session_t *p, uint8_t *buff, uint16_t *size)
             p->lib.reply_msg = NAK;
             continue;
         }
-        /* select CRC16[MSB] or CheckSum[zero clearing] */
-        if (((p->lib.crc_flag != 0) ? ((tail[0] << 8) | tail[1]) : ((0x00 << 8) | tail[0])) != xymodem_verify_data(p, buff, pkt_data_size))
+        if (match == 0)
         {
+            XYM_LOG(("xym rx: verify error, seq %u\r\n", header[1]));
             p->lib.reply_msg = NAK;
             continue;
         }
         /* verify packet sequence */
         if ((p->lib.seqno & 0xFF) != header[1])
         {
+            XYM_LOG(("xym rx: seq %u, expected %u\r\n", header[1], p->lib.seqno & 0xFF));
             p->lib.reply_msg = (((p->lib.seqno & 0xFF) - 1) == header[1]) ? ACK : NAK; /* It could be the previous package */
             continue;
         }
         /* it is valid data */
         p->lib.seqno++;
         p->lib.reply_msg = ACK;
+        p->lib.pkt_1k |= (pkt_data_size == XYM_PKT_SIZE_1024) ? 1 : 0;
+        if (p->lib.seg_num > 0)
+        {
+            p->lib.offset += pkt_data_size; /* the valid data is in the segments */
+        }
+        else
+        {
+            p->frame.size = XYM_FRAME_HEAD_SIZE + pkt_data_size + tail_size;
+            if (buff != NULL && buff != data)
+            {
+                memcpy(buff, data, pkt_data_size);
+            }
+        }
         *size = pkt_data_size;
         return XYM_OK;
     }
+    if (p->lib.cancel_req != 0)
+    {
+        return xymodem_cancel_exec(p);
+    }
+    XYM_LOG(("xym: too many retries, seq %u\r\n", p->lib.seqno & 0xFF));
     xymodem_active_cancel(p);
     return XYM_ERROR_RETRANS;
 }
@@ -226,318 +682,581 @@ xym_sta_t xmodem_receive(xym_session_t *p, uint8_t *buff, uint16_t *size)
  * @note   The function needs to be continuously polled until the end
  * @remark Support Xmodem-1K and Xmodem-128 (standard), depending on the sender settings
  */
-xym_sta_t xmodem_transmit(xym_session_t *p, uint8_t *buff, const uint16_t size)
+xym_sta_t xmodem_transmit(xym_session_t *p, const uint8_t *buff, const uint16_t size)
 {
-    uint8_t header[3] = {0};    /* header[Special byte, Packet sequence, ~Packet sequence] */
-    uint8_t tail[2] = {0};      /* tail[CheckSum / CRC16_H, Reserve / CRC16_L] */
-    uint8_t retry = 0;          /* retry counter */
-    uint16_t pkt_data_size = 0; /* the data length of packet */
-    uint16_t check_sum = 0;     /* check sum or CRC16 result */
+    return xmodem_transmit_exec(p, buff, size, 0);
+}
 
-    /* EOT */
-    if (size == 0)
+/**
+ * @brief  Xmodem transmit a span of data in place
+ * @param  p    : session control struct
+ * @param  src  : data, it is never written (eg: read-only / XIP flash)
+ * @param  len  : size of data (/ Bytes), any length, only the last packet is padded
+ * @param  done : returned size of acknowledged data (/ Bytes), may be NULL
+ * @retval XYM_OK : all data transmit OK, continue to the next span or end by [xmodem_transmit] with size 0
+ * @retval other  : session over (normal or error)
+ */
+xym_sta_t xmodem_transmit_span(xym_session_t *p, const uint8_t *src, const uint32_t len, uint32_t *done)
+{
+    xym_sta_t res = XYM_OK;
+    uint32_t offset = 0;
+    uint16_t cnt = 0;
+
+    for (offset = 0; offset < len; offset += cnt)
     {
-        header[0] = EOT;
-        for (retry = 0; retry <= p->param.error_max_retry; ++retry)
+        cnt = (len - offset > XYM_PKT_SIZE_1024) ? XYM_PKT_SIZE_1024 : (uint16_t)(len - offset);
+        res = xmodem_transmit_exec(p, &src[offset], cnt, 1);
+        if (res != XYM_OK)
         {
-            if (XYM_OK != p->ops.send(header, 1, p->param.send_timeout))
-            {
-                continue;
-            }
-            /* wait ACK */
-            if (XYM_OK != p->ops.recv(&p->lib.reply_msg, 1, p->param.recv_timeout))
+            break;
+        }
+    }
+    if (done != NULL)
+    {
+        *done = offset;
+    }
+    return res;
+}
+
+/**
+ * @brief  Ymodem session init
+ * @param  p : session control struct
+ * @retval \
+ */
+void ymodem_init(xym_session_t *p)
+{
+    p->lib.handshake = 0;
+    p->lib.crc_flag = 1;
+    p->lib.reply_msg = (p->lib.handshake == 0 && p->lib.crc_flag != 0) ? CRC16_FLAG : NAK;
+    p->lib.seqno = 0; /* xmodem start is 1, ymodem start is 0 */
+    p->lib.cancel_req = 0; /* discard the request of the previous session */
+    p->lib.offset = 0;
+    p->lib.file_size = XYM_FILE_SIZE_UNKNOWN;
+    p->lib.fast = 0;
+    p->lib.pkt_1k = 0;
+    p->lib.peer = p->lib.profile; /* detect again in [XYM_PROFILE_AUTO] */
+    p->lib.quirk = xym_profile_quirk[p->lib.peer];
+#if XYM_RX_BUFF_SIZE > 0
+    p->rx.rd = p->rx.wr = 0; /* discard the read-ahead data of the previous session */
+#endif
+}
+
+/**
+ * @brief  Ymodem receive data
+ * @param  p      : session control struct
+ * @param  buff   : returned data buffer (128 or 1024 Bytes)
+ * @param  size   : size of returned data (/ Bytes)
+ * @retval XYM_OK      : return a packet of valid data
+ * @retval XYM_FIL_GET : return a packet of file info
+ * @retval other       : session over (normal or error)
+ * @note   The function needs to be continuously polled until the end
+ * @remark No support Ymodem-g, because it is easy to cause buffer-overflow
+ */
+xym_sta_t ymodem_receive(xym_session_t *p, uint8_t *buff, uint16_t *size)
+{
+    uint8_t *header = xymodem_frame_head(p);      /* header[Special byte, Packet sequence, ~Packet sequence] */
+    uint8_t *data = &header[XYM_FRAME_HEAD_SIZE]; /* valid data (aligned) */
+    uint8_t retry = 0;                            /* retry counter */
+    uint16_t pkt_data_size = 0;                   /* the valid data length of packet */
+    uint8_t eot_flag = 0;                         /* wave twice */
+    uint8_t continue_reply = 0;                   /* continue reply flag */
+    uint8_t reply[2] = {0};                       /* reply[reply msg, CRC16_FLAG] */
+    uint8_t scatter = 0;                          /* valid data into the segments */
+    uint8_t file_end = 0;                         /* a file has ended in this call */
+    uint8_t match = 0;                            /* verify value match */
+
+    *size = 0; /* zero clearing */
+    p->frame.size = 0;
+
+    for (retry = 0; retry <= p->param.error_max_retry; retry += (continue_reply == 0) ? 1 : 0)
+    {
+        /* asynchronous cancel request */
+        if (p->lib.cancel_req != 0)
+        {
+            return xymodem_cancel_exec(p);
+        }
+        continue_reply = 0;
+        /* reply, ACK is followed by 'C' in one send(After First Filename packet || After the second EOT) */
+        reply[0] = p->lib.reply_msg;
+        reply[1] = CRC16_FLAG;
+        if (XYM_OK != xymodem_send(p, reply, (p->lib.handshake == 0 && p->lib.reply_msg == ACK) ? 2 : 1, p->param.send_timeout))
+        {
+            continue;
+        }
+        if (p->lib.handshake == 0 && p->lib.reply_msg == ACK)
+        {
+            p->lib.reply_msg = CRC16_FLAG;
+        }
+        /* get special byte */
+        if (XYM_OK != xymodem_recv(p, header, 1, p->param.recv_timeout))
+        {
+            if (p->lib.cancel_req != 0)
             {
-                continue;
+                return xymodem_cancel_exec(p);
             }
-            if (p->lib.reply_msg == ACK)
+            /* the peer ends the batch without the null header */
+            if (file_end != 0 && p->lib.handshake == 0 && (p->lib.quirk & XYM_QUIRK_END_ON_SILENCE) != 0)
             {
                 return XYM_END;
             }
-        }
-        xymodem_active_cancel(p);
-        return XYM_ERROR_RETRANS;
-    }
-    /* Handshake */
-    for (retry = 0; p->lib.handshake == 0 && retry <= p->param.error_max_retry; retry += (p->lib.handshake == 0) ? 1 : 0)
-    {
-        /* wait handshake */
-        if (XYM_OK != p->ops.recv(&p->lib.reply_msg, 1, p->param.recv_timeout))
-        {
+            p->lib.reply_msg = (p->lib.handshake == 0) ? CRC16_FLAG : NAK;
             continue;
         }
-        /* parsing handshake */
-        switch (p->lib.reply_msg)
+        p->lib.handshake = 1;
+        /* parsing special byte */
+        switch (header[0])
         {
-        case CRC16_FLAG:
-            p->lib.crc_flag = 1;
-            p->lib.handshake = 1;
+        case SOH:
+            pkt_data_size = XYM_PKT_SIZE_128;
             break;
-        case NAK:
-            p->lib.crc_flag = 0;
-            p->lib.handshake = 1;
+        case STX:
+            pkt_data_size = XYM_PKT_SIZE_1024;
             break;
+        case EOT:
+            p->lib.reply_msg = (eot_flag == 0 && (p->lib.quirk & XYM_QUIRK_EOT_ACK_FIRST) == 0) ? NAK : ACK;
+            if (++eot_flag == 2 || p->lib.reply_msg == ACK)
+            {
+                eot_flag = 0;
+                file_end = 1;
+                /* restart a new file */
+                p->lib.handshake = 0;
+                p->lib.seqno = 0;
+            }
+            continue_reply = 1; /* it is not an error */
+            continue;
+
         case CANCEL:
-            if (XYM_OK == p->ops.recv(&p->lib.reply_msg, 1, p->param.recv_timeout))
+            if (XYM_OK == xymodem_recv(p, header, 1, p->param.recv_timeout))
             {
-                if (p->lib.reply_msg == CANCEL)
+                if (header[0] == CANCEL)
                 {
+                    p->lib.reply_msg = ACK;
+                    xymodem_teardown(p, ACK, 1);
                     return XYM_CANCEL_REMOTE;
                 }
             }
-        case ACK:
+            else if (p->lib.cancel_req != 0)
+            {
+                return xymodem_cancel_exec(p);
+            }
+            /* fall through */
         default:
+            XYM_LOG(("xym rx: invalid special byte 0x%02x\r\n", header[0]));
             xymodem_active_cancel(p);
             return XYM_ERROR_INVALID_DATA;
         }
-    }
-    if (retry > p->param.error_max_retry)
-    {
-        xymodem_active_cancel(p);
-        return XYM_ERROR_RETRANS;
-    }
-
-    /* packet init */
-    pkt_data_size = (size > XYM_PKT_SIZE_128) ? XYM_PKT_SIZE_1024 : XYM_PKT_SIZE_128;
-    header[0] = (pkt_data_size == XYM_PKT_SIZE_128) ? SOH : STX;
-    header[1] = p->lib.seqno & 0xFF;
-    header[2] = ~header[1];
-    /* End-of-file indicated by ^Z */
-    if (size != pkt_data_size)
-    {
-        memset(&buff[size], CTRLZ, pkt_data_size - size);
-    }
-    /* select CRC16[MSB] or CheckSum[zero clearing] */
-    check_sum = xymodem_verify_data(p, buff, pkt_data_size);
-    tail[0] = (check_sum >> 8) & 0xFF;
-    tail[1] = check_sum & 0xFF;
-
-    for (retry = 0; retry <= p->param.error_max_retry; ++retry)
-    {
-        /* send header */
-        if (XYM_OK != p->ops.send(header, sizeof(header) / sizeof(header[0]), p->param.send_timeout))
+        /* get packet sequence, valid data and verify value, CRC16[MSB] unless deferred(the file info packet is always verified here) */
+        scatter = (p->lib.seg_num > 0 && p->lib.seqno != 0) ? 1 : 0; /* the file info packet stays in the frame buffer */
+        if (XYM_OK != xymodem_recv_packet(p, pkt_data_size, scatter, (p->lib.defer_verify == 0 || p->lib.seqno == 0) ? 1 : 0, &match))
         {
+            p->lib.reply_msg = NAK;
             continue;
         }
-        /* send valid data */
-        if (XYM_OK != p->ops.send(buff, pkt_data_size, p->param.send_timeout))
+        /* verify packet sequence complement */
+        if (header[1] != (~header[2] & 0xFF))
         {
+            p->lib.reply_msg = NAK;
             continue;
         }
-        /* send checksum */
-        if (XYM_OK != p->ops.send(tail, (p->lib.crc_flag != 0) ? 2 : 1, p->param.send_timeout))
+        if (match == 0)
         {
+            XYM_LOG(("xym rx: verify error, seq %u\r\n", header[1]));
+            p->lib.reply_msg = NAK;
             continue;
         }
-        /* wait reply */
-        if (XYM_OK != p->ops.recv(&p->lib.reply_msg, 1, p->param.recv_timeout))
+        /* verify packet sequence */
+        if ((p->lib.seqno & 0xFF) != header[1])
         {
+            XYM_LOG(("xym rx: seq %u, expected %u\r\n", header[1], p->lib.seqno & 0xFF));
+            p->lib.reply_msg = (((p->lib.seqno & 0xFF) - 1) == header[1]) ? ACK : NAK; /* It could be the previous package */
             continue;
         }
-        /* parsing reply msg */
-        switch (p->lib.reply_msg)
+        /* Filename packet is first */
+        if (p->lib.seqno == 0)
         {
-        case ACK:
-            p->lib.seqno++;
-            return XYM_OK;
-        case NAK:
-        case CRC16_FLAG:
-            break;
-        case CANCEL:
-            if (XYM_OK == p->ops.recv(&p->lib.reply_msg, 1, p->param.recv_timeout))
+            /* Filename packet is empty(null pathname, whatever the padding), end session */
+            if (data[0] == 0)
             {
-                if (p->lib.reply_msg == CANCEL)
-                {
-                    return XYM_CANCEL_REMOTE;
-                }
+                p->lib.reply_msg = ACK;
+                xymodem_teardown(p, ACK, 1);
+                return XYM_END;
             }
-        default:
-            xymodem_active_cancel(p);
-            return XYM_ERROR_INVALID_DATA;
+            /* Filename packet has valid data */
+            p->lib.handshake = 0;
+            if (p->lib.profile == XYM_PROFILE_AUTO && p->lib.peer == XYM_PROFILE_AUTO)
+            {
+                xymodem_profile_detect(p, data, pkt_data_size);
+            }
+        }
+        /* it is valid data */
+        p->lib.seqno++;
+        p->lib.reply_msg = ACK;
+        p->lib.pkt_1k |= (pkt_data_size == XYM_PKT_SIZE_1024) ? 1 : 0;
+        if (scatter != 0)
+        {
+            p->lib.offset += pkt_data_size; /* the valid data is in the segments */
         }
+        else
+        {
+            if (p->lib.handshake == 0)
+            {
+                p->lib.offset = 0; /* the file info packet starts a new file */
+                p->lib.file_size = ymodem_info_size(data, pkt_data_size);
+            }
+            p->frame.size = XYM_FRAME_HEAD_SIZE + pkt_data_size + 2;
+            if (buff != NULL && buff != data)
+            {
+                memcpy(buff, data, pkt_data_size);
+            }
+        }
+        *size = pkt_data_size;
+        return (p->lib.handshake) ? XYM_OK : XYM_FIL_GET;
     }
+    if (p->lib.cancel_req != 0)
+    {
+        return xymodem_cancel_exec(p);
+    }
+    XYM_LOG(("xym: too many retries, seq %u\r\n", p->lib.seqno & 0xFF));
     xymodem_active_cancel(p);
     return XYM_ERROR_RETRANS;
 }
 
 /**
- * @brief  Ymodem session init
- * @param  p : session control struct
- * @retval \
+ * @brief  Ymodem file size of the file info packet: "name\0size ..."
+ * @param  data : valid data of the file info packet
+ * @param  size : size of valid data (/ Bytes)
+ * @retval file size / Bytes, XYM_FILE_SIZE_UNKNOWN: no size, or too large
  */
-void ymodem_init(xym_session_t *p)
+uint32_t ymodem_info_size(const uint8_t *data, const uint16_t size)
 {
-    p->lib.handshake = 0;
-    p->lib.crc_flag = 1;
-    p->lib.reply_msg = (p->lib.handshake == 0 && p->lib.crc_flag != 0) ? CRC16_FLAG : NAK;
-    p->lib.seqno = 0; /* xmodem start is 1, ymodem start is 0 */
+    uint32_t file_size = 0;
+    uint16_t i = 0;
+
+    for (i = 0; i < size && data[i] != 0; ++i)
+    {
+    }
+    if (++i >= size || data[i] < '0' || data[i] > '9')
+    {
+        return XYM_FILE_SIZE_UNKNOWN;
+    }
+    for (; i < size && data[i] >= '0' && data[i] <= '9'; ++i)
+    {
+        if (file_size > (XYM_FILE_SIZE_UNKNOWN - 9) / 10)
+        {
+            return XYM_FILE_SIZE_UNKNOWN;
+        }
+        file_size = file_size * 10 + (uint32_t)(data[i] - '0');
+    }
+    return file_size;
 }
 
 /**
- * @brief  Ymodem receive data
+ * @brief  Ymodem transmit data
  * @param  p      : session control struct
- * @param  buff   : returned data buffer (128 or 1024 Bytes)
- * @param  size   : size of returned data (/ Bytes)
- * @retval XYM_OK      : return a packet of valid data
- * @retval XYM_FIL_GET : return a packet of file info
+ * @param  buff   : data buffer (128 or 1024 Bytes)
+ * @param  size   : size of data (/ Bytes), If the size is 0, exec next file transmit or end.
+ * @retval XYM_OK      : transmit OK, continue to the next transmit
+ * @retval XYM_FIL_SET : set file info packet
  * @retval other       : session over (normal or error)
  * @note   The function needs to be continuously polled until the end
  * @remark No support Ymodem-g, because it is easy to cause buffer-overflow
  */
-xym_sta_t ymodem_receive(xym_session_t *p, uint8_t *buff, uint16_t *size)
+xym_sta_t ymodem_transmit(xym_session_t *p, const uint8_t *buff, const uint16_t size)
 {
-    uint8_t header[3] = {0};    /* header[Special byte, Packet sequence, ~Packet sequence] */
-    uint8_t tail[2] = {0};      /* tail[CRC16_H, CRC16_L] */
-    uint8_t retry = 0;          /* retry counter */
-    uint16_t pkt_data_size = 0; /* the valid data length of packet */
-    uint8_t eot_flag = 0;       /* wave twice */
-    uint8_t continue_reply = 0; /* continue reply flag */
+    return ymodem_transmit_exec(p, buff, size, 0);
+}
 
-    *size = 0; /* zero clearing */
+/**
+ * @brief  Ymodem transmit the end of the current file (EOT)
+ * @param  p : session control struct
+ * @retval XYM_FIL_SET            : file over, next file info packet or the end of batch
+ * @retval XYM_ERROR_INVALID_DATA : no file info packet sent, nothing is sent
+ * @retval other                  : session over (error)
+ * @note   Also ends an empty file: right after the file info packet, the receiver asks for the data by 'C' first
+ */
+xym_sta_t ymodem_transmit_eof(xym_session_t *p)
+{
+    xym_sta_t res = XYM_OK;
 
-    for (retry = 0; retry <= p->param.error_max_retry; retry += (continue_reply == 0) ? 1 : 0)
+    if (p->lib.handshake == 0)
     {
-        continue_reply = 0;
-        /* reply */
-        if (XYM_OK != p->ops.send(&p->lib.reply_msg, 1, p->param.send_timeout))
+        if (p->lib.seqno != 1)
         {
-            continue;
+            return XYM_ERROR_INVALID_DATA;
         }
-        /* continue reply(After First Filename packet || After the second EOT) */
-        if (p->lib.handshake == 0 && p->lib.reply_msg == ACK)
+        if (XYM_OK != (res = ymodem_transmit_handshake(p)))
         {
-            p->lib.reply_msg = CRC16_FLAG;
-            continue_reply = 1; /* it is not an error */
-            continue;
+            return res;
         }
-        /* get special byte */
-        if (XYM_OK != p->ops.recv(header, 1, p->param.recv_timeout))
+    }
+    return ymodem_transmit_exec(p, xymodem_frame_data(p), 0, 0);
+}
+
+/**
+ * @brief  Ymodem transmit a span of file data in place
+ * @param  p    : session control struct
+ * @param  src  : data, it is never written (eg: read-only / XIP flash)
+ * @param  len  : size of data (/ Bytes), any length, only the last packet is padded
+ * @param  done : returned size of acknowledged data (/ Bytes), may be NULL
+ * @retval XYM_OK : all data transmit OK, continue to the next span or end the file by [ymodem_transmit_eof]
+ * @retval other  : session over (normal or error)
+ * @note   Send the file info packet by [ymodem_transmit] first
+ */
+xym_sta_t ymodem_transmit_span(xym_session_t *p, const uint8_t *src, const uint32_t len, uint32_t *done)
+{
+    xym_sta_t res = XYM_OK;
+    uint32_t offset = 0;
+    uint16_t cnt = 0;
+
+    for (offset = 0; offset < len; offset += cnt)
+    {
+        cnt = (len - offset > XYM_PKT_SIZE_1024) ? XYM_PKT_SIZE_1024 : (uint16_t)(len - offset);
+        res = ymodem_transmit_exec(p, &src[offset], cnt, 1);
+        if (res != XYM_OK)
+        {
+            break;
+        }
+    }
+    if (done != NULL)
+    {
+        *done = offset;
+    }
+    return res;
+}
+
+/*******************************************************************************************************************************************
+ * Private Function
+ *******************************************************************************************************************************************/
+/**
+ * @brief  X/Y modem get the header of the session frame buffer
+ * @param  p       : session control struct
+ * @retval uint8_t : header, the valid data follows it on an [XYM_FRAME_ALIGN] boundary
+ */
+static uint8_t *xymodem_frame_head(xym_session_t *p)
+{
+    return xymodem_frame_data(p) - XYM_FRAME_HEAD_SIZE;
+}
+
+/**
+ * @brief  X/Y modem send data, refused when cancel is requested
+ * @param  p     : session control struct
+ * @param  data  : data
+ * @param  cnt   : data size / Bytes
+ * @param  tick  : send 1 Bytes timeout / tick
+ * @retval enum xym_sta
+ */
+static xym_sta_t xymodem_send(xym_session_t *p, const uint8_t *data, const uint32_t cnt, const uint32_t tick)
+{
+    xym_sta_t res = XYM_CANCEL_ACTIVE;
+    if (p->lib.cancel_req == 0)
+    {
+        res = p->ops.send(data, cnt, tick);
+    }
+    return (p->lib.cancel_req == 0) ? res : XYM_CANCEL_ACTIVE;
+}
+
+/**
+ * @brief  X/Y modem receive data, refused when cancel is requested
+ * @param  p     : session control struct
+ * @param  data  : data
+ * @param  cnt   : data size / Bytes
+ * @param  tick  : receive 1 Bytes timeout / tick
+ * @retval enum xym_sta
+ */
+static xym_sta_t xymodem_recv(xym_session_t *p, uint8_t *data, const uint32_t cnt, const uint32_t tick)
+{
+    xym_sta_t res = XYM_CANCEL_ACTIVE;
+    if (p->lib.cancel_req == 0)
+    {
+#if XYM_RX_BUFF_SIZE > 0
+        res = (p->ops.read) ? xymodem_rx_fetch(p, data, cnt, tick) : p->ops.recv(data, cnt, tick);
+#else
+        res = p->ops.recv(data, cnt, tick);
+#endif
+    }
+    return (p->lib.cancel_req == 0) ? res : XYM_CANCEL_ACTIVE;
+}
+
+/**
+ * @brief  X/Y modem execute the asynchronous cancel request
+ * @param  p                 : session control struct
+ * @retval XYM_CANCEL_ACTIVE : success over
+ * @retval XYM_ERROR_HW      : hardware error
+ */
+static xym_sta_t xymodem_cancel_exec(xym_session_t *p)
+{
+    xym_sta_t res = XYM_OK;
+
+    XYM_LOG(("xym: cancel request\r\n"));
+    res = xymodem_active_cancel(p);
+    p->lib.cancel_req = 0;
+    return res;
+}
+
+/**
+ * @brief  X/Y modem send the teardown sequence within the deadline
+ * @param  p     : session control struct
+ * @param  msg   : teardown message (CAN / ACK)
+ * @param  cnt   : repeat times of [msg]
+ * @retval enum xym_sta
+ * @note   One attempt only, bounded by [teardown_timeout]: one [ops.post] if possible, else one [ops.send].
+ *         Ignore the cancel request, it is the last output of the session.
+ */
+static xym_sta_t xymodem_teardown(xym_session_t *p, const uint8_t msg, const uint8_t cnt)
+{
+    uint8_t seq[XYM_CANCEL_CNT_MAX] = {0}; /* the frame buffer may still hold user data */
+    uint32_t tick = p->param.teardown_timeout / cnt;
+
+    memset(seq, msg, cnt);
+    if (p->ops.post)
+    {
+        return p->ops.post(seq, cnt, p->param.teardown_timeout);
+    }
+    return p->ops.send(seq, cnt, (tick > 0) ? tick : 1);
+}
+
+/**
+ * @brief  Xmodem transmit data
+ * @param  p         : session control struct
+ * @param  buff      : data buffer (1 ~ 1024 Bytes)
+ * @param  size      : size of data (/ Bytes), If the size is 0, exec end.
+ * @param  zero_copy : 0-assemble the data in the frame buffer; 1-send [buff] in place
+ * @retval enum xym_sta
+ */
+static xym_sta_t xmodem_transmit_exec(xym_session_t *p, const uint8_t *buff, const uint16_t size, const uint8_t zero_copy)
+{
+    uint8_t *header = xymodem_frame_head(p);      /* header[Special byte, Packet sequence, ~Packet sequence] */
+    uint8_t *data = &header[XYM_FRAME_HEAD_SIZE]; /* valid data (aligned) */
+    uint8_t retry = 0;                            /* retry counter */
+    xym_sta_t res = XYM_OK;
+    /* EOT */
+    if (size == 0)
+    {
+        header[0] = EOT;
+        for (retry = 0; retry <= p->param.error_max_retry; ++retry)
+        {
+            /* asynchronous cancel request */
+            if (p->lib.cancel_req != 0)
+            {
+                return xymodem_cancel_exec(p);
+            }
+            if (XYM_OK != xymodem_send(p, header, 1, p->param.send_timeout))
+            {
+                continue;
+            }
+            /* wait ACK */
+            if (XYM_OK != xymodem_recv(p, &p->lib.reply_msg, 1, p->param.recv_timeout))
+            {
+                continue;
+            }
+            if (p->lib.reply_msg == ACK)
+            {
+                return XYM_END;
+            }
+        }
+        if (p->lib.cancel_req != 0)
+        {
+            return xymodem_cancel_exec(p);
+        }
+        xymodem_active_cancel(p);
+        return XYM_ERROR_RETRANS;
+    }
+    /* Handshake */
+    for (retry = 0; p->lib.handshake == 0 && retry <= p->param.error_max_retry; retry += (p->lib.handshake == 0) ? 1 : 0)
+    {
+        /* asynchronous cancel request */
+        if (p->lib.cancel_req != 0)
+        {
+            return xymodem_cancel_exec(p);
+        }
+        /* wait handshake */
+        if (XYM_OK != xymodem_recv(p, &p->lib.reply_msg, 1, p->param.recv_timeout))
         {
-            p->lib.reply_msg = (p->lib.handshake == 0) ? CRC16_FLAG : NAK;
             continue;
         }
-        p->lib.handshake = 1;
-        /* parsing special byte */
-        switch (header[0])
+        /* parsing handshake */
+        switch (p->lib.reply_msg)
         {
-        case SOH:
-            pkt_data_size = XYM_PKT_SIZE_128;
+        case CRC16_FLAG:
+            p->lib.crc_flag = 1;
+            p->lib.handshake = 1;
             break;
-        case STX:
-            pkt_data_size = XYM_PKT_SIZE_1024;
+        case NAK:
+            p->lib.crc_flag = 0;
+            p->lib.handshake = 1;
             break;
-        case EOT:
-            p->lib.reply_msg = (eot_flag == 0) ? NAK : ACK;
-            if (++eot_flag == 2)
-            {
-                eot_flag = 0;
-                /* restart a new file */
-                p->lib.handshake = 0;
-                p->lib.seqno = 0;
-            }
-            continue_reply = 1; /* it is not an error */
-            continue;
-
         case CANCEL:
-            if (XYM_OK == p->ops.recv(header, 1, p->param.recv_timeout))
+            if (XYM_OK == xymodem_recv(p, &p->lib.reply_msg, 1, p->param.recv_timeout))
             {
-                if (header[0] == CANCEL)
+                if (p->lib.reply_msg == CANCEL)
                 {
-                    p->lib.reply_msg = ACK;
-                    p->ops.send(&p->lib.reply_msg, 1, p->param.send_timeout);
                     return XYM_CANCEL_REMOTE;
                 }
             }
+            else if (p->lib.cancel_req != 0)
+            {
+                return xymodem_cancel_exec(p);
+            }
+            xymodem_active_cancel(p);
+            return XYM_ERROR_INVALID_DATA;
+        case ACK:
         default:
             xymodem_active_cancel(p);
             return XYM_ERROR_INVALID_DATA;
         }
-        /* get packet sequence */
-        if (XYM_OK != p->ops.recv(&header[1], 2, p->param.recv_timeout))
-        {
-            p->lib.reply_msg = NAK;
-            continue;
-        }
-        /* get valid data */
-        if (XYM_OK != p->ops.recv(buff, pkt_data_size, p->param.recv_timeout))
-        {
-            p->lib.reply_msg = NAK;
-            continue;
-        }
-        /* get verify value */
-        if (XYM_OK != p->ops.recv(tail, 2, p->param.recv_timeout))
-        {
-            p->lib.reply_msg = NAK;
-            continue;
-        }
-        /* verify packet sequence complement */
-        if (header[1] != (~header[2] & 0xFF))
-        {
-            p->lib.reply_msg = NAK;
-            continue;
-        }
-        /* CRC16[MSB] */
-        if (((tail[0] << 8) | tail[1]) != xymodem_verify_data(p, buff, pkt_data_size))
-        {
-            p->lib.reply_msg = NAK;
-            continue;
-        }
-        /* verify packet sequence */
-        if ((p->lib.seqno & 0xFF) != header[1])
-        {
-            p->lib.reply_msg = (((p->lib.seqno & 0xFF) - 1) == header[1]) ? ACK : NAK; /* It could be the previous package */
-            continue;
-        }
-        /* Filename packet is first */
-        if (p->lib.seqno == 0)
+    }
+    if (retry > p->param.error_max_retry)
+    {
+        if (p->lib.cancel_req != 0)
         {
-            /* Filename packet is empty, end session */
-            if (buff[0] == 0 && tail[0] == 0 && tail[1] == 0)
-            {
-                p->lib.reply_msg = ACK;
-                p->ops.send(&p->lib.reply_msg, 1, p->param.send_timeout);
-                return XYM_END;
-            }
-            /* Filename packet has valid data */
-            p->lib.handshake = 0;
+            return xymodem_cancel_exec(p);
         }
-        /* it is valid data */
+        xymodem_active_cancel(p);
+        return XYM_ERROR_RETRANS;
+    }
+
+    /* assemble valid data in the frame buffer, unless it is sent in place */
+    if (zero_copy == 0 && buff != data)
+    {
+        memcpy(data, buff, size);
+        buff = data;
+    }
+    res = xymodem_transmit_packet(p, buff, size, CTRLZ, 1); /* End-of-file indicated by ^Z */
+    if (res == XYM_OK)
+    {
         p->lib.seqno++;
-        p->lib.reply_msg = ACK;
-        *size = pkt_data_size;
-        return (p->lib.handshake) ? XYM_OK : XYM_FIL_GET;
     }
-    xymodem_active_cancel(p);
-    return XYM_ERROR_RETRANS;
+    return res;
 }
 
 /**
  * @brief  Ymodem transmit data
- * @param  p      : session control struct
- * @param  buff   : data buffer (128 or 1024 Bytes)
- * @param  size   : size of data (/ Bytes), If the size is 0, exec next file transmit or end.
- * @retval XYM_OK      : transmit OK, continue to the next transmit
- * @retval XYM_FIL_SET : set file info packet
- * @retval other       : session over (normal or error)
- * @note   The function needs to be continuously polled until the end
- * @remark No support Ymodem-g, because it is easy to cause buffer-overflow
+ * @param  p         : session control struct
+ * @param  buff      : data buffer (1 ~ 1024 Bytes)
+ * @param  size      : size of data (/ Bytes), If the size is 0, exec next file transmit or end.
+ * @param  zero_copy : 0-assemble the data in the frame buffer; 1-send [buff] in place
+ * @retval enum xym_sta
  */
-xym_sta_t ymodem_transmit(xym_session_t *p, uint8_t *buff, const uint16_t size)
+static xym_sta_t ymodem_transmit_exec(xym_session_t *p, const uint8_t *buff, const uint16_t size, const uint8_t zero_copy)
 {
-    uint8_t header[3] = {0};    /* header[Special byte, Packet sequence, ~Packet sequence] */
-    uint8_t tail[2] = {0};      /* tail[CheckSum / CRC16_H, Reserve / CRC16_L] */
-    uint8_t retry = 0;          /* retry counter */
-    uint16_t pkt_data_size = 0; /* the data length of packet */
-    uint8_t eot_flag = 0;       /* wave twice */
-    uint16_t check_sum = 0;     /* check sum or CRC16 result */
-    uint8_t f_pkt_flag = 0;     /* file pkt flag */
-
+    uint8_t *header = xymodem_frame_head(p);      /* header[Special byte, Packet sequence, ~Packet sequence] */
+    uint8_t *data = &header[XYM_FRAME_HEAD_SIZE]; /* valid data (aligned) */
+    uint8_t retry = 0;                            /* retry counter */
+    uint8_t eot_flag = 0;                         /* wave twice */
+    uint8_t f_pkt_flag = 0;                       /* file pkt flag */
+    xym_sta_t res = XYM_OK;
     /* EOT */
     if (size == 0 && p->lib.handshake > 0)
     {
         header[0] = EOT;
         for (retry = 0; retry <= p->param.error_max_retry; retry += (eot_flag != 1) ? 1 : 0)
         {
-            if (XYM_OK != p->ops.send(header, 1, p->param.send_timeout))
+            /* asynchronous cancel request */
+            if (p->lib.cancel_req != 0)
+            {
+                return xymodem_cancel_exec(p);
+            }
+            if (XYM_OK != xymodem_send(p, header, 1, p->param.send_timeout))
             {
                 if (eot_flag > 0)
                 {
@@ -546,7 +1265,7 @@ xym_sta_t ymodem_transmit(xym_session_t *p, uint8_t *buff, const uint16_t size)
                 continue;
             }
             /* wait ACK */
-            if (XYM_OK != p->ops.recv(&p->lib.reply_msg, 1, p->param.recv_timeout))
+            if (XYM_OK != xymodem_recv(p, &p->lib.reply_msg, 1, p->param.recv_timeout))
             {
                 if (eot_flag > 0)
                 {
@@ -568,16 +1287,68 @@ xym_sta_t ymodem_transmit(xym_session_t *p, uint8_t *buff, const uint16_t size)
         }
         if (retry > p->param.error_max_retry)
         {
+            if (p->lib.cancel_req != 0)
+            {
+                return xymodem_cancel_exec(p);
+            }
             xymodem_active_cancel(p);
             return XYM_ERROR_RETRANS;
         }
     }
 
     /* Handshake */
+    if (p->lib.handshake == 0)
+    {
+        if (XYM_OK != (res = ymodem_transmit_handshake(p)))
+        {
+            return res;
+        }
+        f_pkt_flag = 1;
+    }
+
+    /* assemble valid data in the frame buffer, unless it is sent in place; the null header is always built there */
+    if (size == 0)
+    {
+        buff = data;
+    }
+    else if (zero_copy == 0 && buff != data)
+    {
+        memcpy(data, buff, size);
+        buff = data;
+    }
+    /* End-of-file indicated by ^Z or 0x00, the ACK of the end-of-batch null header is skipped if the peer does not need it */
+    res = xymodem_transmit_packet(p, buff, size, (size > 0) ? CTRLZ : 0x00, (size > 0 || (p->lib.quirk & XYM_QUIRK_LAST_NO_ACK) == 0) ? 1 : 0);
+    if (res == XYM_OK)
+    {
+        if (f_pkt_flag > 0 && p->lib.seqno == 0)
+        {
+            p->lib.handshake = 0;
+        }
+        p->lib.seqno++;
+        return (size > 0) ? XYM_OK : XYM_END;
+    }
+    return res;
+}
+
+/**
+ * @brief  Ymodem transmit wait for the handshake('C') of the receiver
+ * @param  p : session control struct
+ * @retval XYM_OK : handshake over
+ * @retval other  : session over (error)
+ */
+static xym_sta_t ymodem_transmit_handshake(xym_session_t *p)
+{
+    uint8_t retry = 0; /* retry counter */
+
     for (retry = 0; p->lib.handshake == 0 && retry <= p->param.error_max_retry; retry += (p->lib.handshake == 0) ? 1 : 0)
     {
+        /* asynchronous cancel request */
+        if (p->lib.cancel_req != 0)
+        {
+            return xymodem_cancel_exec(p);
+        }
         /* wait handshake */
-        if (XYM_OK != p->ops.recv(&p->lib.reply_msg, 1, p->param.recv_timeout))
+        if (XYM_OK != xymodem_recv(p, &p->lib.reply_msg, 1, p->param.recv_timeout))
         {
             continue;
         }
@@ -587,16 +1358,21 @@ xym_sta_t ymodem_transmit(xym_session_t *p, uint8_t *buff, const uint16_t size)
         case CRC16_FLAG:
             p->lib.crc_flag = 1;
             p->lib.handshake = 1;
-            f_pkt_flag = 1;
             break;
         case CANCEL:
-            if (XYM_OK == p->ops.recv(&p->lib.reply_msg, 1, p->param.recv_timeout))
+            if (XYM_OK == xymodem_recv(p, &p->lib.reply_msg, 1, p->param.recv_timeout))
             {
                 if (p->lib.reply_msg == CANCEL)
                 {
                     return XYM_CANCEL_REMOTE;
                 }
             }
+            else if (p->lib.cancel_req != 0)
+            {
+                return xymodem_cancel_exec(p);
+            }
+            xymodem_active_cancel(p);
+            return XYM_ERROR_INVALID_DATA;
         case NAK:
         case ACK:
         default:
@@ -606,80 +1382,309 @@ xym_sta_t ymodem_transmit(xym_session_t *p, uint8_t *buff, const uint16_t size)
     }
     if (retry > p->param.error_max_retry)
     {
+        if (p->lib.cancel_req != 0)
+        {
+            return xymodem_cancel_exec(p);
+        }
         xymodem_active_cancel(p);
         return XYM_ERROR_RETRANS;
     }
+    return XYM_OK;
+}
+
+/**
+ * @brief  X/Y modem compare the received verify value
+ * @param  p         : session control struct
+ * @param  tail      : received verify value [CheckSum / CRC16_H, Reserve / CRC16_L]
+ * @param  check_sum : local verify result
+ * @retval 1: match, 0: mismatch
+ */
+static uint8_t xymodem_tail_match(const xym_session_t *p, const uint8_t *tail, const uint16_t check_sum)
+{
+    if (p->lib.crc_flag != 0)
+    {
+        return (((tail[0] << 8) | tail[1]) == check_sum) ? 1 : 0;
+    }
+    return (tail[0] == (check_sum & 0xFF)) ? 1 : 0; /* the checksum is the low 8 bits */
+}
+
+/**
+ * @brief  X/Y modem detect the peer profile by the file info packet
+ * @param  p    : session control struct
+ * @param  data : file info packet "name\0size [mtime mode serial files_left bytes_left]"
+ * @param  size : size of packet
+ * @retval \
+ * @note   The number of fields behind the name is the fingerprint of the sender:
+ *         lrzsz writes 6, Tera Term / Flexible-XYmodem tools write 3(size mtime mode), Flexible-XYmodem firmware(the example)
+ *         writes the size only. Other terminals are not told apart(SecureCRT / ExtraPuTTY may also write the size only).
+ *         The result is a best effort: the quirks of QUIRK_EXPLICIT_ONLY are not taken, select the profile explicitly for them.
+ */
+static void xymodem_profile_detect(xym_session_t *p, const uint8_t *data, const uint16_t size)
+{
+    uint16_t i = 0;
+    uint8_t fields = 0;
+    uint8_t in_field = 0;
+
+    for (i = 0; i < size && data[i] != 0; ++i)
+    {
+    }
+    for (++i; i < size && data[i] != 0; ++i)
+    {
+        if (data[i] == ' ')
+        {
+            in_field = 0;
+        }
+        else if (in_field == 0)
+        {
+            in_field = 1;
+            ++fields;
+        }
+    }
+    if (fields >= 6)
+    {
+        p->lib.peer = XYM_PROFILE_LRZSZ;
+    }
+    else if (fields >= 3)
+    {
+        p->lib.peer = XYM_PROFILE_TERATERM;
+    }
+    else if (fields == 1)
+    {
+        p->lib.peer = XYM_PROFILE_FLEXIBLE;
+    }
+    else
+    {
+        p->lib.peer = XYM_PROFILE_STANDARD;
+    }
+    p->lib.quirk = xym_profile_quirk[p->lib.peer] & (uint8_t)~QUIRK_EXPLICIT_ONLY;
+}
+
+/**
+ * @brief  X/Y modem receive the rest of a packet(packet sequence, valid data and verify value)
+ * @param  p       : session control struct
+ * @param  size    : size of valid data (/ Bytes)
+ * @param  scatter : 0-valid data into the frame buffer; 1-valid data into the destination segments
+ * @param  verify  : 0-deferred(match is always 1); 1-check the verify value
+ * @param  match   : returned verify value match
+ * @retval enum xym_sta
+ */
+static xym_sta_t xymodem_recv_packet(xym_session_t *p, const uint16_t size, const uint8_t scatter, const uint8_t verify, uint8_t *match)
+{
+    uint8_t *header = xymodem_frame_head(p);      /* header[Special byte, Packet sequence, ~Packet sequence] */
+    uint8_t *tail = &header[XYM_FRAME_HEAD_SIZE + size];
+    uint8_t tail_size = (p->lib.crc_flag != 0) ? 2 : 1;
+    uint16_t check_sum = 0;
+    xym_sta_t res = XYM_OK;
+
+    *match = 1;
+    /* at once */
+    if (scatter == 0)
+    {
+        res = xymodem_recv(p, &header[1], 2 + size + tail_size, p->param.recv_timeout);
+        if (res == XYM_OK && verify != 0)
+        {
+            *match = xymodem_frame_check(p, &header[XYM_FRAME_HEAD_SIZE], size, tail);
+        }
+        return res;
+    }
+    /* packet sequence first: only the expected packet goes into the segments */
+    if (XYM_OK != (res = xymodem_recv(p, &header[1], 2, p->param.recv_timeout)))
+    {
+        return res;
+    }
+    if (header[1] != (~header[2] & 0xFF) || header[1] != (p->lib.seqno & 0xFF))
+    {
+        /* corrupt header, duplicate(lost ACK) or out of sequence: into the frame buffer, the caller rejects it */
+        res = xymodem_recv(p, &header[XYM_FRAME_HEAD_SIZE], size + tail_size, p->param.recv_timeout);
+        if (res == XYM_OK && verify != 0)
+        {
+            *match = xymodem_frame_check(p, &header[XYM_FRAME_HEAD_SIZE], size, tail);
+        }
+        return res;
+    }
+    /* valid data into the segments(verified on the way), verify value */
+    if (XYM_OK != (res = xymodem_recv_scatter(p, size, &check_sum)) ||
+        XYM_OK != (res = xymodem_recv(p, tail, tail_size, p->param.recv_timeout)))
+    {
+        return res;
+    }
+    *match = xymodem_tail_match(p, tail, check_sum);
+    return XYM_OK;
+}
+
+/**
+ * @brief  X/Y modem receive valid data into the destination segments
+ * @param  p         : session control struct
+ * @param  size      : size of valid data (/ Bytes), placed from file offset [lib.offset]
+ * @param  check_sum : returned build-in verify result
+ * @retval enum xym_sta
+ * @note   The parts out of all segments, or past the file size(the padding), stay in the frame buffer at their packet position.
+ *         Only the packet of the expected sequence comes here: a corrupt one only writes where it belongs, not yet
+ *         acknowledged, and is written again by its retransmission.
+ */
+static xym_sta_t xymodem_recv_scatter(xym_session_t *p, const uint16_t size, uint16_t *check_sum)
+{
+    uint8_t *data = xymodem_frame_data(p);
+    const struct xym_seg *seg = NULL;
+    uint8_t *dst = NULL;
+    uint32_t offset = 0;
+    uint32_t cnt = 0;
+    uint32_t gap = 0;
+    uint16_t pos = 0;
+    uint16_t i = 0;
+    xym_sta_t res = XYM_OK;
+
+    *check_sum = 0;
+    for (pos = 0; pos < size; pos += (uint16_t)cnt)
+    {
+        offset = p->lib.offset + pos;
+        dst = &data[pos];
+        cnt = size - pos;
+        if (p->lib.file_size != XYM_FILE_SIZE_UNKNOWN && offset < p->lib.file_size && p->lib.file_size - offset < cnt)
+        {
+            cnt = p->lib.file_size - offset; /* stop at the end of the file */
+        }
+        for (i = 0; (p->lib.file_size == XYM_FILE_SIZE_UNKNOWN || offset < p->lib.file_size) && i < p->lib.seg_num; ++i)
+        {
+            seg = &p->lib.seg[i];
+            if (offset >= seg->offset && offset - seg->offset < seg->size)
+            {
+                dst = &seg->addr[offset - seg->offset];
+                cnt = (seg->size - (offset - seg->offset) < cnt) ? seg->size - (offset - seg->offset) : cnt;
+                break;
+            }
+            gap = seg->offset - offset;
+            cnt = (seg->offset > offset && gap < cnt) ? gap : cnt; /* stop at the next segment */
+        }
+        if (XYM_OK != (res = xymodem_recv(p, dst, cnt, p->param.recv_timeout)))
+        {
+            return res;
+        }
+        *check_sum = xymodem_verify_update(p, *check_sum, dst, cnt);
+    }
+    return XYM_OK;
+}
+
+/**
+ * @brief  X/Y modem send a data packet and wait for its ACK
+ * @param  p    : session control struct
+ * @param  src  : valid data, the frame buffer or any memory (never written)
+ * @param  size : size of valid data (/ Bytes), 0 ~ 1024
+ * @param  pad  : padding byte up to the packet size
+ * @param  wait : 0-send once, no reply expected; 1-wait for the ACK
+ * @retval XYM_OK : ACK received(or sent when no wait), other : session over (normal or error)
+ * @note   Data in the frame buffer is sent with the header and tail at once;
+ *         other data is sent in place between them, the padding is generated in the frame buffer.
+ */
+static xym_sta_t xymodem_transmit_packet(xym_session_t *p, const uint8_t *src, const uint16_t size, const uint8_t pad, const uint8_t wait)
+{
+    uint8_t *header = xymodem_frame_head(p);      /* header[Special byte, Packet sequence, ~Packet sequence] */
+    uint8_t *data = &header[XYM_FRAME_HEAD_SIZE]; /* valid data (aligned) */
+    uint8_t *tail = NULL;                         /* tail[CheckSum / CRC16_H, Reserve / CRC16_L] */
+    uint8_t retry = 0;                            /* retry counter */
+    uint16_t pkt_data_size = 0;                   /* the data length of packet */
+    uint16_t check_sum = 0;                       /* check sum or CRC16 result */
+    uint8_t tail_size = (p->lib.crc_flag != 0) ? 2 : 1;
 
     /* packet init */
     pkt_data_size = (size > XYM_PKT_SIZE_128) ? XYM_PKT_SIZE_1024 : XYM_PKT_SIZE_128;
     header[0] = (pkt_data_size == XYM_PKT_SIZE_128) ? SOH : STX;
     header[1] = p->lib.seqno & 0xFF;
     header[2] = ~header[1];
-    /* End-of-file indicated by ^Z or 0x00 */
+    /* the user CRC can not continue over the padding, then the data is assembled in the frame buffer */
+    if (src != data && size != pkt_data_size && p->lib.crc_flag != 0 && p->ops.crc16 != NULL)
+    {
+        memcpy(data, src, size);
+        src = data;
+    }
+    /* padding, behind the valid data in the frame buffer */
     if (size != pkt_data_size)
     {
-        memset(&buff[size], (size > 0) ? CTRLZ : 0x00, pkt_data_size - size);
+        memset(&data[size], pad, pkt_data_size - size);
     }
-    /* select CRC16[MSB] or CheckSum[zero clearing] */
-    check_sum = xymodem_verify_data(p, buff, pkt_data_size);
-    tail[0] = (check_sum >> 8) & 0xFF;
+    /* select CRC16[MSB] or CheckSum[zero clearing], continued over the padding of data in place */
+    if (src == data || size == pkt_data_size)
+    {
+        check_sum = xymodem_verify_data(p, src, pkt_data_size);
+    }
+    else
+    {
+        check_sum = xymodem_verify_update(p, xymodem_verify_update(p, 0, src, size), &data[size], pkt_data_size - size);
+    }
+    tail = &data[pkt_data_size];
+    tail[0] = (p->lib.crc_flag != 0) ? ((check_sum >> 8) & 0xFF) : (check_sum & 0xFF); /* the checksum is the low 8 bits */
     tail[1] = check_sum & 0xFF;
+    p->frame.size = (src == data) ? (XYM_FRAME_HEAD_SIZE + pkt_data_size + tail_size) : 0;
 
     for (retry = 0; retry <= p->param.error_max_retry; ++retry)
     {
-        /* send header */
-        if (XYM_OK != p->ops.send(header, sizeof(header) / sizeof(header[0]), p->param.send_timeout))
+        /* asynchronous cancel request */
+        if (p->lib.cancel_req != 0)
         {
-            continue;
+            return xymodem_cancel_exec(p);
         }
-        /* send valid data */
-        if (XYM_OK != p->ops.send(buff, pkt_data_size, p->param.send_timeout))
+        /* send header, valid data and checksum at once, or header / valid data in place / padding and checksum */
+        if (src == data)
         {
-            continue;
+            if (XYM_OK != xymodem_send(p, header, XYM_FRAME_HEAD_SIZE + pkt_data_size + tail_size, p->param.send_timeout))
+            {
+                continue;
+            }
         }
-        /* send checksum */
-        if (XYM_OK != p->ops.send(tail, (p->lib.crc_flag != 0) ? 2 : 1, p->param.send_timeout))
+        else if (XYM_OK != xymodem_send(p, header, XYM_FRAME_HEAD_SIZE, p->param.send_timeout) ||
+                 XYM_OK != xymodem_send(p, src, size, p->param.send_timeout) ||
+                 XYM_OK != xymodem_send(p, &data[size], pkt_data_size - size + tail_size, p->param.send_timeout))
         {
             continue;
         }
+        if (wait == 0)
+        {
+            return XYM_OK;
+        }
         /* wait reply */
-        if (XYM_OK != p->ops.recv(&p->lib.reply_msg, 1, p->param.recv_timeout))
+        if (XYM_OK != xymodem_recv(p, &p->lib.reply_msg, 1, p->param.recv_timeout))
         {
+            XYM_LOG(("xym tx: seq %u no reply, retry %u\r\n", header[1], retry));
             continue;
         }
         /* parsing reply msg */
         switch (p->lib.reply_msg)
         {
         case ACK:
-            if (f_pkt_flag > 0 && p->lib.seqno == 0)
-            {
-                p->lib.handshake = 0;
-            }
-            p->lib.seqno++;
-            return (size > 0) ? XYM_OK : XYM_END;
+            p->lib.pkt_1k |= (pkt_data_size == XYM_PKT_SIZE_1024) ? 1 : 0;
+            return XYM_OK;
         case NAK:
         case CRC16_FLAG:
+            XYM_LOG(("xym tx: seq %u NAK, retry %u\r\n", header[1], retry));
             break;
         case CANCEL:
-            if (XYM_OK == p->ops.recv(&p->lib.reply_msg, 1, p->param.recv_timeout))
+            if (XYM_OK == xymodem_recv(p, &p->lib.reply_msg, 1, p->param.recv_timeout))
             {
                 if (p->lib.reply_msg == CANCEL)
                 {
                     return XYM_CANCEL_REMOTE;
                 }
             }
+            else if (p->lib.cancel_req != 0)
+            {
+                return xymodem_cancel_exec(p);
+            }
+            /* fall through */
         default:
+            XYM_LOG(("xym tx: invalid reply 0x%02x\r\n", p->lib.reply_msg));
             xymodem_active_cancel(p);
             return XYM_ERROR_INVALID_DATA;
         }
     }
+    if (p->lib.cancel_req != 0)
+    {
+        return xymodem_cancel_exec(p);
+    }
+    XYM_LOG(("xym: too many retries, seq %u\r\n", p->lib.seqno & 0xFF));
     xymodem_active_cancel(p);
     return XYM_ERROR_RETRANS;
 }
 
-/*******************************************************************************************************************************************
- * Private Function
- *******************************************************************************************************************************************/
 /**
  * @brief  X/Y modem verify data
  * @param  p        : session control struct
@@ -689,7 +1694,23 @@ xym_sta_t ymodem_transmit(xym_session_t *p, uint8_t *buff, const uint16_t size)
  */
 static uint16_t xymodem_verify_data(const xym_session_t *p, const uint8_t *data, const uint32_t cnt)
 {
-    uint16_t result = 0;
+    if (p->lib.crc_flag != 0 && p->ops.crc16)
+    {
+        return p->ops.crc16(data, cnt);
+    }
+    return xymodem_verify_update(p, 0, data, cnt);
+}
+
+/**
+ * @brief  X/Y modem continue the build-in verify over more data
+ * @param  p        : session control struct
+ * @param  result   : verify result of the previous data (0 at the beginning)
+ * @param  data     : data
+ * @param  cnt      : data size / Bytes
+ * @retval uint16_t : verify result
+ */
+static uint16_t xymodem_verify_update(const xym_session_t *p, uint16_t result, const uint8_t *data, const uint32_t cnt)
+{
     uint32_t i = 0;
     uint8_t j = 0;
 
@@ -703,11 +1724,6 @@ static uint16_t xymodem_verify_data(const xym_session_t *p, const uint8_t *data,
         return result;
     }
 
-    if (p->ops.crc16)
-    {
-        return p->ops.crc16(data, cnt);
-    }
-
     /* bulid-in CRC SoftWare:
      * WIDTH  : 16 bit
      * POLY   : 1021 (x16 + x12 + x5 + 1)
@@ -733,3 +1749,53 @@ static uint16_t xymodem_verify_data(const xym_session_t *p, const uint8_t *data,
     }
     return result;
 }
+
+#if XYM_RX_BUFF_SIZE > 0
+/**
+ * @brief  X/Y modem receive data through the read-ahead buffer
+ * @param  p     : session control struct
+ * @param  data  : data
+ * @param  cnt   : data size / Bytes
+ * @param  tick  : receive 1 Bytes timeout / tick
+ * @retval enum xym_sta
+ * @note   Each [ops.read] takes everything that has arrived (eg: tail + next special byte),
+ *         so the header / data / tail requests of a frame usually cost one port call.
+ */
+static xym_sta_t xymodem_rx_fetch(xym_session_t *p, uint8_t *data, uint32_t cnt, const uint32_t tick)
+{
+    struct xym_rxbuf *rx = &p->rx;
+    xym_sta_t res = XYM_OK;
+    uint32_t n = 0;
+
+    while (cnt > 0)
+    {
+        if (rx->rd == rx->wr)
+        {
+            rx->rd = rx->wr = 0;
+            /* larger than the buffer, read straight into the destination */
+            if (cnt > XYM_RX_BUFF_SIZE)
+            {
+                if (XYM_OK != (res = p->ops.read(data, cnt, &n, tick)))
+                {
+                    return res;
+                }
+                data += n;
+                cnt -= n;
+                continue;
+            }
+            if (XYM_OK != (res = p->ops.read(rx->buff, XYM_RX_BUFF_SIZE, &n, tick)))
+            {
+                return res;
+            }
+            rx->wr = (uint16_t)n;
+        }
+        n = (uint32_t)(rx->wr - rx->rd);
+        n = (n < cnt) ? n : cnt;
+        memcpy(data, &rx->buff[rx->rd], n);
+        rx->rd += (uint16_t)n;
+        data += n;
+        cnt -= n;
+    }
+    return XYM_OK;
+}
+#endif
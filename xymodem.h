@@ -8,6 +8,21 @@
  * 2023-12-10   lzh          fix possible dead loops in EOT response of [ymodem_transmit]
  * 2023-12-14   lzh          sync-change [retry_max] uint32_t => uint8_t, update enum xym_sta: add [XYM_ERROR_INVALID_DATA], del [XYM_ERROR_UNKNOWN]
  * 2023-12-24   lzh          update [struct xym_session] to prepare users for future expansion
+ * 2026-10-18   lzh          add session-owned aligned frame buffer [struct xym_frame]
+ * 2026-10-18   lzh          add static session pool [struct xym_pool]
+ * 2026-10-18   lzh          add asynchronous cancel request [xymodem_cancel_request] and [ops.abort]
+ * 2026-10-18   lzh          add [param.cancel_cnt], [param.teardown_timeout] and [ops.post] for bounded-time teardown
+ * 2026-10-18   lzh          add read-ahead buffer [struct xym_rxbuf] over [ops.read]
+ * 2026-10-18   lzh          add deferred verification [xymodem_verify_defer] / [xymodem_receive_reject]
+ * 2026-10-18   lzh          const transmit input, add [xmodem_transmit_span] / [ymodem_transmit_span]
+ * 2026-10-18   lzh          add scatter-list receive [struct xym_seg] / [xymodem_scatter_set]
+ * 2026-10-18   lzh          add peer profiles [enum xym_profile] / [xymodem_profile_set]
+ * 2026-10-18   lzh          add parameter cache [struct xym_pcache] and fast start [xymodem_fast_start]
+ * 2026-10-18   lzh          add learned settings of a device class [struct xym_tune], loaded by [param.tune]
+ * 2026-10-18   lzh          add raw link access [xymodem_link_send] / [xymodem_link_recv] for protocol extensions
+ * 2026-10-18   lzh          extern "C" for C++ (xymodem.hpp)
+ * 2026-10-18   agent        add [ymodem_transmit_eof] to end a file, also an empty one
+ * 2026-10-18   agent        export the file info parser [ymodem_info_size]
  * @copyright (c) 2023 lzh <lzhoran@163.com>
  *                https://github.com/ZeHHHHH/Flexible-XYmodem.git
  * All rights reserved.
@@ -30,9 +45,48 @@
 
 #include <stdint.h>
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 #define XYM_PKT_SIZE_128      (128)  /**< packet valid data size : 128 Bytes */
 #define XYM_PKT_SIZE_1024     (1024) /**< packet valid data size : 1024 Bytes */
 
+#define XYM_FRAME_HEAD_SIZE   (3)    /**< frame header size : [Special byte, Packet sequence, ~Packet sequence] */
+#define XYM_FRAME_TAIL_SIZE   (2)    /**< frame tail size : [CheckSum / CRC16_H, Reserve / CRC16_L] */
+#define XYM_FRAME_SIZE        (XYM_FRAME_HEAD_SIZE + XYM_PKT_SIZE_1024 + XYM_FRAME_TAIL_SIZE) /**< max frame size / Bytes */
+
+#define XYM_FILE_SIZE_UNKNOWN (0xFFFFFFFFUL) /**< no size in the Ymodem file info, see [ymodem_info_size] */
+
+/** Alignment of the frame valid data (power of 2), eg: 4 for word-CRC, 32 for DMA burst or SIMD */
+#ifndef XYM_FRAME_ALIGN
+#define XYM_FRAME_ALIGN       (4)
+#endif
+
+/** Default number of CAN in the cancel sequence, when [param.cancel_cnt] is 0 */
+#ifndef XYM_CANCEL_CNT_DEFAULT
+#define XYM_CANCEL_CNT_DEFAULT (3)
+#endif
+#define XYM_CANCEL_CNT_MAX     (16)   /**< max number of CAN in the cancel sequence */
+
+/** Read-ahead buffer size / Bytes, 0: disable, it takes effect when [ops.read] is provided (recommend >= 2 * XYM_FRAME_SIZE, max 65535) */
+#ifndef XYM_RX_BUFF_SIZE
+#define XYM_RX_BUFF_SIZE      (0)
+#endif
+
+/** Session pool statistics : 0-disable; 1-enable */
+#ifndef XYM_POOL_STATS
+#define XYM_POOL_STATS        (0)
+#endif
+
+/** Session pool critical section, necessary when acquire / release in multiple contexts (eg: disable IRQ, lock mutex) */
+#ifndef XYM_POOL_LOCK
+#define XYM_POOL_LOCK()
+#endif
+#ifndef XYM_POOL_UNLOCK
+#define XYM_POOL_UNLOCK()
+#endif
+
 /** enum X/Y modem session state */
 typedef enum xym_sta
 {
@@ -48,14 +102,52 @@ typedef enum xym_sta
     XYM_ERROR_HW,           /**< hardware error */
 } xym_sta_t;
 
-/** X/Y modem param */
-typedef struct xym_param
+/** X/Y modem peer profile, encodes the quirks of a known peer to skip the round trips it does not need */
+typedef enum xym_profile
+{
+    XYM_PROFILE_STANDARD = 0, /**< full exchange: NAK-then-ACK double EOT, ACK of the null header */
+    XYM_PROFILE_LRZSZ,        /**< lrzsz(sz / rz) */
+    XYM_PROFILE_SECURECRT,    /**< SecureCRT / XShell / sscom style terminals */
+    XYM_PROFILE_TERATERM,     /**< Tera Term */
+    XYM_PROFILE_EXTRAPUTTY,   /**< ExtraPuTTY */
+    XYM_PROFILE_FLEXIBLE,     /**< Flexible-XYmodem firmware / tools */
+    XYM_PROFILE_AUTO          /**< standard until detected by the first Ymodem file info packet (receive) */
+} xym_profile_t;
+
+/* Quirks of the peer profiles */
+#define XYM_QUIRK_EOT_ACK_FIRST  (0x01) /**< (Receiver) ACK the first EOT, the sender does not need the NAK round trip */
+#define XYM_QUIRK_END_ON_SILENCE (0x02) /**< (Receiver) no file info after a file ends the batch normally(peer sends no null header) */
+#define XYM_QUIRK_LAST_NO_ACK    (0x04) /**< (Sender) do not wait for the ACK of the end-of-batch null header */
+
+/** X/Y modem learned link settings of a device class (eg: by tools/xym_tune), 0: keep the value of [struct xym_param] */
+typedef struct xym_tune
 {
     uint32_t send_timeout;   /**< How many ticks wait for send 1 Byte */
     uint32_t recv_timeout;   /**< How many ticks wait for receive 1 Byte */
     uint8_t error_max_retry; /**< How many times to retry when an error occurs */
+    uint16_t pkt_size;       /**< Sender packet size : 128 / 1024, applied by the caller */
+    uint32_t baud;           /**< Baudrate of the link, applied by the port */
+} xym_tune_t;
+
+/** X/Y modem param */
+typedef struct xym_param
+{
+    uint32_t send_timeout;     /**< How many ticks wait for send 1 Byte */
+    uint32_t recv_timeout;     /**< How many ticks wait for receive 1 Byte */
+    uint8_t error_max_retry;   /**< How many times to retry when an error occurs */
+    uint8_t cancel_cnt;        /**< How many CAN in the cancel sequence, 0: XYM_CANCEL_CNT_DEFAULT (eg: 8 for lrzsz), max XYM_CANCEL_CNT_MAX */
+    uint32_t teardown_timeout; /**< How many ticks the whole teardown (CAN sequence / last ACK) may take, 0: send_timeout */
+    const struct xym_tune *tune; /**< Learned settings of the device class, they take precedence at session init, NULL: none */
 } xym_param_t;
 
+/** X/Y modem receive destination segment(a region of the file placed in memory) */
+typedef struct xym_seg
+{
+    uint8_t *addr;   /**< destination, eg: flash page staging buffer */
+    uint32_t offset; /**< file offset of [addr] / Bytes */
+    uint32_t size;   /**< size of the segment / Bytes */
+} xym_seg_t;
+
 /** X/Y modem lib private */
 typedef struct xym_lib
 {
@@ -63,8 +155,29 @@ typedef struct xym_lib
     uint8_t crc_flag;  /**< Parity : 0-checksum; 1-CRC16 */
     uint8_t reply_msg; /**< Reply message for the current package */
     uint32_t seqno;    /**< Packet sequence(xmodem start is 1, ymodem start is 0) */
+    volatile uint8_t cancel_req; /**< Asynchronous cancel request : 0-None; 1-Requested (single byte store, atomic on all targets) */
+    uint8_t defer_verify;        /**< Data packet verification : 0-in receive; 1-deferred to the caller */
+    uint8_t profile;             /**< Peer profile selected, enum xym_profile */
+    uint8_t peer;                /**< Peer profile in use(detected in XYM_PROFILE_AUTO) */
+    uint8_t quirk;               /**< Quirks of the peer in use, XYM_QUIRK_xxx */
+    const struct xym_seg *seg;   /**< Receive destination segments, see [xymodem_scatter_set] */
+    uint16_t seg_num;            /**< Number of destination segments, 0: scatter-list receive disabled */
+    uint32_t offset;             /**< File offset of the next data packet(scatter-list receive) / Bytes */
+    uint32_t file_size;          /**< File size of the Ymodem file info(scatter-list receive bound) / Bytes, XYM_FILE_SIZE_UNKNOWN: unknown */
+    uint8_t fast;                /**< Fast start of the receiver : 0-No; 1-cached handshake, unconfirmed until the sender answers */
+    uint8_t pkt_1k;              /**< 1024-byte packet accepted by the peer : 0-No; 1-Yes */
 } xym_lib_t;
 
+/** X/Y modem frame buffer (header + valid data + tail, contiguous)
+ *  The header is placed in front of an [XYM_FRAME_ALIGN] boundary, so the valid data is always aligned,
+ *  independent of the alignment of the session memory itself.
+ */
+typedef struct xym_frame
+{
+    uint8_t raw[XYM_FRAME_SIZE + XYM_FRAME_ALIGN - 1]; /**< raw memory, access via [xymodem_frame_data] */
+    uint16_t size;                                     /**< size of the last frame assembled or received / Bytes */
+} xym_frame_t;
+
 /** X/Y modem operations */
 typedef struct xym_ops
 {
@@ -97,16 +210,120 @@ typedef struct xym_ops
      * @retval verify result
      */
     uint16_t (*crc16)(const uint8_t *data, const uint32_t cnt);
+
+    /**
+     * @brief  wake up the blocked send / recv, which should return (not XYM_OK) as soon as possible
+     * @note   it is optional, called by [xymodem_cancel_request] from ISR or other threads
+     * @remark Without it, the cancel request takes effect when the current send / recv returns
+     * @retval \
+     */
+    void (*abort)(void);
+
+    /**
+     * @brief  hand data to the transport, best-effort
+     * @note   it is optional, used by the teardown (CAN sequence / last ACK) instead of [send].
+     *         It may block up to [tick], and returns without a report of when the data leaves the link
+     * @remark Without it, the teardown is one [send] bounded by [param.teardown_timeout]
+     * @param  data  : data (copy it, invalid after return)
+     * @param  cnt   : data size / Bytes
+     * @param  tick  : deadline of the whole data / tick, drop the remainder when expired
+     * @retval enum xym_sta : XYM_OK handed to the transport
+     */
+    xym_sta_t (*post)(const uint8_t *data, const uint32_t cnt, const uint32_t tick);
+
+    /**
+     * @brief  receive up to [cnt] data, return as soon as at least 1 Byte is received
+     * @note   it is optional, used by the read-ahead buffer(XYM_RX_BUFF_SIZE > 0) instead of [recv]
+     * @param  data  : data
+     * @param  cnt   : max data size / Bytes
+     * @param  got   : received data size / Bytes (>= 1 when XYM_OK)
+     * @param  tick  : receive the first Bytes timeout / tick
+     * @retval enum xym_sta
+     */
+    xym_sta_t (*read)(uint8_t *data, const uint32_t cnt, uint32_t *got, const uint32_t tick);
 } xym_ops_t;
 
+#if XYM_RX_BUFF_SIZE > 0
+/** X/Y modem read-ahead buffer */
+typedef struct xym_rxbuf
+{
+    uint8_t buff[XYM_RX_BUFF_SIZE]; /**< received but not yet consumed data */
+    uint16_t rd;                    /**< read offset */
+    uint16_t wr;                    /**< write offset */
+} xym_rxbuf_t;
+#endif
+
 /** X/Y modem session control struct(Private / Anonymous) */
 typedef struct xym_session
 {
     struct xym_param param;
     struct xym_lib lib;
     struct xym_ops ops;
+    struct xym_frame frame;
+#if XYM_RX_BUFF_SIZE > 0
+    struct xym_rxbuf rx;
+#endif
 } xym_session_t; /* Note: The structure does not allow users to access directly from outside. */
 
+/** X/Y modem session pool statistics */
+typedef struct xym_pool_stats
+{
+    uint32_t acquire; /**< successful acquire times */
+    uint32_t release; /**< successful release times */
+    uint32_t fail;    /**< acquire failed times (pool exhausted) */
+    uint16_t used;    /**< sessions currently in use */
+    uint16_t peak;    /**< max sessions in use at the same time */
+} xym_pool_stats_t;
+
+/** X/Y modem session pool (fixed array of sessions, each one with its own frame buffer) */
+typedef struct xym_pool
+{
+    xym_session_t *session; /**< session array */
+    uint16_t *free_list;    /**< free session index stack */
+    uint16_t num;           /**< number of sessions */
+    uint16_t free_cnt;      /**< number of free sessions */
+#if XYM_POOL_STATS
+    struct xym_pool_stats stats;
+#endif
+} xym_pool_t;
+
+/** X/Y modem negotiated parameters of a device (parameter cache entry) */
+typedef struct xym_pcache_entry
+{
+    uint32_t id;      /**< device identity, eg: hash of the serial number / MAC */
+    uint8_t valid;    /**< entry in use : 0-No; 1-Yes */
+    uint8_t crc_flag; /**< Parity : 0-checksum; 1-CRC16 */
+    uint8_t pkt_1k;   /**< 1024-byte packet accepted : 0-No; 1-Yes */
+    uint8_t profile;  /**< Peer profile in use, enum xym_profile */
+} xym_pcache_entry_t;
+
+/** X/Y modem parameter cache (fixed array of entries, keyed by device identity) */
+typedef struct xym_pcache
+{
+    xym_pcache_entry_t *entry; /**< entry array */
+    uint16_t num;              /**< number of entries */
+    uint16_t next;             /**< next entry replaced when all are in use (round-robin) */
+} xym_pcache_t;
+
+/**
+ * @brief  Define a session pool with static storage (file scope)
+ * @param  name : pool name, eg: XYM_POOL_DEFINE(gw_pool, 8) => xym_pool_t gw_pool
+ * @param  num  : number of sessions
+ */
+#define XYM_POOL_DEFINE(name, num)                   \
+    static xym_session_t name##_session[num];        \
+    static uint16_t name##_free_list[num];           \
+    xym_pool_t name = {name##_session, name##_free_list, (num), 0}
+
+/**
+ * @brief  Define a parameter cache with static storage (file scope)
+ * @param  name : cache name, eg: XYM_PCACHE_DEFINE(dev_cache, 16) => xym_pcache_t dev_cache
+ * @param  num  : number of entries
+ */
+#define XYM_PCACHE_DEFINE(name, num)                 \
+    static xym_pcache_entry_t name##_entry[num];     \
+    xym_pcache_t name = {name##_entry, (num), 0}
+
 /**
  * @brief  X/Y modem session initialization(register callback and config parameter)
  * @param  ops   : struct xym_ops
@@ -120,9 +337,185 @@ xym_sta_t xymodem_session_init(xym_session_t *p, struct xym_ops ops, struct xym_
  * @param  p                 : session control struct
  * @retval XYM_CANCEL_ACTIVE : success over
  * @retval XYM_ERROR_HW      : hardware error
+ * @note   Bounded by [param.teardown_timeout], with [ops.post] or [ops.send]
  */
 xym_sta_t xymodem_active_cancel(xym_session_t *p);
 
+/**
+ * @brief  X/Y modem request to cancel the session asynchronously
+ * @param  p : session control struct
+ * @retval \
+ * @note   It can be called from ISR or other threads at any time, the session owner exits at the next wait point
+ *         (with [ops.abort] immediately) by sending the CAN sequence and returning XYM_CANCEL_ACTIVE.
+ */
+void xymodem_cancel_request(xym_session_t *p);
+
+/**
+ * @brief  X/Y modem check the verify value of a frame
+ * @param  p     : session control struct
+ * @param  data  : valid data
+ * @param  size  : size of valid data (/ Bytes)
+ * @param  tail  : received verify value [CheckSum / CRC16_H, Reserve / CRC16_L]
+ * @retval 1: match, 0: mismatch
+ */
+uint8_t xymodem_frame_check(const xym_session_t *p, const uint8_t *data, const uint16_t size, const uint8_t *tail);
+
+/**
+ * @brief  X/Y modem defer the verification of data packets to the caller
+ * @param  p      : session control struct
+ * @param  enable : 0-verify in receive; 1-return data packets unverified
+ * @retval \
+ * @note   The caller checks each XYM_OK packet by [xymodem_frame_check] before the next receive,
+ *         and calls [xymodem_receive_reject] on mismatch. The ACK is only sent by the next receive.
+ */
+void xymodem_verify_defer(xym_session_t *p, const uint8_t enable);
+
+/**
+ * @brief  X/Y modem reject the data packet just returned (deferred verification failed)
+ * @param  p : session control struct
+ * @retval \
+ * @note   Only valid between a receive returning XYM_OK and the next receive, the next receive NAKs it.
+ */
+void xymodem_receive_reject(xym_session_t *p);
+
+/**
+ * @brief  X/Y modem select the peer profile
+ * @param  p       : session control struct
+ * @param  profile : enum xym_profile
+ * @retval \
+ * @note   Select it before [xmodem_init] / [ymodem_init]. XYM_PROFILE_AUTO detects the sender
+ *         by the fields of its first Ymodem file info packet and applies its quirks from then on,
+ *         except XYM_QUIRK_END_ON_SILENCE, which is only taken from an explicitly selected profile.
+ */
+void xymodem_profile_set(xym_session_t *p, const xym_profile_t profile);
+
+/**
+ * @brief  X/Y modem get the peer profile in use
+ * @param  p : session control struct
+ * @retval enum xym_profile, XYM_PROFILE_AUTO: not detected yet
+ */
+xym_profile_t xymodem_profile_get(const xym_session_t *p);
+
+/**
+ * @brief  X/Y modem set the destination segments of the received valid data (scatter-list receive)
+ * @param  p   : session control struct
+ * @param  seg : segments, kept by the caller until the session is over, NULL: disable
+ * @param  num : number of segments
+ * @retval \
+ * @note   Each data packet is received straight into the segments by its file offset(the file info packet is not),
+ *         verified on the way by the build-in CRC16 / checksum([ops.crc16] is not used), and the [buff] of receive is not filled.
+ *         The parts out of all segments stay in [xymodem_frame_data] at their packet position. The file offset restarts
+ *         from 0 at [xmodem_init] / [ymodem_init] and each Ymodem file info packet. Verification is never deferred.
+ */
+void xymodem_scatter_set(xym_session_t *p, const struct xym_seg *seg, const uint16_t num);
+
+/**
+ * @brief  X/Y modem send raw data over the session link(protocol extensions, eg: remote verification)
+ * @param  p    : session control struct
+ * @param  data : data
+ * @param  cnt  : data size / Bytes
+ * @param  tick : send 1 Bytes timeout / tick
+ * @retval enum xym_sta, XYM_CANCEL_ACTIVE: cancel requested
+ * @note   Only between sessions, or by the owner of a session that is not in a receive / transmit call.
+ */
+xym_sta_t xymodem_link_send(xym_session_t *p, const uint8_t *data, const uint32_t cnt, const uint32_t tick);
+
+/**
+ * @brief  X/Y modem receive raw data over the session link(through the read-ahead buffer)
+ * @param  p    : session control struct
+ * @param  data : data
+ * @param  cnt  : data size / Bytes
+ * @param  tick : receive 1 Bytes timeout / tick
+ * @retval enum xym_sta, XYM_CANCEL_ACTIVE: cancel requested
+ * @note   Same as [xymodem_link_send].
+ */
+xym_sta_t xymodem_link_recv(xym_session_t *p, uint8_t *data, const uint32_t cnt, const uint32_t tick);
+
+/**
+ * @brief  X/Y modem parameter cache initialization(all entries free)
+ * @param  cache : parameter cache, see [XYM_PCACHE_DEFINE]
+ * @retval enum xym_sta
+ */
+xym_sta_t xymodem_pcache_init(xym_pcache_t *cache);
+
+/**
+ * @brief  X/Y modem find the cached parameters of a device
+ * @param  cache : parameter cache
+ * @param  id    : device identity
+ * @retval cache entry, NULL: not cached
+ */
+const xym_pcache_entry_t *xymodem_pcache_find(const xym_pcache_t *cache, const uint32_t id);
+
+/**
+ * @brief  X/Y modem store the parameters negotiated by a session into the cache
+ * @param  cache : parameter cache
+ * @param  id    : device identity
+ * @param  p     : session control struct, after the session is over normally
+ * @retval enum xym_sta
+ * @note   The entry of [id] is updated, otherwise a free one is taken, otherwise the oldest one is replaced.
+ */
+xym_sta_t xymodem_pcache_store(xym_pcache_t *cache, const uint32_t id, const xym_session_t *p);
+
+/**
+ * @brief  X/Y modem start the session with the cached parameters (fast start)
+ * @param  p     : session control struct
+ * @param  entry : cache entry of the peer, NULL: full negotiation
+ * @retval \
+ * @note   Call it after [xmodem_init] / [ymodem_init]. The receiver starts with the cached handshake('C' / NAK)
+ *         and drops back to full negotiation when the sender does not answer it. The sender still waits for the
+ *         probe of the receiver, it only takes the cached profile. The cached profile is applied in XYM_PROFILE_AUTO.
+ */
+void xymodem_fast_start(xym_session_t *p, const xym_pcache_entry_t *entry);
+
+/**
+ * @brief  X/Y modem session pool initialization(all sessions free)
+ * @param  pool : session pool, see [XYM_POOL_DEFINE]
+ * @retval enum xym_sta
+ */
+xym_sta_t xymodem_pool_init(xym_pool_t *pool);
+
+/**
+ * @brief  X/Y modem acquire a session from the pool and initialize it, O(1)
+ * @param  pool  : session pool
+ * @param  ops   : struct xym_ops
+ * @param  param : struct xym_param
+ * @retval session control struct, NULL: pool exhausted or invalid parameter
+ */
+xym_session_t *xymodem_pool_acquire(xym_pool_t *pool, struct xym_ops ops, struct xym_param param);
+
+/**
+ * @brief  X/Y modem release a session back to the pool, O(1)
+ * @param  pool : session pool
+ * @param  p    : session control struct, must have been acquired from [pool] and not released yet
+ * @retval enum xym_sta
+ */
+xym_sta_t xymodem_pool_release(xym_pool_t *pool, xym_session_t *p);
+
+/**
+ * @brief  X/Y modem get the session pool statistics
+ * @param  pool  : session pool
+ * @param  stats : returned statistics (all zero if [XYM_POOL_STATS] is disabled)
+ * @retval \
+ */
+void xymodem_pool_stats(xym_pool_t *pool, xym_pool_stats_t *stats);
+
+/**
+ * @brief  X/Y modem get the valid data area of the session frame buffer
+ * @param  p       : session control struct
+ * @retval uint8_t : valid data area (XYM_PKT_SIZE_1024 Bytes, aligned to XYM_FRAME_ALIGN)
+ * @note   Fill it and pass it as [buff] of transmit to skip the copy,
+ *         or pass NULL as [buff] of receive and read the valid data from here.
+ */
+uint8_t *xymodem_frame_data(xym_session_t *p);
+
+/**
+ * @brief  X/Y modem get the last frame assembled or received (contiguous)
+ * @param  p       : session control struct
+ * @param  size    : size of the frame (/ Bytes), 0 if there is no frame
+ * @retval uint8_t : frame [header + valid data + tail], eg: source of one-shot DMA or write
+ */
+const uint8_t *xymodem_frame_get(xym_session_t *p, uint16_t *size);
+
 /**
  * @brief  Xmodem session init
  * @param  p : session control struct
@@ -133,7 +526,7 @@ void xmodem_init(xym_session_t *p);
 /**
  * @brief  Xmodem receive data
  * @param  p      : session control struct
- * @param  buff   : returned data buffer (128 or 1024 Bytes)
+ * @param  buff   : returned data buffer (128 or 1024 Bytes), NULL: keep the data in [xymodem_frame_data]
  * @param  size   : size of returned data (/ Bytes)
  * @retval XYM_OK : return a packet of valid data
  * @retval other  : session over (normal or error)
@@ -145,14 +538,28 @@ xym_sta_t xmodem_receive(xym_session_t *p, uint8_t *buff, uint16_t *size);
 /**
  * @brief  Xmodem transmit data
  * @param  p      : session control struct
- * @param  buff   : data buffer (128 or 1024 Bytes)
+ * @param  buff   : data buffer (128 or 1024 Bytes), it is not modified, may be [xymodem_frame_data]
  * @param  size   : size of data (/ Bytes), If the size is 0, exec end.
  * @retval XYM_OK : transmit OK, continue to the next transmit
  * @retval other  : session over (normal or error)
  * @note   The function needs to be continuously polled until the end
  * @remark Support Xmodem-1K and Xmodem-128 (standard), depending on the sender settings
  */
-xym_sta_t xmodem_transmit(xym_session_t *p, uint8_t *buff, const uint16_t size);
+xym_sta_t xmodem_transmit(xym_session_t *p, const uint8_t *buff, const uint16_t size);
+
+/**
+ * @brief  Xmodem transmit a span of data in place (zero-copy, eg: from read-only / XIP flash)
+ * @param  p    : session control struct
+ * @param  src  : data, it is never written
+ * @param  len  : size of data (/ Bytes), any length, only the last packet is padded
+ * @param  done : returned size of acknowledged data (/ Bytes), may be NULL
+ * @retval XYM_OK : all data transmit OK, continue to the next span or end by [xmodem_transmit] with size 0
+ * @retval other  : session over (normal or error)
+ * @note   Each packet is sent as header / data in place / padding and tail, the padding is generated in the frame buffer.
+ *         Split an image into spans on XYM_PKT_SIZE_1024 boundaries, since the tail of each span is padded.
+ *         With [ops.crc16] and CRC16, the padded last packet is assembled in the frame buffer (the user CRC can not be continued).
+ */
+xym_sta_t xmodem_transmit_span(xym_session_t *p, const uint8_t *src, const uint32_t len, uint32_t *done);
 
 /**
  * @brief  Ymodem session init
@@ -164,7 +571,7 @@ void ymodem_init(xym_session_t *p);
 /**
  * @brief  Ymodem receive data
  * @param  p      : session control struct
- * @param  buff   : returned data buffer (128 or 1024 Bytes)
+ * @param  buff   : returned data buffer (128 or 1024 Bytes), NULL: keep the data in [xymodem_frame_data]
  * @param  size   : size of returned data (/ Bytes)
  * @retval XYM_OK      : return a packet of valid data
  * @retval XYM_FIL_GET : return a packet of file info
@@ -174,10 +581,19 @@ void ymodem_init(xym_session_t *p);
  */
 xym_sta_t ymodem_receive(xym_session_t *p, uint8_t *buff, uint16_t *size);
 
+/**
+ * @brief  Ymodem file size of the file info packet: "name\0size ..."
+ * @param  data : valid data of the file info packet (XYM_FIL_GET of [ymodem_receive])
+ * @param  size : size of valid data (/ Bytes)
+ * @retval file size / Bytes, XYM_FILE_SIZE_UNKNOWN: no size, or too large
+ * @note   0 is an empty file
+ */
+uint32_t ymodem_info_size(const uint8_t *data, const uint16_t size);
+
 /**
  * @brief  Ymodem transmit data
  * @param  p      : session control struct
- * @param  buff   : data buffer (128 or 1024 Bytes)
+ * @param  buff   : data buffer (128 or 1024 Bytes), it is not modified, may be [xymodem_frame_data]
  * @param  size   : size of data (/ Bytes), If the size is 0, exec next file transmit or end.
  * @retval XYM_OK      : transmit OK, continue to the next transmit
  * @retval XYM_FIL_SET : set file info packet
@@ -185,6 +601,34 @@ xym_sta_t ymodem_receive(xym_session_t *p, uint8_t *buff, uint16_t *size);
  * @note   The function needs to be continuously polled until the end
  * @remark No support Ymodem-g, because it is easy to cause buffer-overflow
  */
-xym_sta_t ymodem_transmit(xym_session_t *p, uint8_t *buff, const uint16_t size);
+xym_sta_t ymodem_transmit(xym_session_t *p, const uint8_t *buff, const uint16_t size);
+
+/**
+ * @brief  Ymodem transmit the end of the current file (EOT)
+ * @param  p : session control struct
+ * @retval XYM_FIL_SET            : file over, next file info packet or the end of batch
+ * @retval XYM_ERROR_INVALID_DATA : no file info packet sent, nothing is sent
+ * @retval other                  : session over (error)
+ * @note   Unlike [ymodem_transmit] with size 0, it also ends an empty file(no data packet after the file info packet)
+ *         instead of taking it as the end of batch.
+ */
+xym_sta_t ymodem_transmit_eof(xym_session_t *p);
+
+/**
+ * @brief  Ymodem transmit a span of file data in place (zero-copy, eg: from read-only / XIP flash)
+ * @param  p    : session control struct
+ * @param  src  : data, it is never written
+ * @param  len  : size of data (/ Bytes), any length, only the last packet is padded
+ * @param  done : returned size of acknowledged data (/ Bytes), may be NULL
+ * @retval XYM_OK : all data transmit OK, continue to the next span or end the file by [ymodem_transmit_eof]
+ * @retval other  : session over (normal or error)
+ * @note   Send the file info packet by [ymodem_transmit] first. Split an image into spans on XYM_PKT_SIZE_1024 boundaries.
+ *         With [ops.crc16] and CRC16, the padded last packet is assembled in the frame buffer (the user CRC can not be continued).
+ */
+xym_sta_t ymodem_transmit_span(xym_session_t *p, const uint8_t *src, const uint32_t len, uint32_t *done);
+
+#ifdef __cplusplus
+}
+#endif
 
 #endif /* __XYMODEM_H__ */
@@ -0,0 +1,360 @@
+/**
+ *******************************************************************************************************************************************
+ * @file        xymodem.hpp
+ * @brief       X / Y modem C++20 interface: received packets as a lazy range, transmit from any range of spans
+ * @since       Change Logs:
+ * Date         Author       Notes
+ * 2026-10-18   lzh          the first version
+ * @copyright (c) 2023 lzh <lzhoran@163.com>
+ *                https://github.com/ZeHHHHH/Flexible-XYmodem.git
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *******************************************************************************************************************************************
+ */
+#ifndef __XYMODEM_HPP__
+#define __XYMODEM_HPP__
+
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <ranges>
+#include <span>
+#include <string>
+#include <string_view>
+#include "xymodem.h"
+
+/*
+ * Header only, over the C functions of xymodem.h, for host tools (C++20):
+ *
+ *   auto rx = xym::receive(session);                   // after ymodem_init(&session)
+ *   for (std::span<const std::byte> pkt : rx)          // one packet per step, as it arrives
+ *   {
+ *       write(fd, pkt.data(), pkt.size());             // rx.file(): name / size / index of the current file
+ *   }
+ *   if (rx.status() != XYM_END) { ... }
+ *
+ *   xym::transmit(session, "fw.bin", size, spans);     // any input range of byte spans, then xym::transmit_end(session)
+ *
+ * Nothing is allocated or copied per packet: a received packet is a view of the session frame buffer
+ * (valid until the next step), and transmitted data is sent in place by [xmodem_transmit_span] / [ymodem_transmit_span].
+ * Errors are returned as enum xym_sta, as in C.
+ */
+
+namespace xym
+{
+
+/** Payload of a packet */
+using packet = std::span<const std::byte>;
+
+/** Size not known (Xmodem, or a Ymodem file info without size) */
+inline constexpr std::uint64_t size_unknown = std::numeric_limits<std::uint64_t>::max();
+
+/** Protocol of the session */
+enum class proto
+{
+    xmodem,
+    ymodem,
+};
+
+/** Ymodem file being received */
+struct file_info
+{
+    std::string name;                    /**< allocated once per file, not per packet */
+    std::uint64_t size = size_unknown;   /**< size of the file info, the last packet is trimmed to it */
+    std::uint32_t index = 0;             /**< 1: first file of the batch, 0: none (Xmodem) */
+};
+
+/** Element of a transmit range: a byte span, or a contiguous range of 1 Byte elements (std::string, std::vector<uint8_t> ...) */
+template <class T>
+concept byte_range = std::convertible_to<T, packet> ||
+                     (std::ranges::contiguous_range<T> && std::ranges::sized_range<T> &&
+                      sizeof(std::ranges::range_value_t<T>) == 1);
+
+/**
+ * X/Y modem received packets as a lazy input range (single pass)
+ * Each step polls [xmodem_receive] / [ymodem_receive] with [buff] NULL and yields the valid data in the frame buffer,
+ * the Ymodem file info packets are taken in by [file()] and the padding beyond the file size is trimmed.
+ * The range ends when the session is over, see [status()].
+ */
+class receive_view : public std::ranges::view_interface<receive_view>
+{
+public:
+    class iterator
+    {
+    public:
+        using value_type = packet;
+        using difference_type = std::ptrdiff_t;
+        using iterator_concept = std::input_iterator_tag;
+
+        iterator() = default;
+        explicit iterator(receive_view *v) : v_(v) {}
+
+        const packet &operator*() const { return v_->pkt_; }
+        iterator &operator++()
+        {
+            v_->next();
+            return *this;
+        }
+        void operator++(int) { v_->next(); }
+        friend bool operator==(const iterator &it, std::default_sentinel_t) { return it.v_->status() != XYM_OK; }
+
+    private:
+        receive_view *v_ = nullptr;
+    };
+
+    receive_view() = default;
+    receive_view(xym_session_t &p, const proto m, const std::uint64_t size) : p_(&p), proto_(m), left_(size)
+    {
+        file_.size = size;
+    }
+
+    /** the first packet is received here */
+    iterator begin()
+    {
+        next();
+        return iterator(this);
+    }
+    std::default_sentinel_t end() const noexcept { return {}; }
+
+    /** XYM_OK while packets come, then how the session is over (XYM_END: normal) */
+    xym_sta_t status() const noexcept { return sta_; }
+
+    /** file of the current packet */
+    const file_info &file() const noexcept { return file_; }
+
+private:
+    void next();
+    void take_info(const std::byte *data, const std::uint16_t size);
+
+    xym_session_t *p_ = nullptr;
+    proto proto_ = proto::ymodem;
+    xym_sta_t sta_ = XYM_OK;
+    packet pkt_;
+    file_info file_;
+    std::uint64_t left_ = size_unknown; /* Bytes of the file not yet yielded */
+};
+
+/* the next packet with valid data, or the end of the session */
+inline void receive_view::next()
+{
+    std::uint16_t size = 0;
+    std::uint64_t n = 0;
+
+    for (;;)
+    {
+        sta_ = (proto_ == proto::xmodem) ? xmodem_receive(p_, nullptr, &size) : ymodem_receive(p_, nullptr, &size);
+        const auto *data = reinterpret_cast<const std::byte *>(xymodem_frame_data(p_));
+        if (sta_ == XYM_FIL_GET)
+        {
+            take_info(data, size);
+            continue;
+        }
+        if (sta_ != XYM_OK)
+        {
+            pkt_ = {};
+            return;
+        }
+        n = std::min<std::uint64_t>(size, left_);
+        left_ -= (left_ != size_unknown) ? n : 0;
+        if (n > 0)
+        {
+            pkt_ = packet(data, static_cast<std::size_t>(n));
+            return;
+        }
+        /* padding only (beyond the file size): acknowledged, not yielded */
+    }
+}
+
+/* Ymodem file info packet: "name\0size mtime mode" */
+inline void receive_view::take_info(const std::byte *data, const std::uint16_t size)
+{
+    const char *info = reinterpret_cast<const char *>(data);
+    const std::size_t len = strnlen(info, size);
+    std::uint64_t n = 0;
+
+    file_.name.assign(info, len);
+    file_.size = size_unknown;
+    if (len + 1 < size && std::from_chars(info + len + 1, info + size, n).ec == std::errc())
+    {
+        file_.size = n;
+    }
+    file_.index++;
+    left_ = file_.size;
+}
+
+/**
+ * @brief  X/Y modem receive packets as a lazy range
+ * @param  p    : session control struct, after [xmodem_init] / [ymodem_init] (and [xymodem_fast_start] ...)
+ * @param  m    : protocol
+ * @param  size : Xmodem: size of the data, the padding of the last packet is trimmed; size_unknown: not trimmed
+ * @retval receive_view
+ * @note   The packet is a view of the frame buffer, valid until the next step. Not with [xymodem_scatter_set].
+ */
+inline receive_view receive(xym_session_t &p, const proto m = proto::ymodem, const std::uint64_t size = size_unknown)
+{
+    return receive_view(p, m, size);
+}
+
+namespace detail
+{
+
+template <byte_range T>
+packet to_packet(const T &s)
+{
+    if constexpr (std::convertible_to<const T &, packet>)
+    {
+        return packet(s);
+    }
+    else
+    {
+        return packet(reinterpret_cast<const std::byte *>(std::ranges::data(s)), std::ranges::size(s));
+    }
+}
+
+/*
+ * The data of all the spans as one stream: whole packets are sent in place from the span,
+ * only the Bytes of a packet across two spans (or the short end) are gathered in the frame buffer.
+ * [total] returns the Bytes taken from the spans.
+ */
+template <std::ranges::input_range R>
+xym_sta_t transmit_data(xym_session_t &p, const proto m, R &&spans, std::uint64_t &total)
+{
+    constexpr std::size_t pkt = XYM_PKT_SIZE_1024;
+    constexpr std::size_t step = std::size_t(1) << 30; /* a multiple of pkt within uint32_t */
+    std::byte *held = reinterpret_cast<std::byte *>(xymodem_frame_data(&p));
+    std::size_t cnt = 0, whole = 0, off = 0, k = 0;
+    xym_sta_t res = XYM_OK;
+
+    total = 0;
+    auto send_held = [&]() {
+        const auto n = static_cast<std::uint16_t>(cnt);
+        cnt = 0;
+        return (m == proto::xmodem) ? xmodem_transmit(&p, xymodem_frame_data(&p), n) : ymodem_transmit(&p, xymodem_frame_data(&p), n);
+    };
+    auto send_span = [&](const std::byte *data, const std::size_t n) {
+        const auto *src = reinterpret_cast<const std::uint8_t *>(data);
+        return (m == proto::xmodem) ? xmodem_transmit_span(&p, src, static_cast<std::uint32_t>(n), nullptr)
+                                    : ymodem_transmit_span(&p, src, static_cast<std::uint32_t>(n), nullptr);
+    };
+
+    for (auto &&e : spans)
+    {
+        packet s = to_packet(e);
+        total += s.size();
+        if (cnt > 0)
+        {
+            k = std::min(pkt - cnt, s.size());
+            std::memcpy(held + cnt, s.data(), k);
+            cnt += k;
+            s = s.subspan(k);
+            if (cnt < pkt)
+            {
+                continue;
+            }
+            if (XYM_OK != (res = send_held()))
+            {
+                return res;
+            }
+        }
+        whole = s.size() - s.size() % pkt;
+        for (off = 0; off < whole; off += k)
+        {
+            k = std::min(whole - off, step);
+            if (XYM_OK != (res = send_span(s.data() + off, k)))
+            {
+                return res;
+            }
+        }
+        cnt = s.size() - whole;
+        std::memcpy(held, s.data() + whole, cnt);
+    }
+    return (cnt > 0) ? send_held() : res;
+}
+
+} // namespace detail
+
+/**
+ * @brief  Xmodem transmit the data of a range of spans, then end the session
+ * @param  p     : session control struct, after [xmodem_init]
+ * @param  spans : input range of byte_range, any sizes; consumed once, lazily
+ * @retval XYM_END                : success
+ * @retval XYM_ERROR_INVALID_DATA : no data in [spans], nothing is sent
+ * @retval other                  : session over (error)
+ * @note   Packets of 1024 Bytes (the last one padded), sent in place except across the span boundaries.
+ *         Empty input is rejected: Xmodem has no file info, an EOT alone would end the session before the handshake.
+ *         The session is still open then, end it with [xymodem_active_cancel] if the receiver is waiting.
+ */
+template <std::ranges::input_range R>
+    requires byte_range<std::ranges::range_reference_t<R>>
+xym_sta_t transmit(xym_session_t &p, R &&spans)
+{
+    std::uint64_t total = 0;
+    xym_sta_t res = detail::transmit_data(p, proto::xmodem, std::forward<R>(spans), total);
+    if (res == XYM_OK && total == 0)
+    {
+        return XYM_ERROR_INVALID_DATA;
+    }
+    return (res == XYM_OK) ? xmodem_transmit(&p, xymodem_frame_data(&p), 0) : res;
+}
+
+/**
+ * @brief  Ymodem transmit a file: file info, the data of a range of spans, end of file
+ * @param  p     : session control struct, after [ymodem_init]
+ * @param  name  : file name
+ * @param  size  : file size / Bytes (the total of the spans), size_unknown: not in the file info
+ * @param  spans : input range of byte_range, any sizes; consumed once, lazily
+ * @retval XYM_FIL_SET : success, next file or [transmit_end]; other : session over
+ */
+template <std::ranges::input_range R>
+    requires byte_range<std::ranges::range_reference_t<R>>
+xym_sta_t transmit(xym_session_t &p, const std::string_view name, const std::uint64_t size, R &&spans)
+{
+    char *info = reinterpret_cast<char *>(xymodem_frame_data(&p));
+    const std::size_t len = std::min<std::size_t>(name.size(), XYM_PKT_SIZE_1024 - 24);
+    std::size_t n = len + 1;
+    std::uint64_t total = 0;
+    xym_sta_t res = XYM_OK;
+
+    std::memset(info, 0, XYM_PKT_SIZE_1024);
+    std::memcpy(info, name.data(), len);
+    if (size != size_unknown)
+    {
+        n = static_cast<std::size_t>(std::to_chars(info + n, info + XYM_PKT_SIZE_1024 - 1, size).ptr - info);
+    }
+    res = ymodem_transmit(&p, xymodem_frame_data(&p), (n < XYM_PKT_SIZE_128) ? XYM_PKT_SIZE_128 : XYM_PKT_SIZE_1024);
+    if (res == XYM_OK)
+    {
+        res = detail::transmit_data(p, proto::ymodem, std::forward<R>(spans), total);
+    }
+    return (res == XYM_OK) ? ymodem_transmit_eof(&p) : res; /* also ends an empty file */
+}
+
+/**
+ * @brief  Ymodem end of batch (null file info) after the last [transmit]
+ * @param  p : session control struct
+ * @retval XYM_END : success, other : session over (error)
+ */
+inline xym_sta_t transmit_end(xym_session_t &p)
+{
+    std::memset(xymodem_frame_data(&p), 0, XYM_PKT_SIZE_128);
+    return ymodem_transmit(&p, xymodem_frame_data(&p), 0);
+}
+
+} // namespace xym
+
+#endif /* __XYMODEM_HPP__ */
@@ -0,0 +1,116 @@
+/**
+ *******************************************************************************************************************************************
+ * @file        xymodem_duplex.c
+ * @brief       X / Y modem full-duplex mode (a transfer in each direction at once over one link)
+ * @since       Change Logs:
+ * Date         Author       Notes
+ * 2026-10-18   lzh          the first version
+ * @copyright (c) 2023 lzh <lzhoran@163.com>
+ *                https://github.com/ZeHHHHH/Flexible-XYmodem.git
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *******************************************************************************************************************************************
+ */
+#include "xymodem_duplex.h"
+
+/*******************************************************************************************************************************************
+ * Private Prototype
+ *******************************************************************************************************************************************/
+#define DUPLEX_SYN              (0x16) /* same lead byte as the requests of [xymodem_verify] */
+#define DUPLEX_VERSION          (1)    /* version of the mux framing */
+#define DUPLEX_MSG_SIZE         (4)
+
+/* offer [SYN 'D' 'X' version] / accept [SYN 'd' 'x' version] */
+static const uint8_t duplex_offer[DUPLEX_MSG_SIZE] = {DUPLEX_SYN, 'D', 'X', DUPLEX_VERSION};
+static const uint8_t duplex_accept[DUPLEX_MSG_SIZE] = {DUPLEX_SYN, 'd', 'x', DUPLEX_VERSION};
+
+/*******************************************************************************************************************************************
+ * Public Function
+ *******************************************************************************************************************************************/
+/**
+ * @brief  X/Y modem duplex offer the full-duplex mode (host)
+ * @param  phy   : physical link, [send] and [recv] are used
+ * @param  tick  : wait for the accept of each offer / tick
+ * @param  retry : offers sent again without an accept
+ * @retval XYM_OK                 : accepted, start the mux
+ * @retval XYM_ERROR_TIMEOUT      : no accept, the device does not listen for the offer
+ * @retval XYM_ERROR_INVALID_DATA : other data received(eg: 'C' of a plain receiver), the device does not support it
+ * @retval other                  : link error
+ * @note   Only offer it to a device that listens by [xymodem_duplex_accept]: a plain receiver cancels on the offer
+ */
+xym_sta_t xymodem_duplex_offer(struct xym_ops phy, const uint32_t tick, const uint8_t retry)
+{
+    xym_sta_t res = XYM_OK;
+    uint8_t i = 0, k = 0, c = 0;
+
+    if (!(phy.send && phy.recv))
+    {
+        return XYM_ERROR_INVALID_DATA;
+    }
+    for (i = 0; i <= retry; ++i)
+    {
+        if (XYM_OK != (res = phy.send(duplex_offer, DUPLEX_MSG_SIZE, tick)))
+        {
+            return res;
+        }
+        /* the accept is read Byte by Byte: the mux frames of the device may follow it at once */
+        for (k = 0; k < DUPLEX_MSG_SIZE; ++k)
+        {
+            if (XYM_OK != (res = phy.recv(&c, 1, tick)))
+            {
+                break;
+            }
+            if (c != duplex_accept[k])
+            {
+                return XYM_ERROR_INVALID_DATA;
+            }
+        }
+        if (k == DUPLEX_MSG_SIZE)
+        {
+            return XYM_OK;
+        }
+        if (res != XYM_ERROR_TIMEOUT)
+        {
+            return res;
+        }
+    }
+    return XYM_ERROR_TIMEOUT;
+}
+
+/**
+ * @brief  X/Y modem duplex wait for the offer of the full-duplex mode and accept it (device)
+ * @param  phy  : physical link, [send] and [recv] are used
+ * @param  tick : wait for each Bytes of the offer / tick
+ * @retval XYM_OK : accepted, start the mux, other : no offer(eg: XYM_ERROR_TIMEOUT), run a plain session
+ */
+xym_sta_t xymodem_duplex_accept(struct xym_ops phy, const uint32_t tick)
+{
+    xym_sta_t res = XYM_OK;
+    uint8_t k = 0, c = 0;
+
+    if (!(phy.send && phy.recv))
+    {
+        return XYM_ERROR_INVALID_DATA;
+    }
+    /* skip the line noise before the offer */
+    while (k < DUPLEX_MSG_SIZE)
+    {
+        if (XYM_OK != (res = phy.recv(&c, 1, tick)))
+        {
+            return res;
+        }
+        k = (c == duplex_offer[k]) ? k + 1 : (c == duplex_offer[0]) ? 1 : 0;
+    }
+    return phy.send(duplex_accept, DUPLEX_MSG_SIZE, tick);
+}
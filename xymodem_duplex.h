@@ -0,0 +1,68 @@
+/**
+ *******************************************************************************************************************************************
+ * @file        xymodem_duplex.h
+ * @brief       X / Y modem full-duplex mode (a transfer in each direction at once over one link)
+ * @since       Change Logs:
+ * Date         Author       Notes
+ * 2026-10-18   lzh          the first version
+ * @copyright (c) 2023 lzh <lzhoran@163.com>
+ *                https://github.com/ZeHHHHH/Flexible-XYmodem.git
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *******************************************************************************************************************************************
+ */
+#ifndef __XYMODEM_DUPLEX_H__
+#define __XYMODEM_DUPLEX_H__
+
+#include "xymodem_mux.h"
+
+/*
+ * Full-duplex mode: the host offers it, the device accepts it, then both run a mux of 2 channels on the link:
+ *   channel XYM_DUPLEX_CH_HOST   : transfer host -> device (host transmits, device receives)
+ *   channel XYM_DUPLEX_CH_DEVICE : transfer device -> host (device transmits, host receives)
+ * The data of one direction shares the link with the replies of the other one, [xymodem_mux_poll] sends them in one write.
+ *
+ *   XYM_MUX_DEFINE(duplex, 2);
+ *   XYM_MUX_CHANNEL(duplex, 0)
+ *   XYM_MUX_CHANNEL(duplex, 1)
+ *   host  : xymodem_duplex_offer(phy, 1000, 5)  -> xymodem_mux_init(&duplex, phy, ...), ymodem_transmit on XYM_MUX_OPS(duplex, 0),
+ *                                                 ymodem_receive on XYM_MUX_OPS(duplex, 1), xymodem_mux_poll in a third context
+ *   device: xymodem_duplex_accept(phy, 10000) -> the same with the channels swapped
+ */
+
+#define XYM_DUPLEX_CH_HOST    (0) /**< channel of the transfer host -> device */
+#define XYM_DUPLEX_CH_DEVICE  (1) /**< channel of the transfer device -> host */
+
+/**
+ * @brief  X/Y modem duplex offer the full-duplex mode (host)
+ * @param  phy   : physical link, [send] and [recv] are used
+ * @param  tick  : wait for the accept of each offer / tick
+ * @param  retry : offers sent again without an accept
+ * @retval XYM_OK                 : accepted, start the mux
+ * @retval XYM_ERROR_TIMEOUT      : no accept, the device does not listen for the offer
+ * @retval XYM_ERROR_INVALID_DATA : other data received(eg: 'C' of a plain receiver), the device does not support it
+ * @retval other                  : link error
+ * @note   Only offer it to a device that listens by [xymodem_duplex_accept]: a plain receiver cancels on the offer
+ */
+xym_sta_t xymodem_duplex_offer(struct xym_ops phy, const uint32_t tick, const uint8_t retry);
+
+/**
+ * @brief  X/Y modem duplex wait for the offer of the full-duplex mode and accept it (device)
+ * @param  phy  : physical link, [send] and [recv] are used
+ * @param  tick : wait for each Bytes of the offer / tick
+ * @retval XYM_OK : accepted, start the mux, other : no offer(eg: XYM_ERROR_TIMEOUT), run a plain session
+ */
+xym_sta_t xymodem_duplex_accept(struct xym_ops phy, const uint32_t tick);
+
+#endif /* __XYMODEM_DUPLEX_H__ */
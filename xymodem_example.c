@@ -7,6 +7,10 @@
  * 2023-11-30   lzh          the first version
  * 2023-12-10   lzh          add macro __XYM_LOG__()
  * 2023-12-24   lzh          update [xymodem_session_init] param
+ * 2026-10-18   lzh          register [ops.abort], [ops.read]
+ * 2026-10-18   lzh          add stack high-water probe [STACK_PROBE_SIZE]
+ * 2026-10-18   lzh          [xymodem_port_crc16] returns uint16_t, register it with the frame assembler of the port(MODE_ISR)
+ * 2026-10-18   lzh          __XYM_LOG__() is deferred by XYM_LOG_ENABLE, formatted after the session
  * @copyright (c) 2023 lzh <lzhoran@163.com>
  *                https://github.com/ZeHHHHH/Flexible-XYmodem.git
  * All rights reserved.
@@ -27,6 +31,7 @@
 #include <stdio.h>
 #include <string.h>
 #include "xymodem.h"
+#include "xymodem_log.h"
 
 /*******************************************************************************************************************************************
  * Private Define
@@ -41,12 +46,19 @@
 #define TEST_SIZE         (1 << 20) /* simple test data size: 1M Bytes */
 
 #if 1 /* Automatic allocation on the Stack */
-# define ATTRIBUTE_FAST_MEM       /* recommend [Stack Min_Size] >= 0x800 */
+# define ATTRIBUTE_FAST_MEM       /* recommend [Stack Min_Size] >= 0xC00(session + buffer + library, see tools/xym_mem.c) */
 #else /* Static allocation on RAM */
 # define ATTRIBUTE_FAST_MEM       static
 #endif
 
-#if 1 /* log printf */
+#if 0 /* stack high-water of the session: paint the free stack below the example before, scan it after */
+# define STACK_PROBE_SIZE         (0x800) /* painted depth / Bytes, must be within the free stack */
+# define STACK_PROBE_PAINT        (0xA5)
+#endif
+
+#if defined(XYM_LOG_ENABLE) /* deferred log: a few stores into RAM, formatted by [xymodem_log_flush] after the session */
+# define __XYM_LOG__(...)      XYM_LOG((__VA_ARGS__))
+#elif 1 /* log printf */
 # define __XYM_LOG__(...)      printf(__VA_ARGS__)
 #else
 # define __XYM_LOG__(...)
@@ -129,6 +141,43 @@ static void encode_file(ymodem_file_t *f, uint8_t *buff, const uint16_t size)
     common_itoa(&buff[i], sizeof(f->name) / sizeof(f->name[0]) - i, f->size);
 }
 
+#ifdef STACK_PROBE_SIZE
+static uintptr_t stack_probe_top = 0; /* painted region : [top - STACK_PROBE_SIZE, top) */
+
+/**
+ * @brief   paint the free stack below the caller (full-descending stack, eg: Cortex-M)
+ * @param   \
+ * @retval  \
+ * @note    Interrupts on the same stack are counted as well, the result is the high-water of the whole context.
+ */
+static __attribute__((noinline)) void stack_paint(void)
+{
+    volatile uint8_t mark = 0;
+    uint32_t i = 0;
+
+    stack_probe_top = (uintptr_t)&mark - 32; /* below this frame */
+    for (i = 1; i <= STACK_PROBE_SIZE; ++i)
+    {
+        *(volatile uint8_t *)(stack_probe_top - i) = STACK_PROBE_PAINT;
+    }
+}
+
+/**
+ * @brief   stack used below the caller since [stack_paint]
+ * @param   \
+ * @retval  high-water / Bytes, STACK_PROBE_SIZE: the painted depth is exhausted (probably more)
+ */
+static uint32_t stack_peak(void)
+{
+    uint32_t i = 0;
+
+    for (i = STACK_PROBE_SIZE; i > 0 && *(volatile uint8_t *)(stack_probe_top - i) == STACK_PROBE_PAINT; --i)
+    {
+    }
+    return i;
+}
+#endif
+
 /*******************************************************************************************************************************************
  * Public Function
  *******************************************************************************************************************************************/
@@ -171,7 +220,9 @@ uint8_t xymodem_example(void)
 extern xym_sta_t xymodem_port_init(void);
 extern xym_sta_t xymodem_port_send_data(const uint8_t *data, const uint32_t cnt, const uint32_t tick);
 extern xym_sta_t xymodem_port_recv_data(uint8_t *data, const uint32_t cnt, const uint32_t tick);
-extern xym_sta_t xymodem_port_crc16(const uint8_t *data, const uint32_t cnt);
+extern uint16_t xymodem_port_crc16(const uint8_t *data, const uint32_t cnt);
+extern void xymodem_port_abort(void);
+extern xym_sta_t xymodem_port_read_data(uint8_t *data, const uint32_t cnt, uint32_t *got, const uint32_t tick);
 
     if (XYM_OK != xymodem_port_init())
     {
@@ -184,7 +235,9 @@ extern xym_sta_t xymodem_port_crc16(const uint8_t *data, const uint32_t cnt);
     struct xym_ops xym_init_ops = {
         .send = xymodem_port_send_data,
         .recv = xymodem_port_recv_data,
-        .crc16 = NULL, //xymodem_port_crc16
+        .crc16 = NULL, //xymodem_port_crc16 (CRC16_HW_ENABLE / MODE_ISR: CRC16 of a received frame computed on arrival)
+        .abort = xymodem_port_abort, /* xymodem_cancel_request(&session) from ISR / other threads */
+        .read = xymodem_port_read_data, /* used when built with XYM_RX_BUFF_SIZE > 0 */
     };
     struct xym_param xym_init_param = {
         .send_timeout = 1000,
@@ -192,6 +245,9 @@ extern xym_sta_t xymodem_port_crc16(const uint8_t *data, const uint32_t cnt);
         .error_max_retry = 10,
     };
     xymodem_session_init(&session, xym_init_ops, xym_init_param);
+#ifdef STACK_PROBE_SIZE
+    stack_paint();
+#endif
 
 Xmodem_Receiver:
 #if (EXAMPLE_CONFIG & (X_MODEM | RECEIVER))
@@ -313,11 +369,22 @@ Ymodem_Sender:
 #endif
 
 Session_End:
+#ifdef STACK_PROBE_SIZE
+    /* the library below the example frame; the session and buffer are in the frame unless ATTRIBUTE_FAST_MEM is static */
+    __XYM_LOG__("X / Y modem stack high-water [%u] Bytes, session [%u] + buffer [%u] Bytes\r\n",
+                (unsigned)stack_peak(), (unsigned)sizeof(session), (unsigned)sizeof(buff));
+#endif
     if (res_sta != XYM_END)
     {
         __XYM_LOG__("X / Y modem session error termination, error code[%d]!\r\n", res_sta);
-        return res_sta;
     }
-    __XYM_LOG__("X / Y modem session normal end!\r\n");
-    return 0;
+    else
+    {
+        __XYM_LOG__("X / Y modem session normal end!\r\n");
+        res_sta = XYM_OK;
+    }
+#ifdef XYM_LOG_ENABLE
+    xymodem_log_flush(printf, 0); /* out of the data path: the log points of the library and the example */
+#endif
+    return res_sta;
 }
@@ -0,0 +1,143 @@
+/**
+ *******************************************************************************************************************************************
+ * @file        xymodem_log.c
+ * @brief       X / Y modem deferred binary log (a log point stores a record into RAM, the text is formatted later)
+ * @since       Change Logs:
+ * Date         Author       Notes
+ * 2026-10-18   lzh          the first version
+ * 2026-10-18   agent        ANSI C: XYM_LOG((fmt, ...)), the arguments are counted by the format string
+ * @copyright (c) 2023 lzh <lzhoran@163.com>
+ *                https://github.com/ZeHHHHH/Flexible-XYmodem.git
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *******************************************************************************************************************************************
+ */
+#include "xymodem_log.h"
+
+#ifdef XYM_LOG_ENABLE
+
+/*******************************************************************************************************************************************
+ * Private Define
+ *******************************************************************************************************************************************/
+/* flags, width, precision and length modifier of a conversion */
+#define IS_LOG_MODIFIER(c)    (((c) >= '0' && (c) <= '9') || (c) == '-' || (c) == '+' || (c) == ' ' || (c) == '#' || \
+                               (c) == '.' || (c) == 'h' || (c) == 'l' || (c) == 'L' || (c) == 'j' || (c) == 'z' || (c) == 't')
+
+/*******************************************************************************************************************************************
+ * Public Variable
+ *******************************************************************************************************************************************/
+/* magic, depth, args, rec_size: the header read by xym-log */
+xym_log_t xym_log = {XYM_LOG_MAGIC, XYM_LOG_DEPTH, XYM_LOG_ARGS, sizeof(xym_log_rec_t), 0, 0, 0, {{0}}};
+
+/*******************************************************************************************************************************************
+ * Public Function
+ *******************************************************************************************************************************************/
+/**
+ * @brief  X/Y modem log store a record (called by [XYM_LOG])
+ * @param  fmt : format string, kept by its address
+ * @param  ... : int / unsigned int arguments, counted by the conversions of [fmt], the ones after XYM_LOG_ARGS are ignored
+ * @retval \
+ */
+void xymodem_log_write(const char *fmt, ...)
+{
+    uint32_t arg[XYM_LOG_ARGS] = {0};
+    xym_log_rec_t *r = NULL;
+    const char *s = fmt;
+    uint8_t cnt = 0;
+    uint8_t i = 0;
+    va_list ap;
+
+    /* one argument per conversion and per '*', nothing is formatted */
+    va_start(ap, fmt);
+    while (cnt < XYM_LOG_ARGS && *s != '\0')
+    {
+        if (*s++ != '%')
+        {
+            continue;
+        }
+        if (*s == '%')
+        {
+            ++s;
+            continue;
+        }
+        for (; *s != '\0' && (*s == '*' || IS_LOG_MODIFIER(*s)); ++s)
+        {
+            if (*s == '*' && cnt < XYM_LOG_ARGS)
+            {
+                arg[cnt++] = va_arg(ap, unsigned int);
+            }
+        }
+        if (*s != '\0' && cnt < XYM_LOG_ARGS)
+        {
+            arg[cnt++] = va_arg(ap, unsigned int);
+            ++s;
+        }
+    }
+    va_end(ap);
+
+    XYM_LOG_LOCK();
+    r = &xym_log.rec[xym_log.wr & (XYM_LOG_DEPTH - 1)];
+    r->fmt = (uintptr_t)fmt;
+    r->tick = (uint32_t)XYM_LOG_TICK();
+    for (i = 0; i < XYM_LOG_ARGS; ++i)
+    {
+        r->arg[i] = arg[i];
+    }
+    xym_log.wr++;
+    XYM_LOG_UNLOCK();
+}
+
+/**
+ * @brief  X/Y modem log format the stored records
+ * @param  print : printf-like output, eg: printf
+ * @param  max   : max records this time, 0: all
+ * @retval records formatted
+ * @note   Call it where blocking does not matter: idle hook / low priority task / after the session
+ */
+uint32_t xymodem_log_flush(int (*print)(const char *fmt, ...), const uint32_t max)
+{
+    xym_log_rec_t r;
+    uint32_t n = 0, lost = 0;
+
+    for (n = 0; max == 0 || n < max; ++n)
+    {
+        XYM_LOG_LOCK();
+        if (xym_log.rd == xym_log.wr)
+        {
+            XYM_LOG_UNLOCK();
+            break;
+        }
+        /* overwritten: continue from the oldest record still in the ring */
+        if (xym_log.wr - xym_log.rd > XYM_LOG_DEPTH)
+        {
+            xym_log.lost += xym_log.wr - xym_log.rd - XYM_LOG_DEPTH;
+            xym_log.rd = xym_log.wr - XYM_LOG_DEPTH;
+        }
+        r = xym_log.rec[xym_log.rd & (XYM_LOG_DEPTH - 1)];
+        xym_log.rd++;
+        lost = xym_log.lost;
+        xym_log.lost = 0;
+        XYM_LOG_UNLOCK();
+
+        if (lost > 0)
+        {
+            print("[xym-log] %lu records lost\r\n", (unsigned long)lost);
+        }
+        print("[%10lu] ", (unsigned long)r.tick);
+        print((const char *)r.fmt, r.arg[0], r.arg[1], r.arg[2], r.arg[3]);
+    }
+    return n;
+}
+
+#endif /* XYM_LOG_ENABLE */
@@ -0,0 +1,116 @@
+/**
+ *******************************************************************************************************************************************
+ * @file        xymodem_log.h
+ * @brief       X / Y modem deferred binary log (a log point stores a record into RAM, the text is formatted later)
+ * @since       Change Logs:
+ * Date         Author       Notes
+ * 2026-10-18   lzh          the first version
+ * 2026-10-18   agent        ANSI C: XYM_LOG((fmt, ...)) without variadic macro
+ * @copyright (c) 2023 lzh <lzhoran@163.com>
+ *                https://github.com/ZeHHHHH/Flexible-XYmodem.git
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *******************************************************************************************************************************************
+ */
+#ifndef __XYMODEM_LOG_H__
+#define __XYMODEM_LOG_H__
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Build with -DXYM_LOG_ENABLE to keep the log points of the library, the ports and the application:
+ *   XYM_LOG(("retry seq %u, reply 0x%02x\n", seq, reply));
+ * costs a few stores into a RAM ring: the address of the format string(in ROM, the ID of the log point),
+ * a time stamp and up to 4 raw 32 bits arguments. Nothing is formatted or sent in the data path:
+ *   - on the target, [xymodem_log_flush] formats the records from an idle hook / after the session;
+ *   - on the host, xym-log formats a memory dump of [xym_log] with the firmware image(tools/xym_log.c).
+ * Arguments are int / unsigned int(%d %u %x %c), wider values and pointers are cast by (unsigned)(uintptr_t);
+ * %s only for strings in ROM. The double parentheses keep the macro ANSI C(no variadic macro).
+ * Without XYM_LOG_ENABLE the log points compile to nothing.
+ */
+
+#ifdef XYM_LOG_ENABLE
+
+/** Records in the ring (power of 2), the oldest are overwritten */
+#ifndef XYM_LOG_DEPTH
+#define XYM_LOG_DEPTH         (64)
+#endif
+
+/** Time stamp of a record, eg: SysTick count / HAL_GetTick() */
+#ifndef XYM_LOG_TICK
+#define XYM_LOG_TICK()        (0)
+#endif
+
+/** Critical section of a record, needed when log points of different interrupt priorities / threads may nest
+ *  (eg: primask = __get_PRIMASK(); __disable_irq(); ... __set_PRIMASK(primask)) */
+#ifndef XYM_LOG_LOCK
+#define XYM_LOG_LOCK()
+#define XYM_LOG_UNLOCK()
+#endif
+
+#define XYM_LOG_ARGS          (4)          /**< max arguments of a record */
+#define XYM_LOG_MAGIC         (0x4C4D5958) /**< "XYML", start of [xym_log] in a memory dump */
+
+/** X/Y modem log record */
+typedef struct xym_log_rec
+{
+    uintptr_t fmt;                   /**< address of the format string */
+    uint32_t tick;                   /**< time stamp */
+    uint32_t arg[XYM_LOG_ARGS];      /**< raw arguments */
+} xym_log_rec_t;
+
+/** X/Y modem log ring (a debugger dumps it as it is: sizeof(xym_log) Bytes from &xym_log) */
+typedef struct xym_log
+{
+    uint32_t magic;                  /**< XYM_LOG_MAGIC */
+    uint16_t depth;                  /**< XYM_LOG_DEPTH */
+    uint8_t args;                    /**< XYM_LOG_ARGS */
+    uint8_t rec_size;                /**< sizeof(xym_log_rec_t), tells the pointer size to the host */
+    volatile uint32_t wr;            /**< records written */
+    volatile uint32_t rd;            /**< records formatted by [xymodem_log_flush] */
+    volatile uint32_t lost;          /**< records overwritten before they were formatted */
+    xym_log_rec_t rec[XYM_LOG_DEPTH];
+} xym_log_t;
+
+extern xym_log_t xym_log;
+
+/**
+ * @brief  X/Y modem log store a record (called by [XYM_LOG])
+ * @param  fmt : format string, kept by its address
+ * @param  ... : int / unsigned int arguments, counted by the conversions of [fmt], the ones after XYM_LOG_ARGS are ignored
+ * @retval \
+ */
+void xymodem_log_write(const char *fmt, ...);
+
+/**
+ * @brief  X/Y modem log format the stored records
+ * @param  print : printf-like output, eg: printf
+ * @param  max   : max records this time, 0: all
+ * @retval records formatted
+ * @note   Call it where blocking does not matter: idle hook / low priority task / after the session
+ */
+uint32_t xymodem_log_flush(int (*print)(const char *fmt, ...), const uint32_t max);
+
+/** Deferred log point: XYM_LOG((fmt, up to XYM_LOG_ARGS integer arguments)) */
+#define XYM_LOG(args)         xymodem_log_write args
+
+#else
+
+#define XYM_LOG(args)         ((void)0)
+
+#endif /* XYM_LOG_ENABLE */
+
+#endif /* __XYMODEM_LOG_H__ */
@@ -0,0 +1,361 @@
+/**
+ *******************************************************************************************************************************************
+ * @file        xymodem_mux.c
+ * @brief       X / Y modem channel multiplexer (several logical sessions interleaved over one physical link)
+ * @since       Change Logs:
+ * Date         Author       Notes
+ * 2026-10-18   lzh          the first version
+ * 2026-10-18   lzh          the chunks of one round leave in one send(a reply rides with the data of another channel), add [xymodem_mux_pending]
+ * @copyright (c) 2023 lzh <lzhoran@163.com>
+ *                https://github.com/ZeHHHHH/Flexible-XYmodem.git
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *******************************************************************************************************************************************
+ */
+#include <string.h>
+#include "xymodem_mux.h"
+
+/*******************************************************************************************************************************************
+ * Private Prototype
+ *******************************************************************************************************************************************/
+#define MUX_HDR_SIZE            (4)
+#define MUX_HDR_CHECK(ch, len)  ((uint8_t)((ch) ^ (len) ^ 0x5A))
+#define RING_MASK               (XYM_MUX_RING_SIZE - 1)
+
+/*******************************************************************************************************************************************
+ * Private Function
+ *******************************************************************************************************************************************/
+/**
+ * @brief  X/Y modem mux copy out of a ring (consumer)
+ * @param  r    : ring
+ * @param  data : data
+ * @param  cnt  : data size / Bytes, <= used
+ * @retval \
+ */
+static void xymodem_mux_ring_get(xym_mux_ring_t *r, uint8_t *data, const uint32_t cnt)
+{
+    uint32_t pos = r->rd & RING_MASK;
+    uint32_t n = (cnt < XYM_MUX_RING_SIZE - pos) ? cnt : XYM_MUX_RING_SIZE - pos;
+
+    XYM_MUX_BARRIER();
+    memcpy(data, &r->buff[pos], n);
+    memcpy(&data[n], r->buff, cnt - n);
+    XYM_MUX_BARRIER();
+    r->rd += cnt;
+}
+
+/**
+ * @brief  X/Y modem mux copy into a ring (producer)
+ * @param  r    : ring
+ * @param  data : data
+ * @param  cnt  : data size / Bytes, <= free
+ * @retval \
+ */
+static void xymodem_mux_ring_put(xym_mux_ring_t *r, const uint8_t *data, const uint32_t cnt)
+{
+    uint32_t pos = r->wr & RING_MASK;
+    uint32_t n = (cnt < XYM_MUX_RING_SIZE - pos) ? cnt : XYM_MUX_RING_SIZE - pos;
+
+    memcpy(&r->buff[pos], data, n);
+    memcpy(r->buff, &data[n], cnt - n);
+    XYM_MUX_BARRIER();
+    r->wr += cnt;
+}
+
+/**
+ * @brief  X/Y modem mux demultiplex received data of the physical link
+ * @param  m    : mux
+ * @param  data : data
+ * @param  cnt  : data size / Bytes
+ * @retval \
+ */
+static void xymodem_mux_demux(xym_mux_t *m, const uint8_t *data, const uint32_t cnt)
+{
+    xym_mux_chan_t *c = NULL;
+    uint32_t i = 0, n = 0, room = 0;
+    uint8_t k = 0;
+
+    while (i < cnt)
+    {
+        /* payload: straight into the channel, what does not fit is dropped (the X/Y modem retry recovers) */
+        if (m->left > 0)
+        {
+            n = (cnt - i < m->left) ? cnt - i : m->left;
+            c = &m->chan[m->ch];
+            room = XYM_MUX_RING_SIZE - (c->rx.wr - c->rx.rd);
+            room = (room < n) ? room : n;
+            xymodem_mux_ring_put(&c->rx, &data[i], room);
+            c->drop += n - room;
+            m->left -= (uint8_t)n;
+            i += n;
+            continue;
+        }
+        /* header */
+        m->hdr[m->hdr_len++] = data[i++];
+        if (m->hdr[0] != XYM_MUX_SOF)
+        {
+            m->hdr_len = 0;
+            m->bad++;
+            continue;
+        }
+        if (m->hdr_len < MUX_HDR_SIZE)
+        {
+            continue;
+        }
+        if (m->hdr[1] < m->num && m->hdr[2] > 0 && m->hdr[2] <= XYM_MUX_CHUNK && m->hdr[3] == MUX_HDR_CHECK(m->hdr[1], m->hdr[2]))
+        {
+            m->ch = m->hdr[1];
+            m->left = m->hdr[2];
+            m->hdr_len = 0;
+            continue;
+        }
+        /* bad header: resynchronize from the next SOF inside it */
+        m->bad++;
+        for (k = 1; k < MUX_HDR_SIZE && m->hdr[k] != XYM_MUX_SOF; ++k)
+        {
+        }
+        m->hdr_len = (uint8_t)(MUX_HDR_SIZE - k);
+        memmove(m->hdr, &m->hdr[k], m->hdr_len);
+    }
+}
+
+/*******************************************************************************************************************************************
+ * Public Function
+ *******************************************************************************************************************************************/
+/**
+ * @brief  X/Y modem mux initialization
+ * @param  m         : mux, by [XYM_MUX_DEFINE]
+ * @param  phy       : physical link, [send] and [read] (or [recv] when [read] is NULL) are used
+ * @param  ticks     : tick source of the session timeouts (the tick of [xym_param])
+ * @param  send_tick : send 1 Bytes timeout of the physical link / tick
+ * @retval enum xym_sta
+ */
+xym_sta_t xymodem_mux_init(xym_mux_t *m, struct xym_ops phy, uint32_t (*ticks)(void), const uint32_t send_tick)
+{
+    if (!(m && m->chan && m->num > 0 && phy.send && (phy.read || phy.recv) && ticks))
+    {
+        return XYM_ERROR_INVALID_DATA;
+    }
+    memset(m->chan, 0, sizeof(xym_mux_chan_t) * m->num);
+    m->next = 0;
+    m->phy = phy;
+    m->ticks = ticks;
+    m->send_tick = send_tick;
+    m->hdr_len = 0;
+    m->left = 0;
+    m->bad = 0;
+    return XYM_OK;
+}
+
+/**
+ * @brief  X/Y modem mux pump: move received data to the channels, then send one chunk of each channel in turn
+ * @param  m    : mux
+ * @param  tick : wait for received data / tick, 0: only take what is there
+ * @retval XYM_OK : success, other : physical link error
+ * @note   Call it continuously from one context (pump task / main loop) while the sessions run in their own contexts.
+ *         While one target is busy (eg: flash write before its ACK), the link time goes to the other channels.
+ *         The chunks of one round are gathered into one send of the physical link.
+ */
+xym_sta_t xymodem_mux_poll(xym_mux_t *m, const uint32_t tick)
+{
+    uint8_t frame[2 * (MUX_HDR_SIZE + XYM_MUX_CHUNK)];
+    xym_mux_ring_t *r = NULL;
+    xym_sta_t res = XYM_OK;
+    uint32_t got = 0, n = 0, len = 0, wait = tick;
+    uint8_t i = 0, ch = 0;
+
+    /* pending data to send: do not wait for the receive */
+    wait = (xymodem_mux_pending(m) > 0) ? 0 : wait;
+    if (m->phy.read != NULL)
+    {
+        res = m->phy.read(frame, sizeof(frame), &got, wait);
+    }
+    else
+    {
+        res = m->phy.recv(frame, 1, wait);
+        got = 1;
+    }
+    if (res == XYM_OK)
+    {
+        xymodem_mux_demux(m, frame, got);
+    }
+    else if (res != XYM_ERROR_TIMEOUT)
+    {
+        return res;
+    }
+
+    /* round-robin: one chunk of each channel, the start rotates; the chunks are gathered, so a reply(eg: ACK)
+       of one channel leaves in the same send as the data of another one */
+    for (i = 0; i < m->num; ++i)
+    {
+        ch = (uint8_t)((m->next + i) % m->num);
+        r = &m->chan[ch].tx;
+        if ((n = r->wr - r->rd) == 0)
+        {
+            continue;
+        }
+        n = (n < XYM_MUX_CHUNK) ? n : XYM_MUX_CHUNK;
+        if (len + MUX_HDR_SIZE + n > sizeof(frame))
+        {
+            if (XYM_OK != (res = m->phy.send(frame, len, m->send_tick)))
+            {
+                return res;
+            }
+            len = 0;
+        }
+        frame[len + 0] = XYM_MUX_SOF;
+        frame[len + 1] = ch;
+        frame[len + 2] = (uint8_t)n;
+        frame[len + 3] = MUX_HDR_CHECK(ch, n);
+        xymodem_mux_ring_get(r, &frame[len + MUX_HDR_SIZE], n);
+        len += MUX_HDR_SIZE + n;
+    }
+    if (len > 0 && XYM_OK != (res = m->phy.send(frame, len, m->send_tick)))
+    {
+        return res;
+    }
+    m->next = (uint8_t)((m->next + 1) % m->num);
+    return XYM_OK;
+}
+
+/**
+ * @brief  X/Y modem mux data queued by the sessions and not yet sent on the physical link
+ * @param  m : mux
+ * @retval data size / Bytes
+ * @note   Keep the pump running until it is 0 after the sessions are over (the last ACK / CAN)
+ */
+uint32_t xymodem_mux_pending(const xym_mux_t *m)
+{
+    uint32_t n = 0;
+    uint8_t i = 0;
+
+    for (i = 0; i < m->num; ++i)
+    {
+        n += m->chan[i].tx.wr - m->chan[i].tx.rd;
+    }
+    return n;
+}
+
+/**
+ * @brief  X/Y modem mux discard the buffered data of a channel (before a new session on it)
+ * @param  m  : mux
+ * @param  ch : channel
+ * @retval \
+ * @note   Only while the pump and the session of the channel are idle
+ */
+void xymodem_mux_flush(xym_mux_t *m, const uint8_t ch)
+{
+    if (ch < m->num)
+    {
+        m->chan[ch].tx.rd = m->chan[ch].tx.wr;
+        m->chan[ch].rx.rd = m->chan[ch].rx.wr;
+        m->chan[ch].drop = 0;
+    }
+}
+
+/**
+ * @brief  X/Y modem mux send data of a channel (queued for the pump)
+ * @param  m    : mux
+ * @param  ch   : channel
+ * @param  data : data
+ * @param  cnt  : data size / Bytes
+ * @param  tick : queue 1 Bytes timeout / tick
+ * @retval enum xym_sta
+ */
+xym_sta_t xymodem_mux_send(xym_mux_t *m, const uint8_t ch, const uint8_t *data, const uint32_t cnt, const uint32_t tick)
+{
+    xym_mux_ring_t *r = NULL;
+    uint32_t i = 0, n = 0, start = 0;
+
+    if (ch >= m->num)
+    {
+        return XYM_ERROR_INVALID_DATA;
+    }
+    r = &m->chan[ch].tx;
+    for (start = m->ticks(); i < cnt; i += n)
+    {
+        /* wait for room, the pump drains the ring one chunk per round */
+        while ((n = XYM_MUX_RING_SIZE - (r->wr - r->rd)) == 0)
+        {
+            if (m->ticks() - start >= tick)
+            {
+                return XYM_ERROR_TIMEOUT;
+            }
+            XYM_MUX_IDLE();
+        }
+        n = (cnt - i < n) ? cnt - i : n;
+        xymodem_mux_ring_put(r, &data[i], n);
+        start = m->ticks();
+    }
+    return XYM_OK;
+}
+
+/**
+ * @brief  X/Y modem mux receive up to [cnt] data of a channel, return as soon as at least 1 Byte is received
+ * @param  m    : mux
+ * @param  ch   : channel
+ * @param  data : data
+ * @param  cnt  : max data size / Bytes
+ * @param  got  : received data size / Bytes
+ * @param  tick : receive the first Bytes timeout / tick, 0: only take what is there
+ * @retval enum xym_sta
+ * @note   Also the forwarding of a bridge: channel data -> UART of the target
+ */
+xym_sta_t xymodem_mux_read(xym_mux_t *m, const uint8_t ch, uint8_t *data, const uint32_t cnt, uint32_t *got, const uint32_t tick)
+{
+    xym_mux_ring_t *r = NULL;
+    uint32_t n = 0, start = 0;
+
+    *got = 0;
+    if (ch >= m->num)
+    {
+        return XYM_ERROR_INVALID_DATA;
+    }
+    r = &m->chan[ch].rx;
+    for (start = m->ticks(); (n = r->wr - r->rd) == 0; XYM_MUX_IDLE())
+    {
+        if (m->ticks() - start >= tick)
+        {
+            return XYM_ERROR_TIMEOUT;
+        }
+    }
+    n = (n < cnt) ? n : cnt;
+    xymodem_mux_ring_get(r, data, n);
+    *got = n;
+    return XYM_OK;
+}
+
+/**
+ * @brief  X/Y modem mux receive data of a channel within the set time
+ * @param  m    : mux
+ * @param  ch   : channel
+ * @param  data : data
+ * @param  cnt  : data size / Bytes
+ * @param  tick : receive 1 Bytes timeout / tick
+ * @retval enum xym_sta
+ */
+xym_sta_t xymodem_mux_recv(xym_mux_t *m, const uint8_t ch, uint8_t *data, const uint32_t cnt, const uint32_t tick)
+{
+    xym_sta_t res = XYM_OK;
+    uint32_t i = 0, got = 0;
+
+    for (i = 0; i < cnt; i += got)
+    {
+        if (XYM_OK != (res = xymodem_mux_read(m, ch, &data[i], cnt - i, &got, tick)))
+        {
+            return res;
+        }
+    }
+    return XYM_OK;
+}
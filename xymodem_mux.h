@@ -0,0 +1,209 @@
+/**
+ *******************************************************************************************************************************************
+ * @file        xymodem_mux.h
+ * @brief       X / Y modem channel multiplexer (several logical sessions interleaved over one physical link)
+ * @since       Change Logs:
+ * Date         Author       Notes
+ * 2026-10-18   lzh          the first version
+ * 2026-10-18   lzh          the chunks of one round leave in one send(a reply rides with the data of another channel), add [xymodem_mux_pending]
+ * @copyright (c) 2023 lzh <lzhoran@163.com>
+ *                https://github.com/ZeHHHHH/Flexible-XYmodem.git
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *******************************************************************************************************************************************
+ */
+#ifndef __XYMODEM_MUX_H__
+#define __XYMODEM_MUX_H__
+
+#include "xymodem.h"
+
+/** Ring buffer of each channel and direction / Bytes (power of 2, >= one max frame + replies) */
+#ifndef XYM_MUX_RING_SIZE
+#define XYM_MUX_RING_SIZE     (2048)
+#endif
+
+/** Max payload of a mux frame / Bytes (<= 255): the scheduler interleaves the channels by chunks of this size */
+#ifndef XYM_MUX_CHUNK
+#define XYM_MUX_CHUNK         (64)
+#endif
+
+/** Memory barrier between a session context and the pump context (eg: __DMB() on a dual-core MCU) */
+#ifndef XYM_MUX_BARRIER
+# if defined(__GNUC__) || defined(__clang__)
+#  define XYM_MUX_BARRIER()   __sync_synchronize()
+# else
+#  define XYM_MUX_BARRIER()
+# endif
+#endif
+
+/** Called while a session waits for the pump (eg: osThreadYield()) */
+#ifndef XYM_MUX_IDLE
+# if defined(__unix__)
+#  include <sched.h>
+#  define XYM_MUX_IDLE()      sched_yield()
+# else
+#  define XYM_MUX_IDLE()
+# endif
+#endif
+
+#define XYM_MUX_SOF           (0xA5) /**< start of a mux frame */
+
+/*
+ * Mux frame on the physical link:
+ *   [SOF] [channel] [length 1 ~ XYM_MUX_CHUNK] [channel ^ length ^ 0x5A] [payload]
+ * A bad header is skipped byte by byte until the next valid one, the payload is protected by the X/Y modem frame itself.
+ */
+
+/** X/Y modem mux ring buffer (single producer single consumer) */
+typedef struct xym_mux_ring
+{
+    uint8_t buff[XYM_MUX_RING_SIZE];
+    volatile uint32_t wr;            /**< written by the producer */
+    volatile uint32_t rd;            /**< read by the consumer */
+} xym_mux_ring_t;
+
+/** X/Y modem mux channel */
+typedef struct xym_mux_chan
+{
+    struct xym_mux_ring tx;          /**< session -> pump */
+    struct xym_mux_ring rx;          /**< pump -> session */
+    uint32_t drop;                   /**< received bytes dropped, the session did not read them in time / Bytes */
+} xym_mux_chan_t;
+
+/** X/Y modem mux (Private / Anonymous) */
+typedef struct xym_mux
+{
+    xym_mux_chan_t *chan;            /**< channel array */
+    uint8_t num;                     /**< number of channels */
+    uint8_t next;                    /**< next channel of the round-robin scheduler */
+    struct xym_ops phy;              /**< physical link: [send] and [read] (or [recv]) */
+    uint32_t (*ticks)(void);         /**< tick source of the session timeouts */
+    uint32_t send_tick;              /**< send 1 Bytes timeout of the physical link / tick */
+    uint8_t hdr[4];                  /**< header being parsed */
+    uint8_t hdr_len;                 /**< bytes of the header parsed */
+    uint8_t ch;                      /**< channel of the payload being parsed */
+    uint8_t left;                    /**< payload bytes left */
+    uint32_t bad;                    /**< bytes skipped to find a valid header */
+} xym_mux_t;
+
+/**
+ * @brief  Define a mux with static storage (file scope)
+ * @param  name : mux name, eg: XYM_MUX_DEFINE(bridge, 4) => xym_mux_t bridge
+ * @param  cnt  : number of channels (<= 255)
+ */
+#define XYM_MUX_DEFINE(name, cnt)                    \
+    static xym_mux_chan_t name##_chan[cnt];          \
+    xym_mux_t name = {name##_chan, (cnt), 0, {0}, 0, 0, {0}, 0, 0, 0, 0}
+
+/**
+ * @brief  Define the session ops of a channel ([xym_ops] has no context, one set of trampolines per channel)
+ * @param  name : mux name of [XYM_MUX_DEFINE]
+ * @param  ch   : channel, a literal number, eg: XYM_MUX_CHANNEL(bridge, 0)
+ * @note   Initialize the ops of the session of the channel by [XYM_MUX_OPS(name, ch)]
+ */
+#define XYM_MUX_CHANNEL(name, ch)                                                                                  \
+    static xym_sta_t name##_send_##ch(const uint8_t *data, const uint32_t cnt, const uint32_t tick)                \
+    {                                                                                                              \
+        return xymodem_mux_send(&name, (ch), data, cnt, tick);                                                     \
+    }                                                                                                              \
+    static xym_sta_t name##_recv_##ch(uint8_t *data, const uint32_t cnt, const uint32_t tick)                      \
+    {                                                                                                              \
+        return xymodem_mux_recv(&name, (ch), data, cnt, tick);                                                     \
+    }                                                                                                              \
+    static xym_sta_t name##_read_##ch(uint8_t *data, const uint32_t cnt, uint32_t *got, const uint32_t tick)       \
+    {                                                                                                              \
+        return xymodem_mux_read(&name, (ch), data, cnt, got, tick);                                                \
+    }
+
+/**
+ * @brief  Initializer of the session ops of a channel defined by [XYM_MUX_CHANNEL]
+ * @note   eg: struct xym_ops ops = XYM_MUX_OPS(bridge, 0);  (positional, in the member order of [struct xym_ops])
+ */
+#define XYM_MUX_OPS(name, ch)                                                                                      \
+    {name##_send_##ch, name##_recv_##ch, NULL, NULL, NULL, name##_read_##ch}
+
+/**
+ * @brief  X/Y modem mux initialization
+ * @param  m         : mux, by [XYM_MUX_DEFINE]
+ * @param  phy       : physical link, [send] and [read] (or [recv] when [read] is NULL) are used
+ * @param  ticks     : tick source of the session timeouts (the tick of [xym_param])
+ * @param  send_tick : send 1 Bytes timeout of the physical link / tick
+ * @retval enum xym_sta
+ */
+xym_sta_t xymodem_mux_init(xym_mux_t *m, struct xym_ops phy, uint32_t (*ticks)(void), const uint32_t send_tick);
+
+/**
+ * @brief  X/Y modem mux pump: move received data to the channels, then send one chunk of each channel in turn
+ * @param  m    : mux
+ * @param  tick : wait for received data / tick, 0: only take what is there
+ * @retval XYM_OK : success, other : physical link error
+ * @note   Call it continuously from one context (pump task / main loop) while the sessions run in their own contexts.
+ *         While one target is busy (eg: flash write before its ACK), the link time goes to the other channels.
+ *         The chunks of one round are gathered into one send of the physical link.
+ */
+xym_sta_t xymodem_mux_poll(xym_mux_t *m, const uint32_t tick);
+
+/**
+ * @brief  X/Y modem mux data queued by the sessions and not yet sent on the physical link
+ * @param  m : mux
+ * @retval data size / Bytes
+ * @note   Keep the pump running until it is 0 after the sessions are over (the last ACK / CAN)
+ */
+uint32_t xymodem_mux_pending(const xym_mux_t *m);
+
+/**
+ * @brief  X/Y modem mux discard the buffered data of a channel (before a new session on it)
+ * @param  m  : mux
+ * @param  ch : channel
+ * @retval \
+ * @note   Only while the pump and the session of the channel are idle
+ */
+void xymodem_mux_flush(xym_mux_t *m, const uint8_t ch);
+
+/**
+ * @brief  X/Y modem mux send data of a channel (queued for the pump)
+ * @param  m    : mux
+ * @param  ch   : channel
+ * @param  data : data
+ * @param  cnt  : data size / Bytes
+ * @param  tick : queue 1 Bytes timeout / tick
+ * @retval enum xym_sta
+ */
+xym_sta_t xymodem_mux_send(xym_mux_t *m, const uint8_t ch, const uint8_t *data, const uint32_t cnt, const uint32_t tick);
+
+/**
+ * @brief  X/Y modem mux receive data of a channel within the set time
+ * @param  m    : mux
+ * @param  ch   : channel
+ * @param  data : data
+ * @param  cnt  : data size / Bytes
+ * @param  tick : receive 1 Bytes timeout / tick
+ * @retval enum xym_sta
+ */
+xym_sta_t xymodem_mux_recv(xym_mux_t *m, const uint8_t ch, uint8_t *data, const uint32_t cnt, const uint32_t tick);
+
+/**
+ * @brief  X/Y modem mux receive up to [cnt] data of a channel, return as soon as at least 1 Byte is received
+ * @param  m    : mux
+ * @param  ch   : channel
+ * @param  data : data
+ * @param  cnt  : max data size / Bytes
+ * @param  got  : received data size / Bytes
+ * @param  tick : receive the first Bytes timeout / tick, 0: only take what is there
+ * @retval enum xym_sta
+ * @note   Also the forwarding of a bridge: channel data -> UART of the target
+ */
+xym_sta_t xymodem_mux_read(xym_mux_t *m, const uint8_t ch, uint8_t *data, const uint32_t cnt, uint32_t *got, const uint32_t tick);
+
+#endif /* __XYMODEM_MUX_H__ */
@@ -0,0 +1,159 @@
+/**
+ *******************************************************************************************************************************************
+ * @file        xymodem_pipe.c
+ * @brief       X / Y modem two-stage receive pipeline (I/O and verification stage + storage worker)
+ * @since       Change Logs:
+ * Date         Author       Notes
+ * 2026-10-18   lzh          the first version
+ * 2026-10-18   lzh          the last packet of a Ymodem file is acknowledged after the worker has all of it, add [xymodem_pipe_file_size]
+ * 2026-10-18   agent        verify in the I/O stage and acknowledge a packet once it is queued, [ymodem_info_size] for the file size
+ * @copyright (c) 2023 lzh <lzhoran@163.com>
+ *                https://github.com/ZeHHHHH/Flexible-XYmodem.git
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *******************************************************************************************************************************************
+ */
+#include <string.h>
+#include "xymodem_pipe.h"
+
+/*******************************************************************************************************************************************
+ * Private Prototype
+ *******************************************************************************************************************************************/
+/* a slot is in flight between the stages */
+#define SLOT_OF(q, idx)         (&(q)->slot[(idx) & (XYM_PIPE_DEPTH - 1)])
+
+/*******************************************************************************************************************************************
+ * Public Function
+ *******************************************************************************************************************************************/
+/**
+ * @brief  X/Y modem pipeline initialization
+ * @param  q      : pipeline
+ * @param  p      : session control struct, initialized by [xymodem_session_init]
+ * @param  ymodem : protocol : 0-Xmodem; 1-Ymodem
+ * @param  sink   : storage of the worker stage
+ * @param  user   : user data of [sink]
+ * @retval enum xym_sta
+ */
+xym_sta_t xymodem_pipe_init(xym_pipe_t *q, xym_session_t *p, const uint8_t ymodem, xym_pipe_sink_t sink, void *user)
+{
+    if (!(q && p && sink))
+    {
+        return XYM_ERROR_INVALID_DATA;
+    }
+    memset(q, 0, sizeof(xym_pipe_t));
+    q->p = p;
+    q->ymodem = ymodem;
+    q->sink = sink;
+    q->user = user;
+    return XYM_OK;
+}
+
+/**
+ * @brief  X/Y modem pipeline I/O stage: receive and verify frames, hand them to the worker
+ * @param  q : pipeline
+ * @retval session over (normal or error)
+ * @note   Blocks until the session is over, run it and [xymodem_pipe_worker] in two contexts
+ */
+xym_sta_t xymodem_pipe_io(xym_pipe_t *q)
+{
+    xym_session_t *p = q->p;
+    xym_pipe_slot_t *slot = NULL;
+    xym_sta_t res = XYM_OK;
+    uint32_t file_size = XYM_FILE_SIZE_UNKNOWN, file_got = 0;
+    uint16_t len = 0;
+
+    (q->ymodem != 0) ? ymodem_init(p) : xmodem_init(p);
+    for (;;)
+    {
+        /* wait for a free slot: the ACK of the last packet is held back until the storage catches up */
+        while (q->wr - q->rd >= XYM_PIPE_DEPTH)
+        {
+            XYM_PIPE_IDLE();
+        }
+        /* a Ymodem file is complete: its last ACK (then EOT) waits until the worker has all of it */
+        while (file_size != XYM_FILE_SIZE_UNKNOWN && file_got >= file_size && q->rd != q->wr)
+        {
+            XYM_PIPE_IDLE();
+        }
+        XYM_PIPE_BARRIER();
+        /* the receive acknowledges the packet in the last slot, then verifies the next one while the worker stores */
+        slot = SLOT_OF(q, q->wr);
+        len = 0;
+        if (q->abort != 0)
+        {
+            res = xymodem_active_cancel(p);
+        }
+        else
+        {
+            res = (q->ymodem != 0) ? ymodem_receive(p, slot->data, &len) : xmodem_receive(p, slot->data, &len);
+        }
+        /* publish the frame to the worker */
+        slot->sta = res;
+        slot->size = len;
+        XYM_PIPE_BARRIER();
+        q->wr++;
+        if (res != XYM_OK && res != XYM_FIL_GET)
+        {
+            break;
+        }
+        file_got += len;
+        if (res == XYM_FIL_GET)
+        {
+            file_size = ymodem_info_size(slot->data, len);
+            file_got = 0;
+        }
+    }
+    return res;
+}
+
+/**
+ * @brief  X/Y modem pipeline worker stage: write the verified frames to the sink
+ * @param  q : pipeline
+ * @retval session over (normal or error)
+ * @note   Blocks until the session is over, run it and [xymodem_pipe_io] in two contexts
+ */
+xym_sta_t xymodem_pipe_worker(xym_pipe_t *q)
+{
+    xym_pipe_slot_t *slot = NULL;
+    xym_sta_t sta = XYM_OK;
+
+    for (;;)
+    {
+        while (q->rd == q->wr)
+        {
+            XYM_PIPE_IDLE();
+        }
+        XYM_PIPE_BARRIER();
+        slot = SLOT_OF(q, q->rd);
+        sta = slot->sta;
+        if (sta != XYM_OK && sta != XYM_FIL_GET)
+        {
+            /* the last call is always made, even after the sink has failed: it closes the storage */
+            (void)q->sink(q->user, sta, NULL, 0);
+        }
+        else if (q->abort == 0)
+        {
+            if (XYM_OK != q->sink(q->user, sta, slot->data, slot->size))
+            {
+                q->abort = 1;
+            }
+        }
+        XYM_PIPE_BARRIER();
+        q->rd++;
+        if (sta != XYM_OK && sta != XYM_FIL_GET)
+        {
+            return sta;
+        }
+    }
+}
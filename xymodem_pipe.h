@@ -0,0 +1,120 @@
+/**
+ *******************************************************************************************************************************************
+ * @file        xymodem_pipe.h
+ * @brief       X / Y modem two-stage receive pipeline (I/O and verification stage + storage worker)
+ * @since       Change Logs:
+ * Date         Author       Notes
+ * 2026-10-18   lzh          the first version
+ * 2026-10-18   lzh          the last packet of a Ymodem file is acknowledged after the worker has all of it, add [xymodem_pipe_file_size]
+ * 2026-10-18   agent        verify in the I/O stage and acknowledge a packet once it is queued, [ymodem_info_size] for the file size
+ * @copyright (c) 2023 lzh <lzhoran@163.com>
+ *                https://github.com/ZeHHHHH/Flexible-XYmodem.git
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *******************************************************************************************************************************************
+ */
+#ifndef __XYMODEM_PIPE_H__
+#define __XYMODEM_PIPE_H__
+
+#include "xymodem.h"
+
+/** Number of frame slots between the two stages (power of 2) */
+#ifndef XYM_PIPE_DEPTH
+#define XYM_PIPE_DEPTH        (4)
+#endif
+
+/** Memory barrier between the two contexts (eg: __DMB() on a dual-core MCU) */
+#ifndef XYM_PIPE_BARRIER
+# if defined(__GNUC__) || defined(__clang__)
+#  define XYM_PIPE_BARRIER()  __sync_synchronize()
+# else
+#  define XYM_PIPE_BARRIER()
+# endif
+#endif
+
+/** Called while a stage waits for the other one (eg: osThreadYield()) */
+#ifndef XYM_PIPE_IDLE
+# if defined(__unix__)
+#  include <sched.h>
+#  define XYM_PIPE_IDLE()     sched_yield()
+# else
+#  define XYM_PIPE_IDLE()
+# endif
+#endif
+
+/**
+ * @brief  storage of the worker stage
+ * @param  user : user data of [xymodem_pipe_init]
+ * @param  sta  : XYM_OK       : a verified packet of valid data (acknowledged once queued, except the last one of a Ymodem file)
+ *                XYM_FIL_GET  : a Ymodem file info packet
+ *                other        : session over (normal or error), [data] is NULL, last call, made even after a failure
+ * @param  data : data
+ * @param  size : data size / Bytes
+ * @retval XYM_OK : continue, other : cancel the session
+ */
+typedef xym_sta_t (*xym_pipe_sink_t)(void *user, const xym_sta_t sta, const uint8_t *data, const uint16_t size);
+
+/** X/Y modem pipeline frame slot */
+typedef struct xym_pipe_slot
+{
+    uint8_t data[XYM_PKT_SIZE_1024]; /**< valid data */
+    uint16_t size;                   /**< size of valid data / Bytes */
+    xym_sta_t sta;                   /**< receive result */
+} xym_pipe_slot_t;
+
+/** X/Y modem pipeline (Private / Anonymous) */
+typedef struct xym_pipe
+{
+    xym_session_t *p;                /**< session, only used by the I/O stage */
+    uint8_t ymodem;                  /**< protocol : 0-Xmodem; 1-Ymodem */
+    xym_pipe_sink_t sink;            /**< storage */
+    void *user;                      /**< user data of [sink] */
+    volatile uint32_t wr;            /**< slots published by the I/O stage (SPSC producer index) */
+    volatile uint32_t rd;            /**< slots released by the worker stage (SPSC consumer index) */
+    volatile uint8_t abort;          /**< storage failed, cancel requested by the worker */
+    struct xym_pipe_slot slot[XYM_PIPE_DEPTH];
+} xym_pipe_t;
+
+/**
+ * @brief  X/Y modem pipeline initialization
+ * @param  q      : pipeline
+ * @param  p      : session control struct, initialized by [xymodem_session_init]
+ * @param  ymodem : protocol : 0-Xmodem; 1-Ymodem
+ * @param  sink   : storage of the worker stage
+ * @param  user   : user data of [sink]
+ * @retval enum xym_sta
+ */
+xym_sta_t xymodem_pipe_init(xym_pipe_t *q, xym_session_t *p, const uint8_t ymodem, xym_pipe_sink_t sink, void *user);
+
+/**
+ * @brief  X/Y modem pipeline I/O stage: receive and verify frames, hand them to the worker
+ * @param  q : pipeline
+ * @retval session over (normal or error)
+ * @note   Blocks until the session is over, run it and [xymodem_pipe_worker] in two contexts.
+ *         A bad frame is rejected(NAK) here, a good one is acknowledged as soon as it is queued: the next frame is
+ *         received and verified while the worker stores this one. With all slots queued the ACK waits for the worker.
+ *         The last packet of a Ymodem file (by the size in its file info) is acknowledged after the worker has stored it,
+ *         so the sender sees the end of the file only when the whole file is stored.
+ */
+xym_sta_t xymodem_pipe_io(xym_pipe_t *q);
+
+/**
+ * @brief  X/Y modem pipeline worker stage: write the verified frames to the sink
+ * @param  q : pipeline
+ * @retval session over (normal or error)
+ * @note   Blocks until the session is over, run it and [xymodem_pipe_io] in two contexts
+ */
+xym_sta_t xymodem_pipe_worker(xym_pipe_t *q);
+
+#endif /* __XYMODEM_PIPE_H__ */
@@ -0,0 +1,158 @@
+/**
+ *******************************************************************************************************************************************
+ * @file        xymodem_relay.c
+ * @brief       X / Y modem cut-through relay (upstream Ymodem receive forwarded packet by packet to a downstream Ymodem transmit)
+ * @since       Change Logs:
+ * Date         Author       Notes
+ * 2026-10-18   lzh          the first version
+ * 2026-10-18   agent        end an empty file with its file info, [ymodem_info_size] for the file size
+ * @copyright (c) 2023 lzh <lzhoran@163.com>
+ *                https://github.com/ZeHHHHH/Flexible-XYmodem.git
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *******************************************************************************************************************************************
+ */
+#include "xymodem_relay.h"
+
+/*******************************************************************************************************************************************
+ * Private Function
+ *******************************************************************************************************************************************/
+/**
+ * @brief  X/Y modem relay end the current file downstream (EOT)
+ * @param  r : relay
+ * @retval enum xym_sta
+ */
+static xym_sta_t xymodem_relay_eof(xym_relay_t *r)
+{
+    xym_sta_t res = XYM_OK;
+
+    if (r->file_open != 0)
+    {
+        r->file_open = 0;
+        res = ymodem_transmit_eof(r->down); /* also an empty file */
+        res = (res == XYM_FIL_SET) ? XYM_OK : res;
+    }
+    return res;
+}
+
+/**
+ * @brief  X/Y modem relay forward a verified packet downstream (sink of the pipeline worker)
+ * @param  user : relay
+ * @param  sta  : XYM_OK : data, XYM_FIL_GET : file info, other : upstream session over
+ * @param  data : data
+ * @param  size : data size / Bytes
+ * @retval XYM_OK : continue, other : cancel the upstream session
+ */
+static xym_sta_t xymodem_relay_forward(void *user, const xym_sta_t sta, const uint8_t *data, const uint16_t size)
+{
+    xym_relay_t *r = (xym_relay_t *)user;
+    xym_sta_t res = XYM_OK;
+
+    switch (sta)
+    {
+    case XYM_FIL_GET:
+        if (XYM_OK == (res = xymodem_relay_eof(r)))
+        {
+            r->file_size = ymodem_info_size(data, size);
+            r->file_done = 0;
+            res = ymodem_transmit(r->down, data, size);
+            r->file_open = (res == XYM_OK) ? 1 : 0;
+            /* an empty file is delivered with its file info */
+            if (res == XYM_OK && r->file_size == 0)
+            {
+                res = xymodem_relay_eof(r);
+            }
+        }
+        break;
+    case XYM_OK:
+        res = ymodem_transmit(r->down, data, size);
+        r->file_done += size;
+        /* the whole file is delivered before its last packet is acknowledged upstream */
+        if (res == XYM_OK && r->file_size != XYM_FILE_SIZE_UNKNOWN && r->file_done >= r->file_size)
+        {
+            res = xymodem_relay_eof(r);
+        }
+        break;
+    case XYM_END:
+        /* end of batch: the null file info packet */
+        if (XYM_OK == (res = xymodem_relay_eof(r)))
+        {
+            res = ymodem_transmit(r->down, xymodem_frame_data(r->down), 0);
+        }
+        r->down_sta = res;
+        return XYM_OK;
+    default:
+        /* upstream failure: cancel the downstream session, unless it is already over(its failure cancelled upstream) */
+        if (r->down_sta == XYM_OK)
+        {
+            r->down_sta = xymodem_active_cancel(r->down);
+        }
+        return XYM_OK;
+    }
+    if (res != XYM_OK)
+    {
+        r->down_sta = res; /* the downstream session is over, the upstream one is cancelled by the pipeline */
+    }
+    return res;
+}
+
+/*******************************************************************************************************************************************
+ * Public Function
+ *******************************************************************************************************************************************/
+/**
+ * @brief  X/Y modem relay initialization
+ * @param  r    : relay
+ * @param  up   : upstream session (receive), initialized by [xymodem_session_init]
+ * @param  down : downstream session (transmit), initialized by [xymodem_session_init]
+ * @retval enum xym_sta
+ * @note   The upstream sender must wait for a reply longer than XYM_PIPE_DEPTH packets take on the downstream link
+ */
+xym_sta_t xymodem_relay_init(xym_relay_t *r, xym_session_t *up, xym_session_t *down)
+{
+    if (!(r && down && up != down))
+    {
+        return XYM_ERROR_INVALID_DATA;
+    }
+    r->down = down;
+    r->file_size = XYM_FILE_SIZE_UNKNOWN;
+    r->file_done = 0;
+    r->file_open = 0;
+    r->down_sta = XYM_OK;
+    return xymodem_pipe_init(&r->pipe, up, 1, xymodem_relay_forward, r);
+}
+
+/**
+ * @brief  X/Y modem relay upstream stage: receive and verify packets, hand them to the downstream stage
+ * @param  r : relay
+ * @retval upstream session over (normal or error)
+ * @note   Blocks until the session is over, run it and [xymodem_relay_downstream] in two contexts
+ */
+xym_sta_t xymodem_relay_upstream(xym_relay_t *r)
+{
+    return xymodem_pipe_io(&r->pipe);
+}
+
+/**
+ * @brief  X/Y modem relay downstream stage: transmit the verified packets
+ * @param  r : relay
+ * @retval XYM_END : all files are delivered, other : downstream session over by error / cancel
+ * @note   Blocks until the session is over, run it and [xymodem_relay_upstream] in two contexts.
+ *         A downstream failure cancels the upstream session, an upstream failure cancels the downstream session.
+ */
+xym_sta_t xymodem_relay_downstream(xym_relay_t *r)
+{
+    ymodem_init(r->down);
+    (void)xymodem_pipe_worker(&r->pipe);
+    return r->down_sta;
+}
@@ -0,0 +1,76 @@
+/**
+ *******************************************************************************************************************************************
+ * @file        xymodem_relay.h
+ * @brief       X / Y modem cut-through relay (upstream Ymodem receive forwarded packet by packet to a downstream Ymodem transmit)
+ * @since       Change Logs:
+ * Date         Author       Notes
+ * 2026-10-18   lzh          the first version
+ * @copyright (c) 2023 lzh <lzhoran@163.com>
+ *                https://github.com/ZeHHHHH/Flexible-XYmodem.git
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *******************************************************************************************************************************************
+ */
+#ifndef __XYMODEM_RELAY_H__
+#define __XYMODEM_RELAY_H__
+
+#include "xymodem_pipe.h"
+
+/*
+ * Relay of a gateway: host ==(upstream link)==> gateway ==(downstream link)==> device
+ *   [xymodem_relay_upstream]   : Ymodem receive of the upstream session, the I/O stage of a [xym_pipe]
+ *   [xymodem_relay_downstream] : Ymodem transmit of the downstream session, the worker stage of the [xym_pipe]
+ * Each verified packet is forwarded at once. The upstream runs at most XYM_PIPE_DEPTH packets ahead of the downstream,
+ * the last packet of a file is acknowledged upstream after the downstream has acknowledged the EOT of the file.
+ */
+
+/** X/Y modem relay (Private / Anonymous) */
+typedef struct xym_relay
+{
+    struct xym_pipe pipe;            /**< upstream receive -> downstream transmit */
+    xym_session_t *down;             /**< downstream session */
+    uint32_t file_size;              /**< size of the current file, XYM_FILE_SIZE_UNKNOWN: unknown / Bytes */
+    uint32_t file_done;              /**< data of the current file forwarded / Bytes */
+    uint8_t file_open;               /**< the EOT of the current file is pending downstream : 0-No; 1-Yes */
+    xym_sta_t down_sta;              /**< downstream result */
+} xym_relay_t;
+
+/**
+ * @brief  X/Y modem relay initialization
+ * @param  r    : relay
+ * @param  up   : upstream session (receive), initialized by [xymodem_session_init]
+ * @param  down : downstream session (transmit), initialized by [xymodem_session_init]
+ * @retval enum xym_sta
+ * @note   The upstream sender must wait for a reply longer than XYM_PIPE_DEPTH packets take on the downstream link
+ */
+xym_sta_t xymodem_relay_init(xym_relay_t *r, xym_session_t *up, xym_session_t *down);
+
+/**
+ * @brief  X/Y modem relay upstream stage: receive and verify packets, hand them to the downstream stage
+ * @param  r : relay
+ * @retval upstream session over (normal or error)
+ * @note   Blocks until the session is over, run it and [xymodem_relay_downstream] in two contexts
+ */
+xym_sta_t xymodem_relay_upstream(xym_relay_t *r);
+
+/**
+ * @brief  X/Y modem relay downstream stage: transmit the verified packets
+ * @param  r : relay
+ * @retval XYM_END : all files are delivered, other : downstream session over by error / cancel
+ * @note   Blocks until the session is over, run it and [xymodem_relay_upstream] in two contexts.
+ *         A downstream failure cancels the upstream session, an upstream failure cancels the downstream session.
+ */
+xym_sta_t xymodem_relay_downstream(xym_relay_t *r);
+
+#endif /* __XYMODEM_RELAY_H__ */
@@ -0,0 +1,432 @@
+/**
+ *******************************************************************************************************************************************
+ * @file        xymodem_verify.c
+ * @brief       X / Y modem remote verification extension (digest of the stored image instead of a read-back transfer)
+ * @since       Change Logs:
+ * Date         Author       Notes
+ * 2026-10-18   lzh          the first version
+ * @copyright (c) 2023 lzh <lzhoran@163.com>
+ *                https://github.com/ZeHHHHH/Flexible-XYmodem.git
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *******************************************************************************************************************************************
+ */
+#include <string.h>
+#include "xymodem_verify.h"
+
+/*******************************************************************************************************************************************
+ * Private Prototype
+ *******************************************************************************************************************************************/
+#define SYN                     (0x16) /**< start of a verification message */
+#define VERIFY_REQ              (0x56) /**< (Host) 'V' == 0x56, verification request */
+#define VERIFY_REP              (0x76) /**< (Device) 'v' == 0x76, verification reply */
+
+#define VERIFY_STA_OK           (0)    /**< digest follows */
+#define VERIFY_STA_ALG          (1)    /**< algorithm not supported */
+#define VERIFY_STA_READ         (2)    /**< region not readable */
+
+#define VERIFY_REQ_SIZE         (15)   /**< [SYN] ['V'] [alg] [offset:4] [length:4] [CRC-32:4] */
+#define VERIFY_REP_HEAD_SIZE    (5)    /**< [SYN] ['v'] [alg] [status] [digest size] */
+#define VERIFY_SIZE_CRC32       (4)    /**< digest size of XYM_DIGEST_CRC32 / Bytes */
+#define VERIFY_SIZE_SHA256      (32)   /**< digest size of XYM_DIGEST_SHA256 / Bytes */
+#define VERIFY_SCAN_MAX         (64)   /**< bytes skipped before the start of a reply, then the request is sent again */
+
+/* CRC-32(IEEE 802.3, reflected 0xEDB88320), 4-bit table */
+static const uint32_t crc32_tab[16] =
+{
+    0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+    0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C,
+};
+
+#if XYM_VERIFY_SHA256
+static const uint32_t sha256_k[64] =
+{
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+/* SHA-256 compress one block */
+static void sha256_block(uint32_t *h, const uint8_t *blk);
+#endif
+
+/* CRC-32 continue(pre / post inversion by the caller) */
+static uint32_t crc32_update(uint32_t crc, const uint8_t *data, uint32_t cnt);
+/* big-endian store / load */
+static void put_be32(uint8_t *p, const uint32_t v);
+static uint32_t get_be32(const uint8_t *p);
+/* wait for [SYN][type], skip anything else */
+static xym_sta_t verify_sync(xym_session_t *p, const uint8_t type, const uint32_t tick, const uint32_t scan_max);
+
+/*******************************************************************************************************************************************
+ * Public Function
+ *******************************************************************************************************************************************/
+/**
+ * @brief  X/Y modem digest initialization
+ * @param  d   : digest context
+ * @param  alg : enum xym_digest_alg
+ * @retval XYM_OK : success, XYM_ERROR_INVALID_DATA : algorithm not supported
+ */
+xym_sta_t xymodem_digest_init(xym_digest_t *d, const xym_digest_alg_t alg)
+{
+#if XYM_VERIFY_SHA256
+    static const uint32_t sha256_h0[8] =
+    {
+        0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19,
+    };
+#endif
+    memset(d, 0, sizeof(xym_digest_t));
+    d->alg = (uint8_t)alg;
+    switch (alg)
+    {
+    case XYM_DIGEST_CRC32:
+        d->crc = 0xFFFFFFFF;
+        return XYM_OK;
+#if XYM_VERIFY_SHA256
+    case XYM_DIGEST_SHA256:
+        memcpy(d->h, sha256_h0, sizeof(d->h));
+        return XYM_OK;
+#endif
+    default:
+        d->alg = 0;
+        return XYM_ERROR_INVALID_DATA;
+    }
+}
+
+/**
+ * @brief  X/Y modem digest data, eg: each packet of valid data transmitted
+ * @param  d    : digest context
+ * @param  data : data
+ * @param  cnt  : data size / Bytes
+ * @retval \
+ */
+void xymodem_digest_update(xym_digest_t *d, const uint8_t *data, uint32_t cnt)
+{
+#if XYM_VERIFY_SHA256
+    uint32_t fill = 0, n = 0;
+#endif
+    if (d->alg == XYM_DIGEST_CRC32)
+    {
+        d->crc = crc32_update(d->crc, data, cnt);
+    }
+#if XYM_VERIFY_SHA256
+    else if (d->alg == XYM_DIGEST_SHA256)
+    {
+        fill = (uint32_t)(d->len & 63);
+        d->len += cnt;
+        while (cnt > 0)
+        {
+            n = (cnt < 64 - fill) ? cnt : 64 - fill;
+            if (fill == 0 && n == 64)
+            {
+                sha256_block(d->h, data); /* whole block in place */
+            }
+            else
+            {
+                memcpy(&d->blk[fill], data, n);
+                if (fill + n == 64)
+                {
+                    sha256_block(d->h, d->blk);
+                }
+            }
+            fill = (fill + n) & 63;
+            data += n;
+            cnt -= n;
+        }
+    }
+#endif
+}
+
+/**
+ * @brief  X/Y modem digest finish
+ * @param  d      : digest context
+ * @param  digest : returned digest (XYM_DIGEST_SIZE_MAX Bytes)
+ * @retval digest size / Bytes
+ */
+uint8_t xymodem_digest_final(xym_digest_t *d, uint8_t *digest)
+{
+#if XYM_VERIFY_SHA256
+    uint8_t pad[72] = {0x80};
+    uint32_t fill = 0, i = 0;
+    uint64_t bits = 0;
+#endif
+    if (d->alg == XYM_DIGEST_CRC32)
+    {
+        put_be32(digest, d->crc ^ 0xFFFFFFFF);
+        return 4;
+    }
+#if XYM_VERIFY_SHA256
+    if (d->alg == XYM_DIGEST_SHA256)
+    {
+        bits = d->len << 3;
+        fill = (uint32_t)(d->len & 63);
+        fill = (fill < 56) ? 56 - fill : 120 - fill; /* 0x80, zeros, then the 64-bit size */
+        for (i = 0; i < 8; ++i)
+        {
+            pad[fill + i] = (uint8_t)(bits >> (56 - 8 * i));
+        }
+        xymodem_digest_update(d, pad, fill + 8);
+        for (i = 0; i < 8; ++i)
+        {
+            put_be32(&digest[4 * i], d->h[i]);
+        }
+        return 32;
+    }
+#endif
+    return 0;
+}
+
+/**
+ * @brief  X/Y modem (host) verify a region stored by the device against the local digest
+ * @param  p      : session control struct, the session is over
+ * @param  alg    : enum xym_digest_alg
+ * @param  offset : offset of the region
+ * @param  length : size of the region / Bytes
+ * @param  digest : local digest of the region, by [xymodem_digest_final]
+ * @param  tick   : reply timeout / tick (time of the device to digest the region)
+ * @retval XYM_OK                 : match
+ * @retval XYM_ERROR_INVALID_DATA : mismatch
+ * @retval XYM_CANCEL_REMOTE      : the device refused (algorithm not supported / region not readable)
+ * @retval XYM_ERROR_RETRANS      : no valid reply, eg: the device has no verification extension
+ */
+xym_sta_t xymodem_verify_remote(xym_session_t *p, const xym_digest_alg_t alg, const uint32_t offset, const uint32_t length,
+                                const uint8_t *digest, const uint32_t tick)
+{
+    uint8_t req[VERIFY_REQ_SIZE];
+    uint8_t rep[VERIFY_REP_HEAD_SIZE + XYM_DIGEST_SIZE_MAX + 4];
+    uint8_t retry = 0;
+    xym_sta_t res = XYM_OK;
+
+    req[0] = SYN;
+    req[1] = VERIFY_REQ;
+    req[2] = (uint8_t)alg;
+    put_be32(&req[3], offset);
+    put_be32(&req[7], length);
+    put_be32(&req[11], crc32_update(0xFFFFFFFF, &req[1], 10) ^ 0xFFFFFFFF);
+    rep[0] = SYN;
+    rep[1] = VERIFY_REP;
+
+    for (retry = 0; retry <= p->param.error_max_retry; ++retry)
+    {
+        if (XYM_OK != (res = xymodem_link_send(p, req, sizeof(req), p->param.send_timeout)))
+        {
+            if (res == XYM_CANCEL_ACTIVE)
+            {
+                return res;
+            }
+            continue;
+        }
+        /* the device digests the region before the reply */
+        if (XYM_OK != (res = verify_sync(p, VERIFY_REP, tick, VERIFY_SCAN_MAX)))
+        {
+            if (res == XYM_CANCEL_ACTIVE)
+            {
+                return res;
+            }
+            continue;
+        }
+        if (XYM_OK != xymodem_link_recv(p, &rep[2], VERIFY_REP_HEAD_SIZE - 2, p->param.recv_timeout) ||
+            rep[4] > XYM_DIGEST_SIZE_MAX ||
+            XYM_OK != xymodem_link_recv(p, &rep[VERIFY_REP_HEAD_SIZE], rep[4] + 4u, p->param.recv_timeout) ||
+            get_be32(&rep[VERIFY_REP_HEAD_SIZE + rep[4]]) != (crc32_update(0xFFFFFFFF, &rep[1], VERIFY_REP_HEAD_SIZE - 1u + rep[4]) ^ 0xFFFFFFFF) ||
+            rep[2] != (uint8_t)alg)
+        {
+            continue;
+        }
+        if (rep[3] != VERIFY_STA_OK)
+        {
+            return XYM_CANCEL_REMOTE;
+        }
+        /* a digest of another size is not the digest of [alg], the prefix of a longer one must not match */
+        if (rep[4] != ((alg == XYM_DIGEST_SHA256) ? VERIFY_SIZE_SHA256 : VERIFY_SIZE_CRC32))
+        {
+            continue;
+        }
+        return (memcmp(&rep[VERIFY_REP_HEAD_SIZE], digest, rep[4]) == 0) ? XYM_OK : XYM_ERROR_INVALID_DATA;
+    }
+    return XYM_ERROR_RETRANS;
+}
+
+/**
+ * @brief  X/Y modem (device) serve one verification request
+ * @param  p    : session control struct, the session is over (its frame buffer is used to read the region)
+ * @param  read : read the stored region
+ * @param  user : user data of [read]
+ * @param  tick : wait for the request / tick
+ * @retval XYM_OK            : a request served
+ * @retval XYM_ERROR_TIMEOUT : no request
+ * @retval other             : link error
+ */
+xym_sta_t xymodem_verify_serve(xym_session_t *p, xym_verify_read_t read, void *user, const uint32_t tick)
+{
+    uint8_t req[VERIFY_REQ_SIZE];
+    uint8_t rep[VERIFY_REP_HEAD_SIZE + XYM_DIGEST_SIZE_MAX + 4];
+    uint8_t *buff = xymodem_frame_data(p);
+    uint32_t offset = 0, length = 0, n = 0;
+    xym_digest_t d;
+    xym_sta_t res = XYM_OK;
+
+    for (;;)
+    {
+        if (XYM_OK != (res = verify_sync(p, VERIFY_REQ, tick, 0)))
+        {
+            return res;
+        }
+        req[0] = SYN;
+        req[1] = VERIFY_REQ;
+        /* a corrupted request is dropped, the host sends it again */
+        if (XYM_OK == xymodem_link_recv(p, &req[2], VERIFY_REQ_SIZE - 2, p->param.recv_timeout) &&
+            get_be32(&req[11]) == (crc32_update(0xFFFFFFFF, &req[1], 10) ^ 0xFFFFFFFF))
+        {
+            break;
+        }
+    }
+    offset = get_be32(&req[3]);
+    length = get_be32(&req[7]);
+    rep[0] = SYN;
+    rep[1] = VERIFY_REP;
+    rep[2] = req[2];
+    rep[3] = VERIFY_STA_OK;
+    rep[4] = 0;
+    if (XYM_OK != xymodem_digest_init(&d, (xym_digest_alg_t)req[2]))
+    {
+        rep[3] = VERIFY_STA_ALG;
+    }
+    /* digest the stored region through the frame buffer */
+    while (rep[3] == VERIFY_STA_OK && length > 0)
+    {
+        n = (length < XYM_PKT_SIZE_1024) ? length : XYM_PKT_SIZE_1024;
+        if (XYM_OK != read(user, offset, buff, n))
+        {
+            rep[3] = VERIFY_STA_READ;
+            break;
+        }
+        xymodem_digest_update(&d, buff, n);
+        offset += n;
+        length -= n;
+    }
+    if (rep[3] == VERIFY_STA_OK)
+    {
+        rep[4] = xymodem_digest_final(&d, &rep[VERIFY_REP_HEAD_SIZE]);
+    }
+    put_be32(&rep[VERIFY_REP_HEAD_SIZE + rep[4]], crc32_update(0xFFFFFFFF, &rep[1], VERIFY_REP_HEAD_SIZE - 1u + rep[4]) ^ 0xFFFFFFFF);
+    return xymodem_link_send(p, rep, VERIFY_REP_HEAD_SIZE + rep[4] + 4u, p->param.send_timeout);
+}
+
+/*******************************************************************************************************************************************
+ * Private Function
+ *******************************************************************************************************************************************/
+/**
+ * @brief  CRC-32 continue(pre / post inversion by the caller)
+ * @param  crc  : CRC state
+ * @param  data : data
+ * @param  cnt  : data size / Bytes
+ * @retval CRC state
+ */
+static uint32_t crc32_update(uint32_t crc, const uint8_t *data, uint32_t cnt)
+{
+    while (cnt-- > 0)
+    {
+        crc ^= *data++;
+        crc = (crc >> 4) ^ crc32_tab[crc & 0x0F];
+        crc = (crc >> 4) ^ crc32_tab[crc & 0x0F];
+    }
+    return crc;
+}
+
+static void put_be32(uint8_t *p, const uint32_t v)
+{
+    p[0] = (uint8_t)(v >> 24);
+    p[1] = (uint8_t)(v >> 16);
+    p[2] = (uint8_t)(v >> 8);
+    p[3] = (uint8_t)v;
+}
+
+static uint32_t get_be32(const uint8_t *p)
+{
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | (uint32_t)p[3];
+}
+
+/**
+ * @brief  wait for [SYN][type], skip anything else
+ * @param  p        : session control struct
+ * @param  type     : VERIFY_REQ / VERIFY_REP
+ * @param  tick     : wait for each byte / tick
+ * @param  scan_max : max bytes skipped, 0: unlimited
+ * @retval XYM_OK : synchronized, other : timeout / link error / too many bytes skipped(XYM_ERROR_INVALID_DATA)
+ */
+static xym_sta_t verify_sync(xym_session_t *p, const uint8_t type, const uint32_t tick, const uint32_t scan_max)
+{
+    uint8_t c = 0, prev = 0;
+    uint32_t i = 0;
+    xym_sta_t res = XYM_OK;
+
+    for (i = 0; scan_max == 0 || i < scan_max; ++i)
+    {
+        if (XYM_OK != (res = xymodem_link_recv(p, &c, 1, tick)))
+        {
+            return res;
+        }
+        if (prev == SYN && c == type)
+        {
+            return XYM_OK;
+        }
+        prev = c;
+    }
+    return XYM_ERROR_INVALID_DATA;
+}
+
+#if XYM_VERIFY_SHA256
+#define ROR32(x, n)             (((x) >> (n)) | ((x) << (32 - (n))))
+
+/**
+ * @brief  SHA-256 compress one block
+ * @param  h   : state
+ * @param  blk : 64 Bytes block
+ * @retval \
+ */
+static void sha256_block(uint32_t *h, const uint8_t *blk)
+{
+    uint32_t w[64], s[8], t1 = 0, t2 = 0;
+    uint8_t i = 0;
+
+    for (i = 0; i < 16; ++i)
+    {
+        w[i] = get_be32(&blk[4 * i]);
+    }
+    for (i = 16; i < 64; ++i)
+    {
+        w[i] = w[i - 16] + w[i - 7] + (ROR32(w[i - 15], 7) ^ ROR32(w[i - 15], 18) ^ (w[i - 15] >> 3)) +
+               (ROR32(w[i - 2], 17) ^ ROR32(w[i - 2], 19) ^ (w[i - 2] >> 10));
+    }
+    memcpy(s, h, sizeof(s));
+    for (i = 0; i < 64; ++i)
+    {
+        t1 = s[7] + (ROR32(s[4], 6) ^ ROR32(s[4], 11) ^ ROR32(s[4], 25)) + ((s[4] & s[5]) ^ (~s[4] & s[6])) + sha256_k[i] + w[i];
+        t2 = (ROR32(s[0], 2) ^ ROR32(s[0], 13) ^ ROR32(s[0], 22)) + ((s[0] & s[1]) ^ (s[0] & s[2]) ^ (s[1] & s[2]));
+        memmove(&s[1], &s[0], 7 * sizeof(s[0]));
+        s[4] += t1;
+        s[0] = t1 + t2;
+    }
+    for (i = 0; i < 8; ++i)
+    {
+        h[i] += s[i];
+    }
+}
+#endif
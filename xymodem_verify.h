@@ -0,0 +1,126 @@
+/**
+ *******************************************************************************************************************************************
+ * @file        xymodem_verify.h
+ * @brief       X / Y modem remote verification extension (digest of the stored image instead of a read-back transfer)
+ * @since       Change Logs:
+ * Date         Author       Notes
+ * 2026-10-18   lzh          the first version
+ * @copyright (c) 2023 lzh <lzhoran@163.com>
+ *                https://github.com/ZeHHHHH/Flexible-XYmodem.git
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *******************************************************************************************************************************************
+ */
+#ifndef __XYMODEM_VERIFY_H__
+#define __XYMODEM_VERIFY_H__
+
+#include "xymodem.h"
+
+/** SHA-256 digest : 0-disable(CRC-32 only, saves ROM); 1-enable */
+#ifndef XYM_VERIFY_SHA256
+#define XYM_VERIFY_SHA256     (1)
+#endif
+
+#define XYM_DIGEST_SIZE_MAX   (32)   /**< max digest size / Bytes */
+
+/*
+ * Exchange after the session is over (all fields big-endian, CRC-32 over the bytes between SYN and itself):
+ *   request (host)   : [SYN] ['V'] [alg] [offset:4] [length:4] [CRC-32:4]
+ *   reply   (device) : [SYN] ['v'] [alg] [status] [digest size] [digest] [CRC-32:4]
+ */
+
+/** enum X/Y modem digest algorithm */
+typedef enum xym_digest_alg
+{
+    XYM_DIGEST_CRC32 = 1, /**< CRC-32(IEEE 802.3) */
+    XYM_DIGEST_SHA256     /**< SHA-256, XYM_VERIFY_SHA256 */
+} xym_digest_alg_t;
+
+/** X/Y modem digest context */
+typedef struct xym_digest
+{
+    uint8_t alg;          /**< enum xym_digest_alg */
+    uint32_t crc;         /**< CRC-32 state */
+#if XYM_VERIFY_SHA256
+    uint32_t h[8];        /**< SHA-256 state */
+    uint64_t len;         /**< SHA-256 message size / Bytes */
+    uint8_t blk[64];      /**< SHA-256 partial block */
+#endif
+} xym_digest_t;
+
+/**
+ * @brief  read the stored region of the device (eg: memcpy from memory-mapped flash)
+ * @param  user   : user data of [xymodem_verify_serve]
+ * @param  offset : offset of the stored region
+ * @param  data   : data
+ * @param  cnt    : data size / Bytes
+ * @retval XYM_OK : success, other : not readable (out of range)
+ */
+typedef xym_sta_t (*xym_verify_read_t)(void *user, const uint32_t offset, uint8_t *data, const uint32_t cnt);
+
+/**
+ * @brief  X/Y modem digest initialization
+ * @param  d   : digest context
+ * @param  alg : enum xym_digest_alg
+ * @retval XYM_OK : success, XYM_ERROR_INVALID_DATA : algorithm not supported
+ */
+xym_sta_t xymodem_digest_init(xym_digest_t *d, const xym_digest_alg_t alg);
+
+/**
+ * @brief  X/Y modem digest data, eg: each packet of valid data transmitted
+ * @param  d    : digest context
+ * @param  data : data
+ * @param  cnt  : data size / Bytes
+ * @retval \
+ */
+void xymodem_digest_update(xym_digest_t *d, const uint8_t *data, uint32_t cnt);
+
+/**
+ * @brief  X/Y modem digest finish
+ * @param  d      : digest context
+ * @param  digest : returned digest (XYM_DIGEST_SIZE_MAX Bytes)
+ * @retval digest size / Bytes
+ */
+uint8_t xymodem_digest_final(xym_digest_t *d, uint8_t *digest);
+
+/**
+ * @brief  X/Y modem (host) verify a region stored by the device against the local digest
+ * @param  p      : session control struct, the session is over
+ * @param  alg    : enum xym_digest_alg
+ * @param  offset : offset of the region
+ * @param  length : size of the region / Bytes
+ * @param  digest : local digest of the region, by [xymodem_digest_final]
+ * @param  tick   : reply timeout / tick (time of the device to digest the region)
+ * @retval XYM_OK                 : match
+ * @retval XYM_ERROR_INVALID_DATA : mismatch
+ * @retval XYM_CANCEL_REMOTE      : the device refused (algorithm not supported / region not readable)
+ * @retval XYM_ERROR_RETRANS      : no valid reply, eg: the device has no verification extension
+ */
+xym_sta_t xymodem_verify_remote(xym_session_t *p, const xym_digest_alg_t alg, const uint32_t offset, const uint32_t length,
+                                const uint8_t *digest, const uint32_t tick);
+
+/**
+ * @brief  X/Y modem (device) serve one verification request
+ * @param  p    : session control struct, the session is over (its frame buffer is used to read the region)
+ * @param  read : read the stored region
+ * @param  user : user data of [read]
+ * @param  tick : wait for the request / tick
+ * @retval XYM_OK            : a request served
+ * @retval XYM_ERROR_TIMEOUT : no request
+ * @retval other             : link error
+ * @note   Call it after the session until it returns XYM_ERROR_TIMEOUT, the host may verify several regions.
+ */
+xym_sta_t xymodem_verify_serve(xym_session_t *p, xym_verify_read_t read, void *user, const uint32_t tick);
+
+#endif /* __XYMODEM_VERIFY_H__ */